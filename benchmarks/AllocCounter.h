@@ -0,0 +1,50 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+// Replaces the global operator new/delete with counting versions.
+// Include from exactly one translation unit per benchmark executable.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+
+inline std::atomic<size_t>& allocationCounter() {
+    static std::atomic<size_t> count(0);
+    return count;
+}
+
+inline size_t allocationCount() {
+    return allocationCounter().load(std::memory_order_relaxed);
+}
+
+} // namespace bench
+
+void* operator new(size_t size) {
+    bench::allocationCounter().fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // ALLOC_COUNTER_H
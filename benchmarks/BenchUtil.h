@@ -0,0 +1,88 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Small helpers shared by the benchmark executables.
+// Kept header-only and dependency-free on purpose: the benchmarks should
+// build anywhere the CLI builds.
+namespace bench {
+
+class Stopwatch {
+private:
+    std::chrono::steady_clock::time_point start;
+
+public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+    void reset() { start = std::chrono::steady_clock::now(); }
+
+    double elapsedNs() const {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double elapsedMs() const { return elapsedNs() / 1e6; }
+};
+
+// ContactManager reports every operation on stdout; benchmarks silence it.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+class SilenceStdout {
+private:
+    NullBuffer nullBuffer;
+    std::streambuf* saved;
+
+public:
+    SilenceStdout() : saved(std::cout.rdbuf(&nullBuffer)) {}
+    ~SilenceStdout() { std::cout.rdbuf(saved); }
+};
+
+// Prevents the optimizer from discarding a computed value.
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Sizes come from argv when given ("bench 1000 1000000"), defaults otherwise.
+inline std::vector<size_t> parseSizes(int argc, char** argv, const std::vector<size_t>& defaults) {
+    if (argc <= 1) {
+        return defaults;
+    }
+
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; i++) {
+        sizes.push_back(static_cast<size_t>(std::strtoull(argv[i], nullptr, 10)));
+    }
+    return sizes;
+}
+
+// Deterministic random indexes for lookup loops.
+inline std::vector<size_t> randomIndexes(size_t count, size_t bound, unsigned seed = 42) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> dist(0, bound - 1);
+    std::vector<size_t> result(count);
+    for (size_t& index : result) {
+        index = dist(rng);
+    }
+    return result;
+}
+
+} // namespace bench
+
+#endif // BENCH_UTIL_H
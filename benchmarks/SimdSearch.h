@@ -0,0 +1,238 @@
+#ifndef SIMD_SEARCH_H
+#define SIMD_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_SEARCH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// The AVX2 kernel is compiled with a target attribute and chosen at run
+// time, so the build needs no -mavx2
+#if defined(SIMD_SEARCH_SSE2) && defined(__x86_64__)
+#define SIMD_SEARCH_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Case-insensitive substring search over text that has no folded key.
+// Measured against the folded-key search in bench_substring_search; the
+// library searches the keys TextSearch::foldKey writes with each value, so
+// this kernel is kept with the benchmarks, not in contact_core.
+//
+// The text is folded to lowercase as it is read (ASCII letters only), so no
+// lowercase copy is made; the pattern must already be lowercase. The kernel
+// compares the first and last pattern bytes against 16 (SSE2) or 32 (AVX2)
+// folded text positions at once and only verifies the positions where both
+// match. AVX2 is picked at run time when the CPU has it; other targets use
+// the byte loop.
+namespace bench {
+namespace simd_search {
+
+// Texts shorter than one block plus the pattern are copied into a padded
+// buffer so a single SSE2 block covers them (names and e-mails mostly are)
+const size_t SHORT_TEXT = 64;
+
+inline unsigned char foldByte(char c) {
+    unsigned char byte = static_cast<unsigned char>(c);
+    return static_cast<unsigned>(byte - 'A') < 26u ? byte | 0x20 : byte;
+}
+
+// First and last bytes already matched
+inline bool matchesAt(const char* at, std::string_view lowerPattern) {
+    for (size_t i = 1; i + 1 < lowerPattern.size(); i++) {
+        if (foldByte(at[i]) != static_cast<unsigned char>(lowerPattern[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Byte-at-a-time version, same results on every target
+inline size_t findScalar(std::string_view text, std::string_view lowerPattern) {
+    unsigned char first = static_cast<unsigned char>(lowerPattern[0]);
+    unsigned char last = static_cast<unsigned char>(lowerPattern.back());
+    size_t end = text.size() - lowerPattern.size();
+    for (size_t pos = 0; pos <= end; pos++) {
+        if (foldByte(text[pos]) == first && foldByte(text[pos + lowerPattern.size() - 1]) == last &&
+            matchesAt(text.data() + pos, lowerPattern)) {
+            return pos;
+        }
+    }
+    return std::string_view::npos;
+}
+
+#if defined(SIMD_SEARCH_SSE2)
+
+// Verifies the candidate starts in mask (bit k = position base + k)
+inline size_t firstMatch(uint32_t mask, const char* text, size_t base, std::string_view lowerPattern) {
+    while (mask != 0) {
+        size_t pos = base + static_cast<size_t>(__builtin_ctz(mask));
+        if (matchesAt(text + pos, lowerPattern)) {
+            return pos;
+        }
+        mask &= mask - 1;
+    }
+    return std::string_view::npos;
+}
+
+// 'A'..'Z' land on the 26 lowest signed byte values after adding 0x3F
+inline __m128i fold16(__m128i bytes) {
+    __m128i shifted = _mm_add_epi8(bytes, _mm_set1_epi8(0x3F));
+    __m128i upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8(-128 + 26));
+    return _mm_or_si128(bytes, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+// Bit k set when position k can start a match: reads at[0, 16) and at[m - 1, m + 15)
+inline uint32_t candidates16(const char* at, size_t m, __m128i first, __m128i last) {
+    __m128i head = fold16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(at)));
+    __m128i tail = fold16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(at + m - 1)));
+    __m128i both = _mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last));
+    return static_cast<uint32_t>(_mm_movemask_epi8(both));
+}
+
+inline size_t findSse2(std::string_view text, std::string_view lowerPattern) {
+    const size_t BLOCK = 16;
+    size_t m = lowerPattern.size();
+    size_t starts = text.size() - m + 1;
+    __m128i first = _mm_set1_epi8(lowerPattern[0]);
+    __m128i last = _mm_set1_epi8(lowerPattern[m - 1]);
+
+    if (starts < BLOCK) {
+        if (text.size() > SHORT_TEXT) {
+            return findScalar(text, lowerPattern);
+        }
+        char padded[SHORT_TEXT + BLOCK] = {};
+        std::memcpy(padded, text.data(), text.size());
+        uint32_t mask = candidates16(padded, m, first, last) & ((1u << starts) - 1);
+        return firstMatch(mask, text.data(), 0, lowerPattern);
+    }
+
+    size_t i = 0;
+    for (; i + BLOCK <= starts; i += BLOCK) {
+        size_t pos = firstMatch(candidates16(text.data() + i, m, first, last), text.data(), i, lowerPattern);
+        if (pos != std::string_view::npos) {
+            return pos;
+        }
+    }
+    if (i == starts) {
+        return std::string_view::npos;
+    }
+
+    // Last partial block: step back to a full block, drop the starts already tried
+    size_t base = starts - BLOCK;
+    uint32_t mask = candidates16(text.data() + base, m, first, last) & (~0u << (i - base));
+    return firstMatch(mask, text.data(), base, lowerPattern);
+}
+
+#endif
+
+#if defined(SIMD_SEARCH_AVX2)
+
+__attribute__((target("avx2"))) inline __m256i fold32(__m256i bytes) {
+    __m256i shifted = _mm256_add_epi8(bytes, _mm256_set1_epi8(0x3F));
+    __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), shifted);
+    return _mm256_or_si256(bytes, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2"))) inline uint32_t candidates32(const char* at, size_t m, __m256i first,
+                                                             __m256i last) {
+    __m256i head = fold32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(at)));
+    __m256i tail = fold32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(at + m - 1)));
+    __m256i both = _mm256_and_si256(_mm256_cmpeq_epi8(head, first), _mm256_cmpeq_epi8(tail, last));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(both));
+}
+
+__attribute__((target("avx2"))) inline size_t findAvx2(std::string_view text, std::string_view lowerPattern) {
+    const size_t BLOCK = 32;
+    size_t m = lowerPattern.size();
+    size_t starts = text.size() - m + 1;
+    if (starts < BLOCK) {
+        return findSse2(text, lowerPattern);
+    }
+
+    __m256i first = _mm256_set1_epi8(lowerPattern[0]);
+    __m256i last = _mm256_set1_epi8(lowerPattern[m - 1]);
+    size_t i = 0;
+    for (; i + BLOCK <= starts; i += BLOCK) {
+        size_t pos = firstMatch(candidates32(text.data() + i, m, first, last), text.data(), i, lowerPattern);
+        if (pos != std::string_view::npos) {
+            return pos;
+        }
+    }
+    if (i == starts) {
+        return std::string_view::npos;
+    }
+
+    size_t base = starts - BLOCK;
+    uint32_t mask = candidates32(text.data() + base, m, first, last) & (~0u << (i - base));
+    return firstMatch(mask, text.data(), base, lowerPattern);
+}
+
+#endif
+
+typedef size_t (*FindFn)(std::string_view, std::string_view);
+
+inline FindFn chooseKernel() {
+#if defined(SIMD_SEARCH_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return findAvx2;
+    }
+#endif
+#if defined(SIMD_SEARCH_SSE2)
+    return findSse2;
+#else
+    return findScalar;
+#endif
+}
+
+// Chosen on first use (thread-safe static), not during static initialization
+inline FindFn kernel() {
+    static const FindFn chosen = chooseKernel();
+    return chosen;
+}
+
+} // namespace simd_search
+
+// Position of the first match, or string_view::npos
+inline size_t findIgnoreCase(std::string_view text, std::string_view lowerPattern) {
+    if (lowerPattern.empty()) {
+        return 0;
+    }
+    if (lowerPattern.size() > text.size()) {
+        return std::string_view::npos;
+    }
+    return simd_search::kernel()(text, lowerPattern);
+}
+
+inline size_t findIgnoreCaseScalar(std::string_view text, std::string_view lowerPattern) {
+    if (lowerPattern.empty()) {
+        return 0;
+    }
+    if (lowerPattern.size() > text.size()) {
+        return std::string_view::npos;
+    }
+    return simd_search::findScalar(text, lowerPattern);
+}
+
+// "avx2", "sse2" or "scalar"
+inline const char* findKernelName() {
+#if defined(SIMD_SEARCH_AVX2)
+    if (simd_search::kernel() == simd_search::findAvx2) {
+        return "avx2";
+    }
+#endif
+#if defined(SIMD_SEARCH_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,155 @@
+// Throughput of the batch command mode (SmartContactCLI --batch).
+//
+// A command script is generated in memory and fed to BatchCommandRunner,
+// the same path the CLI takes for stdin or a command file. Output goes to
+// a string stream, so the numbers cover parsing, the ContactManager call,
+// discarding its messages and formatting the result line, but not the
+// terminal or pipe on the other end. Scripts:
+//   add        n x add
+//   fill       n x (add, set-phone, set-email), then n x get by ID
+//   mixed      on the filled book: get by name, set-phone, search phone,
+//              search email, remove + add again (one in 16 each)
+// The mixed rate is bound by ContactManager itself: removeContact and
+// setContactPhone rewrite trigram posting lists shared by many contacts.
+//
+// Usage: bench_batch_commands [contacts ...]   (default 100k)
+
+#include "BenchUtil.h"
+#include "BatchCommandRunner.h"
+#include "ContactManager.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const FAMILY[] = {"Nguyễn", "Trần", "Lê", "Phạm", "Hoàng", "Phan", "Vũ", "Đặng", "Bùi", "Đỗ"};
+const char* const MIDDLE[] = {"Văn", "Thị", "Minh", "Ngọc", "Đức", "Thanh", "Quốc", "Hồng"};
+
+string nameOf(size_t i) {
+    return string(FAMILY[i % 10]) + " " + MIDDLE[i / 10 % 8] + " " + to_string(i);
+}
+
+string phoneOf(size_t i) {
+    return "09" + to_string(10000000 + i);
+}
+
+string emailOf(size_t i) {
+    return "contact" + to_string(i) + "@example.vn";
+}
+
+struct Script {
+    string text;
+    size_t commands = 0;
+
+    void add(const string& line) {
+        text += line;
+        text += '\n';
+        commands++;
+    }
+};
+
+Script addScript(size_t n) {
+    Script script;
+    for (size_t i = 0; i < n; i++) {
+        script.add("add " + nameOf(i));
+    }
+    return script;
+}
+
+// IDs of the contacts added by the fill script start at firstId, in order
+Script fillScript(size_t n, int firstId) {
+    Script script;
+    for (size_t i = 0; i < n; i++) {
+        script.add("add " + nameOf(i));
+        script.add("set-phone " + to_string(firstId + i) + " " + phoneOf(i));
+        script.add("set-email " + to_string(firstId + i) + " " + emailOf(i));
+    }
+    for (size_t i = 0; i < n; i++) {
+        script.add("get " + to_string(firstId + i));
+    }
+    return script;
+}
+
+Script mixedScript(size_t n) {
+    Script script;
+    vector<size_t> picks = bench::randomIndexes(n, n, 7);
+    for (size_t i = 0; i < picks.size(); i++) {
+        size_t pick = picks[i];
+        switch (i % 16) {
+            case 0:
+                script.add("remove " + nameOf(pick));
+                script.add("add " + nameOf(pick));
+                break;
+            case 1:
+                script.add("search phone " + phoneOf(pick));
+                break;
+            case 2:
+                script.add("search email " + emailOf(pick));
+                break;
+            case 3:
+                script.add("set-phone " + nameOf(pick) + " 08" + to_string(10000000 + i));
+                break;
+            default:
+                script.add("get " + nameOf(pick));
+        }
+    }
+    return script;
+}
+
+struct Result {
+    double commandsPerSecond;
+    size_t failures;
+    size_t outputBytes;
+};
+
+Result measure(ContactManager* manager, const Script& script) {
+    istringstream in(script.text);
+    ostringstream out;
+    BatchCommandRunner runner(manager);
+    bench::Stopwatch timer;
+    BatchCommandRunner::Summary summary = runner.run(in, out);
+    double seconds = timer.elapsedNs() / 1e9;
+    return Result{summary.commands / seconds, summary.failures, out.str().size()};
+}
+
+void report(const char* label, const Script& script, const Result& r) {
+    printf("  %-8s %10zu %14.0f %10zu %12zu\n", label, script.commands, r.commandsPerSecond, r.failures,
+           r.outputBytes);
+}
+
+void run(size_t n) {
+    ContactManager* manager = ContactManager::getInstance();
+    printf("\n%zu contacts\n", n);
+    printf("  %-8s %10s %14s %10s %12s\n", "script", "commands", "commands/s", "errors", "output B");
+
+    Script adds = addScript(n);
+    report("add", adds, measure(manager, adds));
+    {
+        bench::SilenceStdout quiet;
+        manager->clearAll();
+    }
+
+    Script fill = fillScript(n, Contact::getNextId());
+    report("fill", fill, measure(manager, fill));
+
+    Script mixed = mixedScript(n);
+    report("mixed", mixed, measure(manager, mixed));
+
+    bench::SilenceStdout quiet;
+    manager->clearAll();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {100000});
+    for (size_t n : sizes) {
+        run(n);
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+// BTree vs RedBlackTree vs BinarySearchTree as a string index.
+//
+// For each size and key kind this reports, per structure:
+//   insert   ns per insert of n shuffled keys into an empty index
+//   find     ns per random lookup (every lookup hits)
+//   scan     ns per key for a full in-order iteration
+//   bytes    heap bytes per key, keys and nodes included (glibc in-use
+//            bytes; keys longer than the small-string buffer add a block)
+//
+// Keys are phone numbers (10 digits, stored inline in std::string) and
+// e-mail addresses (heap-allocated key bytes), the two indexes the BTree
+// is meant for. BTree is run at several orders (keys per node).
+//
+// Usage: bench_btree [size ...]   (default 10k 100k 1M; 10M fits in ~4 GB)
+
+#include "BenchUtil.h"
+#include "BTree.h"
+#include "BinarySearchTree.h"
+#include "RedBlackTree.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+struct Contact;
+
+string phoneKey(size_t i) {
+    return "09" + to_string(10000000 + i * 7919 % 90000000);
+}
+
+string emailKey(size_t i) {
+    return "contact" + to_string(i * 7919 % 100000007) + "@example.vn";
+}
+
+long long heapInUse() {
+#if defined(__GLIBC__)
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<long long>(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+template<typename Tree>
+void measure(const char* label, const vector<string>& keys, const vector<size_t>& lookups) {
+    size_t n = keys.size();
+    long long before = heapInUse();
+    Tree* tree = new Tree();
+
+    bench::Stopwatch timer;
+    for (size_t i = 0; i < n; i++) {
+        tree->insert(keys[i], reinterpret_cast<Contact*>(i + 1));
+    }
+    double insertNs = timer.elapsedNs() / n;
+    double bytes = double(heapInUse() - before) / n;
+
+    size_t found = 0;
+    timer.reset();
+    for (size_t i : lookups) {
+        found += tree->find(keys[i]) != nullptr;
+    }
+    double findNs = timer.elapsedNs() / lookups.size();
+
+    size_t total = 0;
+    timer.reset();
+    for (const auto& entry : *tree) {
+        total += entry.first.size();
+    }
+    double scanNs = timer.elapsedNs() / n;
+    bench::doNotOptimize(total);
+
+    printf("  %-22s %10.0f %10.0f %10.1f %10.1f%s\n", label, insertNs, findNs, scanNs, bytes,
+           found == lookups.size() ? "" : "  (lookup missed!)");
+    delete tree;
+}
+
+void run(const char* kind, string (*keyOf)(size_t), size_t n) {
+    vector<string> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        keys.push_back(keyOf(i));
+    }
+    shuffle(keys.begin(), keys.end(), mt19937_64(3));
+    vector<size_t> lookups = bench::randomIndexes(1000000, n);
+
+    printf("\n%zu %s keys\n", n, kind);
+    printf("  %-22s %10s %10s %10s %10s\n", "index", "insert ns", "find ns", "scan ns", "bytes/key");
+    measure<BinarySearchTree<string, Contact*>>("BinarySearchTree", keys, lookups);
+    measure<RedBlackTree<string, Contact*>>("RedBlackTree", keys, lookups);
+    measure<BTree<string, Contact*, 8>>("BTree<8>", keys, lookups);
+    measure<BTree<string, Contact*, 16>>("BTree<16>", keys, lookups);
+    measure<BTree<string, Contact*>>("BTree (default, 32)", keys, lookups);
+    measure<BTree<string, Contact*, 64>>("BTree<64>", keys, lookups);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {10000, 100000, 1000000});
+    printf("BTree default order for string keys: %zu\n", BTreeDefaultOrder<string>::value);
+    for (size_t n : sizes) {
+        run("phone", phoneKey, n);
+        run("e-mail", emailKey, n);
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+// Import time: bulkImport (sort once + buildFromSorted) vs one contact at a time.
+//
+// The incremental path is what an importer had to do before: addContact,
+// then setContactPhone / setContactEmail / setContactAddress, each walking
+// root-to-leaf in every index (plus insertFixup rotations in the RB trees).
+// bulkImport sorts each index's keys once and bulk-builds every tree in
+// O(n); the ID table and trigram posting lists are filled in ID order.
+//
+// Both paths also pay per-record costs that bulk loading does not change
+// (email validation, trigram postings, string copies), so a second table
+// isolates the tree build itself: n shuffled keys inserted one by one vs
+// one sort + buildFromSorted.
+//
+// Input is shuffled so neither path sees pre-sorted keys.
+// Usage: bench_bulk_import [size ...]   (default 100k 1M; 10M needs ~8 GB)
+
+#include "BenchUtil.h"
+#include "BinarySearchTree.h"
+#include "ContactManager.h"
+#include "RedBlackTree.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const FAMILY_NAMES[] = {"Nguyen", "Tran", "Le", "Pham", "Hoang", "Phan", "Vu", "Dang", "Bui", "Do"};
+const char* const MIDDLE_NAMES[] = {"Van", "Thi", "Minh", "Duc", "Ngoc", "Thanh", "Quoc", "Hai"};
+const char* const PHONE_PREFIXES[] = {"090", "091", "098", "036", "077", "085"};
+
+vector<ContactRecord> makeRecords(size_t n) {
+    vector<ContactRecord> records(n);
+    for (size_t i = 0; i < n; i++) {
+        records[i].name = string(FAMILY_NAMES[i % 10]) + " " + MIDDLE_NAMES[(i / 10) % 8] + " " + to_string(i);
+        records[i].phoneNumber = string(PHONE_PREFIXES[i % 6]) + to_string(10000000 + i);
+        records[i].email = "user" + to_string(i) + "@example.vn";
+        records[i].address = to_string(i % 500) + " Le Loi, Quan 1";
+    }
+    shuffle(records.begin(), records.end(), mt19937_64(42));
+    return records;
+}
+
+void importIncrementally(ContactManager* manager, const vector<ContactRecord>& records) {
+    for (const ContactRecord& record : records) {
+        manager->addContact(record.name);
+        Contact* contact = manager->findContact(record.name);
+        manager->setContactPhone(contact, record.phoneNumber);
+        manager->setContactEmail(contact, record.email);
+        manager->setContactAddress(contact, record.address);
+    }
+}
+
+template<typename Tree>
+void compareTreeBuild(const char* label, const vector<ContactRecord>& records) {
+    vector<pair<string, Contact*>> entries;
+    entries.reserve(records.size());
+    for (const ContactRecord& record : records) {
+        entries.emplace_back(record.name, nullptr);
+    }
+
+    double insertMs, buildMs;
+    {
+        Tree tree;
+        bench::Stopwatch timer;
+        for (const auto& entry : entries) {
+            tree.insert(entry.first, entry.second);
+        }
+        insertMs = timer.elapsedMs();
+    }
+    {
+        Tree tree;
+        bench::Stopwatch timer;
+        vector<pair<string, Contact*>> sorted = entries;
+        sort(sorted.begin(), sorted.end());
+        tree.buildFromSorted(sorted.begin(), sorted.end());
+        buildMs = timer.elapsedMs();
+        bench::doNotOptimize(tree.size());
+    }
+    printf("%10zu %-16s %14.1f %14.1f %9.1fx\n", records.size(), label, insertMs, buildMs, insertMs / buildMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {100000, 1000000});
+    ContactManager* manager = ContactManager::getInstance();
+
+    printf("%10s %16s %14s %10s\n", "records", "incremental ms", "bulk ms", "speedup");
+    for (size_t n : sizes) {
+        vector<ContactRecord> records = makeRecords(n);
+        double incrementalMs, bulkMs;
+        size_t imported;
+        {
+            bench::SilenceStdout quiet;
+            manager->clearAll();
+            bench::Stopwatch timer;
+            importIncrementally(manager, records);
+            incrementalMs = timer.elapsedMs();
+
+            manager->clearAll();
+            timer.reset();
+            imported = manager->bulkImport(records);
+            bulkMs = timer.elapsedMs();
+        }
+
+        if (imported != n || static_cast<size_t>(manager->getTotalContacts()) != n) {
+            fprintf(stderr, "bulk import kept %zu of %zu records\n", imported, n);
+            return 1;
+        }
+        printf("%10zu %16.1f %14.1f %9.1fx\n", n, incrementalMs, bulkMs, incrementalMs / bulkMs);
+    }
+
+    {
+        bench::SilenceStdout quiet;
+        manager->clearAll();
+    }
+
+    printf("\n%10s %-16s %14s %14s %10s\n", "keys", "tree", "insert ms", "sort+build ms", "speedup");
+    for (size_t n : sizes) {
+        vector<ContactRecord> records = makeRecords(n);
+        compareTreeBuild<BinarySearchTree<string, Contact*>>("BinarySearchTree", records);
+        compareTreeBuild<RedBlackTree<string, Contact*>>("RedBlackTree", records);
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+// Read throughput of ConcurrentContactManager as reader threads are added.
+//
+// Every reader runs the same mix against one shared manager:
+//   lookups    findContact(id) + isPhoneNumberDuplicate + isEmailDuplicate
+//   searches   searchByName (trigram path) + searchByNamePrefix (limit 10)
+// Each mix runs once with readers only and once next to a writer thread
+// that keeps changing notes and phone numbers through the manager (write
+// lock, every index touched by a phone change). Throughput counts reader
+// operations over the wall time of the whole run; "speedup" is relative to
+// one reader and cannot exceed the core count printed at the top.
+// The first row is the unlocked ContactManager on one thread: the price of
+// taking the read lock itself.
+//
+// Usage: bench_concurrent_reads [contacts ...]   (default 1M)
+
+#include "BenchUtil.h"
+#include "ContactManager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const FAMILY[] = {"Nguyễn", "Trần", "Lê", "Phạm", "Hoàng", "Phan", "Vũ", "Đặng", "Bùi", "Đỗ"};
+const char* const MIDDLE[] = {"Văn", "Thị", "Minh", "Ngọc", "Đức", "Thanh", "Quốc", "Hồng"};
+
+const size_t LOOKUPS_PER_THREAD = 300000;
+const size_t SEARCHES_PER_THREAD = 20000;
+
+string nameOf(size_t i) {
+    return string(FAMILY[i % 10]) + " " + MIDDLE[i / 10 % 8] + " " + to_string(i);
+}
+
+string phoneOf(size_t i) {
+    return "09" + to_string(10000000 + i);
+}
+
+string emailOf(size_t i) {
+    return "contact" + to_string(i) + "@example.vn";
+}
+
+vector<ContactRecord> makeRecords(size_t n) {
+    vector<ContactRecord> records(n);
+    for (size_t i = 0; i < n; i++) {
+        records[i].name = nameOf(i);
+        records[i].phoneNumber = phoneOf(i);
+        records[i].email = emailOf(i);
+    }
+    return records;
+}
+
+// Per-thread query lists, generated before the clock starts
+struct Queries {
+    vector<int> ids;
+    vector<string> phones;   // half present, half not
+    vector<string> emails;
+    vector<string> names;    // "van 123": folded middle name + a number, trigram path
+    vector<string> prefixes; // "nguyen van 12"
+};
+
+Queries makeQueries(size_t n, int firstId, unsigned seed) {
+    Queries q;
+    vector<size_t> picks = bench::randomIndexes(LOOKUPS_PER_THREAD, n, seed);
+    for (size_t i = 0; i < picks.size(); i++) {
+        q.ids.push_back(firstId + static_cast<int>(picks[i]));
+        q.phones.push_back(phoneOf(i % 2 == 0 ? picks[i] : n + picks[i]));
+        q.emails.push_back(emailOf(i % 2 == 0 ? picks[i] : n + picks[i]));
+    }
+    for (size_t i = 0; i < SEARCHES_PER_THREAD; i++) {
+        size_t pick = picks[i];
+        string name = nameOf(pick);
+        q.names.push_back(ContactManager::normalizeName(MIDDLE[pick / 10 % 8]) + " " + to_string(pick));
+        q.prefixes.push_back(ContactManager::normalizeName(name.substr(0, name.size() - 1)));
+    }
+    return q;
+}
+
+template<typename Manager>
+size_t runLookups(Manager* manager, const Queries& q) {
+    size_t hits = 0;
+    for (size_t i = 0; i < q.ids.size(); i++) {
+        hits += manager->findContact(q.ids[i]) != nullptr;
+        hits += manager->isPhoneNumberDuplicate(q.phones[i]);
+        hits += manager->isEmailDuplicate(q.emails[i]);
+    }
+    return hits;
+}
+
+template<typename Manager>
+size_t runSearches(Manager* manager, const Queries& q) {
+    size_t hits = 0;
+    for (size_t i = 0; i < q.names.size(); i++) {
+        hits += manager->searchByName(q.names[i]).size();
+        hits += manager->searchByNamePrefix(q.prefixes[i], true, 10).size();
+    }
+    return hits;
+}
+
+// Changes notes and phone numbers of random contacts until stop is set
+size_t runWriter(ConcurrentContactManager* manager, size_t n, int firstId, const atomic<bool>& stop) {
+    vector<size_t> picks = bench::randomIndexes(1 << 16, n, 99);
+    size_t writes = 0;
+    for (size_t i = 0; !stop.load(memory_order_relaxed); i++) {
+        Contact* contact = manager->findContact(firstId + static_cast<int>(picks[i % picks.size()]));
+        if (i % 2 == 0) {
+            manager->setContactNotes(contact, "ghi chú " + to_string(i));
+        } else {
+            manager->setContactPhone(contact, "08" + to_string(10000000 + i % 90000000));
+        }
+        writes++;
+    }
+    return writes;
+}
+
+struct Result {
+    double opsPerSecond;
+    double writesPerSecond;
+};
+
+// ops = manager calls per query list entry (3 for lookups, 2 for searches)
+Result measure(ConcurrentContactManager* manager, size_t n, int firstId, size_t threads, bool withWriter,
+               bool searches, const vector<Queries>& queries) {
+    atomic<bool> go(false);
+    atomic<bool> stop(false);
+    atomic<size_t> hits(0);
+    vector<thread> readers;
+    for (size_t t = 0; t < threads; t++) {
+        readers.emplace_back([&, t] {
+            while (!go.load()) {
+                this_thread::yield();
+            }
+            hits += searches ? runSearches(manager, queries[t]) : runLookups(manager, queries[t]);
+        });
+    }
+
+    size_t writes = 0;
+    thread writer;
+    if (withWriter) {
+        writer = thread([&] { writes = runWriter(manager, n, firstId, stop); });
+    }
+
+    bench::Stopwatch timer;
+    go = true;
+    for (thread& reader : readers) {
+        reader.join();
+    }
+    double seconds = timer.elapsedNs() / 1e9;
+    stop = true;
+    if (writer.joinable()) {
+        writer.join();
+    }
+    bench::doNotOptimize(hits.load());
+
+    size_t perThread = searches ? 2 * SEARCHES_PER_THREAD : 3 * LOOKUPS_PER_THREAD;
+    return Result{double(perThread * threads) / seconds, writes / seconds};
+}
+
+vector<size_t> threadCounts() {
+    size_t cores = max(1u, thread::hardware_concurrency());
+    vector<size_t> counts;
+    for (size_t t = 1; t < cores; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(cores);
+    if (counts.size() == 1) {
+        counts.push_back(2);  // One core: still show two readers sharing the lock
+    }
+    return counts;
+}
+
+void run(size_t n) {
+    vector<ContactRecord> records = makeRecords(n);
+    vector<size_t> counts = threadCounts();
+    vector<Queries> queries;
+
+    printf("\n%zu contacts, %u cores, %zu lookups or %zu searches per reader\n", n, thread::hardware_concurrency(),
+           LOOKUPS_PER_THREAD, SEARCHES_PER_THREAD);
+    printf("  %-24s %8s %14s %8s %12s\n", "manager", "readers", "reads/s", "speedup", "writes/s");
+
+    // Unlocked baseline, one thread
+    ContactManager* plain = ContactManager::getInstance();
+    double lookups;
+    double searches;
+    {
+        bench::SilenceStdout quiet;
+        int firstId = Contact::getNextId();
+        plain->bulkImport(records);
+        Queries q = makeQueries(n, firstId, 1);
+        bench::Stopwatch timer;
+        size_t hits = runLookups(plain, q);
+        lookups = 3.0 * LOOKUPS_PER_THREAD / (timer.elapsedNs() / 1e9);
+        timer.reset();
+        hits += runSearches(plain, q);
+        searches = 2.0 * SEARCHES_PER_THREAD / (timer.elapsedNs() / 1e9);
+        bench::doNotOptimize(hits);
+        plain->clearAll();
+    }
+    printf("  %-24s %8d %14.0f %8s %12s  lookups\n", "ContactManager (no lock)", 1, lookups, "", "");
+    printf("  %-24s %8d %14.0f %8s %12s  searches\n", "ContactManager (no lock)", 1, searches, "", "");
+
+    ConcurrentContactManager* manager = ConcurrentContactManager::getInstance();
+    int firstId = Contact::getNextId();
+    {
+        bench::SilenceStdout quiet;
+        manager->bulkImport(records);
+    }
+    for (size_t t = 0; t < counts.back(); t++) {
+        queries.push_back(makeQueries(n, firstId, static_cast<unsigned>(t + 1)));
+    }
+
+    for (int mix = 0; mix < 2; mix++) {
+        bool searchMix = mix == 1;
+        for (int withWriter = 0; withWriter < 2; withWriter++) {
+            const char* label = withWriter ? "Concurrent + 1 writer" : "Concurrent";
+            double single = 0;
+            for (size_t threads : counts) {
+                Result r;
+                {
+                    bench::SilenceStdout quiet;
+                    r = measure(manager, n, firstId, threads, withWriter, searchMix, queries);
+                }
+                if (threads == 1) {
+                    single = r.opsPerSecond;
+                }
+                printf("  %-24s %8zu %14.0f %7.2fx %12.0f  %s\n", label, threads, r.opsPerSecond,
+                       r.opsPerSecond / single, r.writesPerSecond, searchMix ? "searches" : "lookups");
+            }
+        }
+    }
+
+    bench::SilenceStdout quiet;
+    manager->clearAll();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {1000000});
+    for (size_t n : sizes) {
+        run(n);
+    }
+    return 0;
+}
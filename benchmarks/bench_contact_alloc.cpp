@@ -0,0 +1,132 @@
+// Heap allocations per ContactManager operation.
+//
+// Counts every operator new during add / edit / remove / search on a
+// manager pre-filled with n contacts. Contact getters return string_views
+// into the ContactStore columns and setters take string_views, so what is
+// left per operation is the index work itself: the tree node and key for
+// each index entry, the normalized trigram strings, and the result set of
+// a search. Names and emails are longer than the 15-byte small-string
+// buffer, so every stray std::string copy of them shows up as one
+// allocation.
+//
+// Usage: bench_contact_alloc [contacts] [ops]   (defaults 10000 10000)
+
+#include "BenchUtil.h"
+#include "AllocCounter.h"
+#include "ContactManager.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// contactsByName is an unbalanced BST: scramble the numbering so names do
+// not arrive in key order
+size_t scramble(size_t i) {
+    return (i * 2654435761u) % 1000003;
+}
+
+string nameFor(size_t i) {
+    return "Nguyen Van Contact " + to_string(1000000 + scramble(i));
+}
+
+string phoneFor(size_t i) {
+    return "09" + to_string(10000000 + i);
+}
+
+string emailFor(size_t i) {
+    return "contact" + to_string(100000 + i) + "@example.vn";
+}
+
+// Runs op(i) for i in [0, ops) and reports allocations and time per call.
+// Inputs are built before the counter starts.
+void measure(const char* label, size_t ops, const function<void(size_t)>& op) {
+    bench::SilenceStdout quiet;
+    size_t before = bench::allocationCount();
+    bench::Stopwatch timer;
+    for (size_t i = 0; i < ops; i++) {
+        op(i);
+    }
+    double ns = timer.elapsedNs() / ops;
+    double allocs = double(bench::allocationCount() - before) / ops;
+    fprintf(stdout, "  %-36s %10.2f %10.0f\n", label, allocs, ns);
+    fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000;
+    size_t ops = argc > 2 ? strtoull(argv[2], nullptr, 10) : 10000;
+    ContactManager* manager = ContactManager::getInstance();
+
+    {
+        bench::SilenceStdout quiet;
+        for (size_t i = 0; i < n; i++) {
+            manager->addContact(nameFor(i));
+            Contact* contact = manager->findContact(nameFor(i));
+            manager->setContactPhone(contact, phoneFor(i));
+            manager->setContactEmail(contact, emailFor(i));
+        }
+    }
+
+    vector<string> names, phones, emails, renamed;
+    for (size_t i = 0; i < ops; i++) {
+        names.push_back(nameFor(n + i));
+        phones.push_back(phoneFor(n + i));
+        emails.push_back(emailFor(n + i));
+        renamed.push_back(nameFor(n + ops + i));
+    }
+    vector<Contact*> added(ops);
+    vector<string> existing, queries, shortQueries, emailQueries, phoneQueries;
+    for (size_t i = 0; i < ops; i++) {
+        existing.push_back(nameFor(i % n));
+        queries.push_back("contact " + to_string(1000000 + scramble(i % n)));
+        shortQueries.push_back(i % 2 ? "zq" : "qz");
+        emailQueries.push_back(emailFor(i % n));
+        phoneQueries.push_back(phoneFor(i % n));
+    }
+
+    printf("%zu contacts, %zu ops each\n", n, ops);
+    printf("  %-36s %10s %10s\n", "operation", "allocs/op", "ns/op");
+
+    measure("findContact(name)", ops, [&](size_t i) {
+        bench::doNotOptimize(manager->findContact(existing[i]));
+    });
+    measure("addContact", ops, [&](size_t i) {
+        manager->addContact(names[i]);
+    });
+    for (size_t i = 0; i < ops; i++) {
+        added[i] = manager->findContact(names[i]);
+    }
+    measure("setContactPhone", ops, [&](size_t i) {
+        manager->setContactPhone(added[i], phones[i]);
+    });
+    measure("setContactEmail", ops, [&](size_t i) {
+        manager->setContactEmail(added[i], emails[i]);
+    });
+    measure("renameContact", ops, [&](size_t i) {
+        manager->renameContact(added[i], renamed[i]);
+    });
+    measure("searchByName (trigram, 1 hit)", ops, [&](size_t i) {
+        bench::doNotOptimize(manager->searchByName(queries[i]).size());
+    });
+    measure("searchByName (short, no hit)", ops / 100 + 1, [&](size_t i) {
+        bench::doNotOptimize(manager->searchByName(shortQueries[i]).size());
+    });
+    measure("searchByEmail (exact, 1 hit)", ops, [&](size_t i) {
+        bench::doNotOptimize(manager->searchByEmail(emailQueries[i]).size());
+    });
+    measure("searchByPhone (exact, 1 hit)", ops, [&](size_t i) {
+        bench::doNotOptimize(manager->searchByPhone(phoneQueries[i]).size());
+    });
+    measure("removeContact(name)", ops, [&](size_t i) {
+        manager->removeContact(renamed[i]);
+    });
+    return 0;
+}
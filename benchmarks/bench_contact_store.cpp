@@ -0,0 +1,256 @@
+// Contact storage: one heap object per contact vs the columnar ContactStore.
+//
+// The old Contact held five std::string members (~170 bytes before any
+// value spills out of the small-string buffer) and was allocated with its
+// own new; an email or address longer than 15 characters added a second
+// heap block. Now a Contact is {id, handle} carved from a slab, and each
+// field's values sit back to back in that field's arena with an 8-byte
+// {offset, length} entry per contact.
+//
+// Part 1 reports heap bytes per contact for both layouts (glibc's
+// in-use bytes, so malloc headers and padding count).
+// Part 2 scans the email field the way the short-query fallback of
+// searchByName / searchByEmail does, once with that case-insensitive
+// substring match and once with a one-byte test that leaves the scan
+// bound by memory traffic:
+//   objects         walk the Contact* array, reading each object's string
+//   objects (aged)  same, in random order (a heap after edits and deletes)
+//   email tree      in-order walk of an email-keyed RedBlackTree (the old
+//                   fallback streamed the index)
+//   column          ContactStore::scan over the email column only
+//
+// Usage: bench_contact_store [size ...]   (default 1M)
+
+#include "BenchUtil.h"
+#include "Contact.h"
+#include "ContactStore.h"
+#include "RedBlackTree.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// The pre-columnar Contact layout
+struct LegacyContact {
+    string name;
+    string phoneNumber;
+    string email;
+    string address;
+    string notes;
+    int id;
+};
+
+const char* const FAMILY_NAMES[] = {"Nguyen", "Tran", "Le", "Pham", "Hoang", "Phan", "Vu", "Dang", "Bui", "Do"};
+const char* const MIDDLE_NAMES[] = {"Van", "Thi", "Minh", "Duc", "Ngoc", "Thanh", "Quoc", "Hai"};
+
+string nameFor(size_t i) {
+    return string(FAMILY_NAMES[i % 10]) + " " + MIDDLE_NAMES[(i / 10) % 8] + " " + to_string(i);
+}
+
+string phoneFor(size_t i) {
+    return "09" + to_string(10000000 + i);
+}
+
+string emailFor(size_t i) {
+    return "user" + to_string(i) + "@example.vn";
+}
+
+string addressFor(size_t i) {
+    return to_string(i % 500) + " Le Loi, Quan 1";
+}
+
+// Every tenth contact has a note
+string notesFor(size_t i) {
+    return i % 10 == 0 ? "Dong nghiep cu" : "";
+}
+
+long long heapInUse() {
+#if defined(__GLIBC__)
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<long long>(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+bool containsIgnoreCase(string_view text, string_view lowerPattern) {
+    if (lowerPattern.size() > text.size()) {
+        return false;
+    }
+    size_t last = text.size() - lowerPattern.size();
+    for (size_t start = 0; start <= last; start++) {
+        size_t i = 0;
+        while (i < lowerPattern.size() &&
+               tolower(static_cast<unsigned char>(text[start + i])) == static_cast<unsigned char>(lowerPattern[i])) {
+            i++;
+        }
+        if (i == lowerPattern.size()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const int SCAN_ROUNDS = 5;
+
+// Cheapest possible per-value work, so the scan is bound by memory traffic
+bool hasDigitNine(string_view text) {
+    return text.size() > 4 && text[4] == '9';
+}
+
+bool containsNineNine(string_view text) {
+    return containsIgnoreCase(text, "99");
+}
+
+void printScan(const char* label, size_t n, size_t matches, double ms, size_t bytes) {
+    double perRound = ms / SCAN_ROUNDS;
+    printf("  %-18s %10zu %10.1f %12.1f %10.0f\n", label, matches, perRound, perRound * 1e6 / n,
+           bytes / (perRound / 1e3) / 1e6);
+}
+
+template<typename Predicate>
+void compareScans(const char* title, Predicate matches, const vector<LegacyContact*>& legacy,
+                  const vector<LegacyContact*>& aged, const RedBlackTree<string, Contact*>& byEmail,
+                  const ContactStore* store, size_t emailBytes) {
+    size_t n = legacy.size();
+    printf("\n  %s, %d rounds\n", title, SCAN_ROUNDS);
+    printf("  %-18s %10s %10s %12s %10s\n", "scan", "matches", "ms", "ns/contact", "MB/s");
+
+    const vector<LegacyContact*>* orders[] = {&legacy, &aged};
+    const char* labels[] = {"objects", "objects (aged)"};
+    for (int k = 0; k < 2; k++) {
+        size_t found = 0;
+        bench::Stopwatch timer;
+        for (int round = 0; round < SCAN_ROUNDS; round++) {
+            found = 0;
+            for (const LegacyContact* contact : *orders[k]) {
+                found += matches(contact->email);
+            }
+        }
+        printScan(labels[k], n, found, timer.elapsedMs(), emailBytes);
+    }
+
+    size_t found = 0;
+    bench::Stopwatch timer;
+    for (int round = 0; round < SCAN_ROUNDS; round++) {
+        found = 0;
+        for (const auto& entry : byEmail) {
+            found += matches(entry.first);
+        }
+    }
+    printScan("email tree", n, found, timer.elapsedMs(), emailBytes);
+
+    timer.reset();
+    for (int round = 0; round < SCAN_ROUNDS; round++) {
+        found = 0;
+        store->scan(ContactStore::FIELD_EMAIL, [&](ContactStore::Handle, string_view email) {
+            found += matches(email);
+        });
+    }
+    printScan("column", n, found, timer.elapsedMs(), emailBytes);
+}
+
+void run(size_t n) {
+    printf("%zu contacts\n", n);
+
+    // Part 1: memory
+    double legacyBytes, columnBytes;
+    vector<LegacyContact*> legacy;
+    legacy.reserve(n);
+    {
+        long long before = heapInUse();
+        for (size_t i = 0; i < n; i++) {
+            LegacyContact* contact = new LegacyContact();
+            contact->id = static_cast<int>(i + 1);
+            contact->name = nameFor(i);
+            contact->phoneNumber = phoneFor(i);
+            contact->email = emailFor(i);
+            contact->address = addressFor(i);
+            contact->notes = notesFor(i);
+            legacy.push_back(contact);
+        }
+        legacyBytes = double(heapInUse() - before) / n;
+    }
+
+    ContactStore* store = ContactStore::getInstance();
+    vector<Contact*> contacts;
+    contacts.reserve(n);
+    {
+        long long before = heapInUse();
+        for (size_t i = 0; i < n; i++) {
+            Contact* contact = Contact::create(nameFor(i));
+            contact->setPhoneNumber(phoneFor(i));
+            contact->setEmail(emailFor(i));
+            contact->setAddress(addressFor(i));
+            contact->setNotes(notesFor(i));
+            contacts.push_back(contact);
+        }
+        store->shrinkToFit();
+        columnBytes = double(heapInUse() - before) / n;
+    }
+
+    ContactStore::Stats stats = store->stats();
+    printf("  %-34s %10s\n", "layout", "bytes/contact");
+    printf("  %-34s %10.1f\n", "Contact objects (5 x std::string)", legacyBytes);
+    printf("  %-34s %10.1f\n", "ContactStore columns", columnBytes);
+    printf("    Contact {id, handle} in slabs  %10.1f\n", double(sizeof(Contact)));
+    printf("    owner pointers                 %10.1f\n", double(sizeof(Contact*)));
+    printf("    column entries                 %10.1f\n", double(stats.entryBytes) / n);
+    printf("    arena bytes                    %10.1f\n", double(stats.arenaBytes) / n);
+
+    // Part 2: scans
+    size_t emailBytes = 0;
+    for (size_t i = 0; i < n; i++) {
+        emailBytes += legacy[i]->email.size();
+    }
+
+    // Visiting the objects in random order stands in for a heap aged by
+    // edits and deletes, where consecutive contacts no longer sit together
+    vector<LegacyContact*> aged = legacy;
+    shuffle(aged.begin(), aged.end(), mt19937_64(5));
+
+    vector<pair<string, Contact*>> entries;
+    entries.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        entries.emplace_back(legacy[i]->email, contacts[i]);
+    }
+    sort(entries.begin(), entries.end());
+    RedBlackTree<string, Contact*> byEmail;
+    byEmail.buildFromSorted(entries.begin(), entries.end());
+    entries.clear();
+    entries.shrink_to_fit();
+
+    compareScans("email contains \"99\" (ignore case)", containsNineNine, legacy, aged, byEmail, store, emailBytes);
+    compareScans("email[4] == '9'", hasDigitNine, legacy, aged, byEmail, store, emailBytes);
+    printf("\n");
+
+    for (LegacyContact* contact : legacy) {
+        delete contact;
+    }
+    for (Contact* contact : contacts) {
+        Contact::destroy(contact);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {1000000});
+    for (size_t n : sizes) {
+        run(n);
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Duplicate-check throughput: hash index vs the ordered trees.
+//
+// isPhoneNumberDuplicate / isEmailDuplicate (and canAddPhoneNumber, the
+// exact-match path of searchByPhone, the uniqueness checks in bulkImport)
+// now probe a HashIndex kept next to the phone/email trees instead of
+// descending the tree. This compares, per index on the same keys:
+//   ns/check   one exact lookup from a string_view, half of them hit
+//   M/s        checks per second
+//   bytes/key  heap bytes per key, keys included (glibc in-use bytes)
+// and then the manager's own duplicate checks end to end.
+//
+// Keys are phone numbers (10 digits, inline in std::string) and e-mail
+// addresses (heap-allocated key bytes).
+//
+// Usage: bench_duplicate_check [size ...]   (default 10k 100k 1M)
+
+#include "BenchUtil.h"
+#include "BTree.h"
+#include "ContactManager.h"
+#include "HashIndex.h"
+#include "RedBlackTree.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+string phoneKey(size_t i) {
+    return "09" + to_string(10000000 + i * 7919 % 90000000);
+}
+
+string emailKey(size_t i) {
+    return "contact" + to_string(i * 7919 % 100000007) + "@example.vn";
+}
+
+long long heapInUse() {
+#if defined(__GLIBC__)
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<long long>(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+// Even queries are present, odd ones are not
+vector<string> makeQueries(size_t n, string (*keyOf)(size_t)) {
+    vector<size_t> picks = bench::randomIndexes(1000000, n);
+    vector<string> queries;
+    queries.reserve(picks.size());
+    for (size_t i = 0; i < picks.size(); i++) {
+        queries.push_back(keyOf(i % 2 == 0 ? picks[i] : n + picks[i]));
+    }
+    return queries;
+}
+
+// bytes < 0: not measured
+void report(const char* label, double ns, double bytes, size_t hits, size_t queries) {
+    printf("  %-32s %10.0f %10.1f", label, ns, 1e3 / ns);
+    if (bytes >= 0) {
+        printf(" %10.1f", bytes);
+    }
+    printf("%s\n", 2 * hits == queries ? "" : "  (hit count off!)");
+}
+
+template<typename Index>
+void measure(const char* label, const vector<string>& keys, const vector<string>& queries) {
+    long long before = heapInUse();
+    Index* index = new Index();
+    for (size_t i = 0; i < keys.size(); i++) {
+        index->insert(keys[i], nullptr);
+    }
+    double bytes = double(heapInUse() - before) / keys.size();
+
+    size_t hits = 0;
+    bench::Stopwatch timer;
+    for (const string& query : queries) {
+        hits += index->contains(string_view(query));
+    }
+    report(label, timer.elapsedNs() / queries.size(), bytes, hits, queries.size());
+    delete index;
+}
+
+void run(const char* kind, string (*keyOf)(size_t), size_t n) {
+    vector<string> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        keys.push_back(keyOf(i));
+    }
+    shuffle(keys.begin(), keys.end(), mt19937_64(3));
+    vector<string> queries = makeQueries(n, keyOf);
+
+    printf("\n%zu %s keys, %zu checks\n", n, kind, queries.size());
+    printf("  %-32s %10s %10s %10s\n", "index", "ns/check", "M/s", "bytes/key");
+    measure<RedBlackTree<string, Contact*, NodePool, less<>>>("RedBlackTree", keys, queries);
+    measure<BTree<string, Contact*, BTreeDefaultOrder<string>::value, less<>>>("BTree", keys, queries);
+    measure<HashIndex<string, Contact*, StringHash, equal_to<>>>("HashIndex", keys, queries);
+}
+
+void runManager(size_t n) {
+    ContactManager* manager = ContactManager::getInstance();
+    {
+        bench::SilenceStdout quiet;
+        vector<ContactRecord> records(n);
+        for (size_t i = 0; i < n; i++) {
+            records[i].name = "Nguyen Van " + to_string(i);
+            records[i].phoneNumber = phoneKey(i);
+            records[i].email = emailKey(i);
+        }
+        manager->bulkImport(records);
+    }
+
+    vector<string> phones = makeQueries(n, phoneKey);
+    vector<string> emails = makeQueries(n, emailKey);
+    printf("\nContactManager, %zu contacts\n", n);
+    printf("  %-32s %10s %10s\n", "check", "ns/check", "M/s");
+
+    size_t hits = 0;
+    bench::Stopwatch timer;
+    for (const string& phone : phones) {
+        hits += manager->isPhoneNumberDuplicate(phone);
+    }
+    report("isPhoneNumberDuplicate", timer.elapsedNs() / phones.size(), -1, hits, phones.size());
+
+    hits = 0;
+    timer.reset();
+    for (const string& email : emails) {
+        hits += manager->isEmailDuplicate(email);
+    }
+    report("isEmailDuplicate", timer.elapsedNs() / emails.size(), -1, hits, emails.size());
+
+    bench::SilenceStdout quiet;
+    manager->clearAll();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {10000, 100000, 1000000});
+    for (size_t n : sizes) {
+        run("phone", phoneKey, n);
+        run("e-mail", emailKey, n);
+        runManager(n);
+    }
+    return 0;
+}
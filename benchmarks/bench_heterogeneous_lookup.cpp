@@ -0,0 +1,152 @@
+// Heterogeneous lookup: find a string key from a string_view without
+// building a std::string.
+//
+// Contact fields come out of the ContactStore as string_views, and the
+// duplicate checks on the phone/email path (isPhoneNumberDuplicate,
+// isEmailDuplicate, unindexPhone, unindexEmail) used to copy each view into
+// a temporary key before searching a std::less<string> tree. With
+// std::less<> as the tree's Compare the view is compared in place.
+//
+// Keys are email addresses longer than the 15-byte small-string buffer, so
+// every temporary key costs one heap allocation. Half of the queries hit.
+//
+// Usage: bench_heterogeneous_lookup [keys] [lookups]   (defaults 100000 1000000)
+
+#include "BenchUtil.h"
+#include "AllocCounter.h"
+#include "BinarySearchTree.h"
+#include "ContactManager.h"
+#include "RedBlackTree.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+string emailFor(size_t i) {
+    return "contact" + to_string(100000 + i) + "@example.vn";
+}
+
+string phoneFor(size_t i) {
+    return "09" + to_string(10000000 + i);
+}
+
+// Views into one buffer, the way ContactStore hands out field values.
+// Even query indexes are present in the index, odd ones are not.
+struct Queries {
+    string arena;
+    vector<string_view> views;
+};
+
+Queries makeQueries(size_t keys, size_t lookups, string (*valueFor)(size_t)) {
+    Queries queries;
+    vector<size_t> offsets;
+    mt19937_64 rng(7);
+    for (size_t i = 0; i < lookups; i++) {
+        size_t k = rng() % keys;
+        string value = valueFor(i % 2 == 0 ? k : keys + k);
+        offsets.push_back(queries.arena.size());
+        queries.arena += value;
+    }
+    queries.arena.push_back('\0');
+    for (size_t i = 0; i < lookups; i++) {
+        size_t end = i + 1 < lookups ? offsets[i + 1] : queries.arena.size() - 1;
+        queries.views.emplace_back(queries.arena.data() + offsets[i], end - offsets[i]);
+    }
+    return queries;
+}
+
+void measure(const char* label, const vector<string_view>& views, const function<bool(string_view)>& lookup) {
+    size_t before = bench::allocationCount();
+    size_t hits = 0;
+    bench::Stopwatch timer;
+    for (string_view view : views) {
+        hits += lookup(view);
+    }
+    double ns = timer.elapsedNs() / views.size();
+    double allocs = double(bench::allocationCount() - before) / views.size();
+    printf("  %-40s %10.2f %10.0f %10zu\n", label, allocs, ns, hits);
+}
+
+template<typename Tree>
+void fill(Tree& tree, size_t keys) {
+    vector<pair<string, Contact*>> entries;
+    for (size_t i = 0; i < keys; i++) {
+        entries.emplace_back(emailFor(i), nullptr);
+    }
+    sort(entries.begin(), entries.end());
+    tree.buildFromSorted(make_move_iterator(entries.begin()), make_move_iterator(entries.end()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t keys = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000;
+    size_t lookups = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+
+    Queries emails = makeQueries(keys, lookups, emailFor);
+    Queries phones = makeQueries(keys, lookups, phoneFor);
+
+    printf("%zu keys, %zu lookups (half hit)\n", keys, lookups);
+    printf("  %-40s %10s %10s %10s\n", "lookup", "allocs/op", "ns/op", "hits");
+
+    {
+        RedBlackTree<string, Contact*> exact;
+        RedBlackTree<string, Contact*, NodePool, less<>> transparent;
+        fill(exact, keys);
+        fill(transparent, keys);
+        measure("RedBlackTree find(string(view))", emails.views, [&](string_view view) {
+            return exact.find(string(view)) != nullptr;
+        });
+        measure("RedBlackTree<less<>> find(view)", emails.views, [&](string_view view) {
+            return transparent.find(view) != nullptr;
+        });
+    }
+    {
+        // Filled in key order the BST would be a list: insert shuffled
+        vector<size_t> order(keys);
+        for (size_t i = 0; i < keys; i++) {
+            order[i] = i;
+        }
+        shuffle(order.begin(), order.end(), mt19937_64(3));
+        BinarySearchTree<string, Contact*> exact;
+        BinarySearchTree<string, Contact*, NodePool, less<>> transparent;
+        for (size_t i : order) {
+            exact.insert(emailFor(i), nullptr);
+            transparent.insert(emailFor(i), nullptr);
+        }
+        measure("BinarySearchTree find(string(view))", emails.views, [&](string_view view) {
+            return exact.find(string(view)) != nullptr;
+        });
+        measure("BinarySearchTree<less<>> find(view)", emails.views, [&](string_view view) {
+            return transparent.find(view) != nullptr;
+        });
+    }
+
+    ContactManager* manager = ContactManager::getInstance();
+    {
+        bench::SilenceStdout quiet;
+        vector<ContactRecord> records(keys);
+        for (size_t i = 0; i < keys; i++) {
+            records[i].name = "Nguyen Van " + to_string(i);
+            records[i].phoneNumber = phoneFor(i);
+            records[i].email = emailFor(i);
+        }
+        manager->bulkImport(records);
+    }
+    measure("ContactManager::isEmailDuplicate", emails.views, [&](string_view view) {
+        return manager->isEmailDuplicate(view);
+    });
+    measure("ContactManager::isPhoneNumberDuplicate", phones.views, [&](string_view view) {
+        return manager->isPhoneNumberDuplicate(view);
+    });
+    return 0;
+}
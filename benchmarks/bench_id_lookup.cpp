@@ -0,0 +1,130 @@
+// Lookup latency of the ID index as the address book grows.
+//
+// IDs come from Contact::nextId and are strictly increasing, which is the
+// worst case for the unbalanced BinarySearchTree: every insert becomes the
+// right child of the previous one. The dense IdSlotTable should stay flat.
+//
+// Before timing, a strided table (one ID in four, as a shard holds) is
+// checked to reject keys off its stride instead of overwriting a neighbour.
+//
+// Usage: bench_id_lookup [size ...]   (default 1k .. 1M; try 10000000)
+
+#include "BenchUtil.h"
+#include "BinarySearchTree.h"
+#include "RedBlackTree.h"
+#include "IdSlotTable.h"
+#include "ContactManager.h"
+
+#include <cstdio>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+const size_t LOOKUPS = 1000000;
+// Sequential BST inserts are O(n^2) and recurse n deep; cap that column.
+const size_t BST_LIMIT = 20000;
+const size_t BST_LOOKUPS = 10000;
+
+template<typename Index>
+double measureLookupNs(const Index& index, const vector<size_t>& probes) {
+    bench::Stopwatch timer;
+    size_t hits = 0;
+    for (size_t probe : probes) {
+        hits += index.find(static_cast<int>(probe) + 1) != nullptr;
+    }
+    bench::doNotOptimize(hits);
+    return timer.elapsedNs() / probes.size();
+}
+
+double measureManagerLookupNs(size_t n, const vector<size_t>& probes) {
+    ContactManager* manager = ContactManager::getInstance();
+    vector<int> ids;
+    ids.reserve(n);
+    {
+        bench::SilenceStdout quiet;
+        manager->clearAll();
+        for (size_t i = 0; i < n; i++) {
+            // Scramble names so the (unbalanced) name index stays shallow
+            string name = "Contact " + to_string((i * 2654435761u) % 4294967291u) + "-" + to_string(i);
+            manager->addContact(name);
+            ids.push_back(manager->findContact(name)->getId());
+        }
+    }
+
+    bench::Stopwatch timer;
+    size_t hits = 0;
+    for (size_t probe : probes) {
+        hits += manager->findContact(ids[probe]) != nullptr;
+    }
+    bench::doNotOptimize(hits);
+    double ns = timer.elapsedNs() / probes.size();
+
+    bench::SilenceStdout quiet;
+    manager->clearAll();
+    return ns;
+}
+
+// Keys 1, 5, 9, ... with stride 4; 6 and 3 (below base) are off the stride
+bool strideCheckPasses() {
+    IdSlotTable<int> strided;
+    strided.setStride(4);
+    for (int key = 5; key <= 41; key += 4) {
+        strided.insert(key, key);
+    }
+    strided.insert(1, 1);  // Rebase below the first key
+
+    bool ok = !strided.insert(6, -1) && !strided.insert(3, -1) && !strided.insert(-2, -1);
+    for (int key = 1; key <= 44; key++) {
+        const int* value = strided.find(key);
+        bool expected = key % 4 == 1;
+        ok = ok && (value != nullptr) == expected && (value == nullptr || *value == key);
+    }
+    return ok && strided.size() == 11;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {1000, 10000, 100000, 1000000});
+
+    if (!strideCheckPasses()) {
+        fprintf(stderr, "IdSlotTable stride check failed\n");
+        return 1;
+    }
+    printf("IdSlotTable stride check: ok\n\n");
+
+    printf("%12s %14s %14s %14s %16s\n", "contacts", "slot ns/op", "rbt ns/op", "bst ns/op", "manager ns/op");
+    for (size_t n : sizes) {
+        vector<size_t> probes = bench::randomIndexes(LOOKUPS, n);
+
+        IdSlotTable<int> slots;
+        RedBlackTree<int, int> rbt;
+        for (size_t i = 1; i <= n; i++) {
+            slots.insert(static_cast<int>(i), static_cast<int>(i));
+            rbt.insert(static_cast<int>(i), static_cast<int>(i));
+        }
+
+        double slotNs = measureLookupNs(slots, probes);
+        double rbtNs = measureLookupNs(rbt, probes);
+
+        char bstColumn[32] = "-";
+        if (n <= BST_LIMIT) {
+            BinarySearchTree<int, int> bst;
+            for (size_t i = 1; i <= n; i++) {
+                bst.insert(static_cast<int>(i), static_cast<int>(i));
+            }
+            vector<size_t> bstProbes(probes.begin(), probes.begin() + BST_LOOKUPS);
+            snprintf(bstColumn, sizeof(bstColumn), "%.1f", measureLookupNs(bst, bstProbes));
+        }
+
+        char managerColumn[32] = "-";
+        if (n <= 1000000) {
+            snprintf(managerColumn, sizeof(managerColumn), "%.1f", measureManagerLookupNs(n, probes));
+        }
+
+        printf("%12zu %14.1f %14.1f %14s %16s\n", n, slotNs, rbtNs, bstColumn, managerColumn);
+    }
+    return 0;
+}
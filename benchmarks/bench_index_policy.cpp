@@ -0,0 +1,223 @@
+// BasicContactManager under every index policy, one workload for all.
+//
+// The name, ID, phone and e-mail indexes are template parameters of the
+// manager (IndexPolicy in ContactManager.h), so each combination below is
+// its own fully inlined instantiation; there is no virtual call on any path.
+// Name: BinarySearchTree, RedBlackTree or BTree. ID: IdSlotTable,
+// RedBlackTree<int> or BTree<int> (the BST is left out: sequential IDs make
+// it a list, see bench_id_lookup). Phone and e-mail: RedBlackTree or BTree.
+//
+// Per combination, ns per operation for:
+//   add      addContact + setContactPhone + setContactEmail (half the contacts)
+//   bulk     bulkImport, per record (the other half)
+//   id       findContact(id), every lookup hits
+//   name     findContact(name), every lookup hits
+//   phone    isPhoneNumberDuplicate, half hit
+//   email    isEmailDuplicate, half hit
+//   prefix   searchByNamePrefix, case-sensitive (walks the name index), 10 results
+//   remove   removeContact(id) on lookups / 100 random contacts
+//
+// add and remove also maintain the prefix and trigram indexes, which are the
+// same under every policy: erasing from the trigram posting lists dominates
+// remove, the regex e-mail check a good part of add. Compare the columns
+// across rows, not against each other.
+//
+// Usage: bench_index_policy [contacts] [lookups]   (defaults 100000 200000)
+
+#include "BenchUtil.h"
+#include "ContactManagerImpl.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+typedef BinarySearchTree<string, Contact*, NodePool, less<>> BstIndex;
+typedef RedBlackTree<string, Contact*, NodePool, less<>> RbtIndex;
+typedef BTree<string, Contact*, BTreeDefaultOrder<string>::value, less<>> BTreeIndex;
+typedef IdSlotTable<Contact*> SlotIdIndex;
+typedef RedBlackTree<int, Contact*> RbtIdIndex;
+typedef BTree<int, Contact*> BTreeIdIndex;
+
+template<typename K, typename V, template<typename> class A, typename C>
+const char* backendName(const BinarySearchTree<K, V, A, C>*) { return "BST"; }
+template<typename K, typename V, template<typename> class A, typename C>
+const char* backendName(const RedBlackTree<K, V, A, C>*) { return "RBT"; }
+template<typename K, typename V, size_t Order, typename C>
+const char* backendName(const BTree<K, V, Order, C>*) { return "BTree"; }
+template<typename V>
+const char* backendName(const IdSlotTable<V>*) { return "Slot"; }
+
+template<typename Index>
+const char* backendName() {
+    return backendName(static_cast<const Index*>(nullptr));
+}
+
+struct Workload {
+    vector<string> names, phones, emails;
+    vector<ContactRecord> bulk;          // names[half..n)
+    vector<size_t> lookups;              // positions into names
+    vector<string> phoneQueries, emailQueries;
+    vector<string> prefixes;
+};
+
+string nameFor(size_t i) {
+    return "Nguyen Van " + to_string(1000000 + i * 7919 % 9000000);
+}
+
+string phoneFor(size_t i) {
+    return "09" + to_string(10000000 + i * 104729 % 90000000);
+}
+
+string emailFor(size_t i) {
+    return "contact" + to_string(i * 7919 % 100000007) + "@example.vn";
+}
+
+Workload makeWorkload(size_t n, size_t lookups) {
+    Workload w;
+    for (size_t i = 0; i < n; i++) {
+        w.names.push_back(nameFor(i));
+        w.phones.push_back(phoneFor(i));
+        w.emails.push_back(emailFor(i));
+    }
+    for (size_t i = n / 2; i < n; i++) {
+        ContactRecord record;
+        record.name = w.names[i];
+        record.phoneNumber = w.phones[i];
+        record.email = w.emails[i];
+        w.bulk.push_back(record);
+    }
+    w.lookups = bench::randomIndexes(lookups, n);
+    for (size_t k = 0; k < lookups; k++) {
+        size_t i = w.lookups[k];
+        w.phoneQueries.push_back(k % 2 == 0 ? w.phones[i] : phoneFor(n + i));
+        w.emailQueries.push_back(k % 2 == 0 ? w.emails[i] : emailFor(n + i));
+        if (k < lookups / 10) {
+            w.prefixes.push_back(w.names[i].substr(0, 14));
+        }
+    }
+    return w;
+}
+
+template<typename Policy>
+void measure(const Workload& w) {
+    typedef BasicContactManager<Policy> Manager;
+    Manager* manager = Manager::getInstance();
+    size_t n = w.names.size();
+    size_t half = n / 2;
+    double ns[8];
+    size_t hits = 0;
+    int firstId = Contact::getNextId();
+
+    {
+        bench::SilenceStdout quiet;
+        bench::Stopwatch timer;
+        for (size_t i = 0; i < half; i++) {
+            manager->addContact(w.names[i]);
+            Contact* contact = manager->findContact(w.names[i]);
+            manager->setContactPhone(contact, w.phones[i]);
+            manager->setContactEmail(contact, w.emails[i]);
+        }
+        ns[0] = timer.elapsedNs() / half;
+
+        timer.reset();
+        manager->bulkImport(w.bulk);
+        ns[1] = timer.elapsedNs() / w.bulk.size();
+    }
+
+    // IDs are consecutive: the added half first, then the bulk half in input order
+    bench::Stopwatch timer;
+    for (size_t i : w.lookups) {
+        hits += manager->findContact(firstId + static_cast<int>(i)) != nullptr;
+    }
+    ns[2] = timer.elapsedNs() / w.lookups.size();
+
+    timer.reset();
+    for (size_t i : w.lookups) {
+        hits += manager->findContact(w.names[i]) != nullptr;
+    }
+    ns[3] = timer.elapsedNs() / w.lookups.size();
+
+    timer.reset();
+    for (const string& phone : w.phoneQueries) {
+        hits += manager->isPhoneNumberDuplicate(phone);
+    }
+    ns[4] = timer.elapsedNs() / w.phoneQueries.size();
+
+    timer.reset();
+    for (const string& email : w.emailQueries) {
+        hits += manager->isEmailDuplicate(email);
+    }
+    ns[5] = timer.elapsedNs() / w.emailQueries.size();
+
+    timer.reset();
+    for (const string& prefix : w.prefixes) {
+        hits += manager->searchByNamePrefix(prefix, false, 10).size();
+    }
+    ns[6] = timer.elapsedNs() / w.prefixes.size();
+
+    vector<int> victims(n);
+    for (size_t i = 0; i < n; i++) {
+        victims[i] = firstId + static_cast<int>(i);
+    }
+    shuffle(victims.begin(), victims.end(), mt19937_64(17));
+    victims.resize(min(n, max<size_t>(w.lookups.size() / 100, 1)));
+    {
+        bench::SilenceStdout quiet;
+        timer.reset();
+        for (int id : victims) {
+            hits += manager->removeContact(id);
+        }
+        ns[7] = timer.elapsedNs() / victims.size();
+        manager->clearAll();
+    }
+    bench::doNotOptimize(hits);
+
+    printf("  %-6s %-6s %-6s %-6s", backendName<typename Policy::NameIndex>(), backendName<typename Policy::IdIndex>(),
+           backendName<typename Policy::PhoneIndex>(), backendName<typename Policy::EmailIndex>());
+    for (double value : ns) {
+        printf(" %8.0f", value);
+    }
+    printf("%s\n", is_same<Policy, DefaultIndexPolicy>::value ? "  (default)" : "");
+}
+
+template<typename Name, typename Id, typename Phone>
+void forEachEmail(const Workload& w) {
+    measure<IndexPolicy<Name, Id, Phone, RbtIndex>>(w);
+    measure<IndexPolicy<Name, Id, Phone, BTreeIndex>>(w);
+}
+
+template<typename Name, typename Id>
+void forEachPhone(const Workload& w) {
+    forEachEmail<Name, Id, RbtIndex>(w);
+    forEachEmail<Name, Id, BTreeIndex>(w);
+}
+
+template<typename Name>
+void forEachId(const Workload& w) {
+    forEachPhone<Name, SlotIdIndex>(w);
+    forEachPhone<Name, RbtIdIndex>(w);
+    forEachPhone<Name, BTreeIdIndex>(w);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000;
+    size_t lookups = argc > 2 ? strtoull(argv[2], nullptr, 10) : 200000;
+    Workload w = makeWorkload(n, lookups);
+
+    printf("%zu contacts, %zu lookups, ns per operation\n", n, lookups);
+    printf("  %-6s %-6s %-6s %-6s %8s %8s %8s %8s %8s %8s %8s %8s\n", "name", "id", "phone", "email", "add", "bulk",
+           "id", "name", "phone", "email", "prefix", "remove");
+    forEachId<BstIndex>(w);
+    forEachId<RbtIndex>(w);
+    forEachId<BTreeIndex>(w);
+    return 0;
+}
@@ -0,0 +1,148 @@
+// Substring search: trigram index vs linear scan, by query length.
+//
+// The linear column reproduces the pre-index search loop (lowercase copy
+// of every key, then string::find). The indexed column is the public
+// ContactManager::searchBy* path: posting-list intersection followed by
+// verification of each candidate. Queries shorter than three characters
+// cannot use trigrams and fall back to a scan.
+//
+// The mutation table times edits of old contacts spread over the whole ID
+// range. Each one removes the contact's ID from the posting lists of the
+// old value and inserts it into the middle of those of the new value, the
+// case sorted posting vectors paid O(list length) for.
+//
+// Usage: bench_ngram_search [size ...]   (default 200k; try 5000000)
+
+#include "BenchUtil.h"
+#include "ContactManager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+
+using namespace std;
+
+namespace {
+
+const char* const FAMILY_NAMES[] = {"Nguyen", "Tran", "Le", "Pham", "Hoang", "Phan", "Vu", "Dang", "Bui", "Do"};
+const char* const GIVEN_NAMES[] = {"An", "Binh", "Chau", "Dung", "Giang", "Hanh", "Khoa", "Linh", "Minh", "Nam",
+                                   "Oanh", "Phuc", "Quang", "Son", "Tuan", "Uyen", "Viet", "Xuan", "Yen"};
+const char* const DOMAINS[] = {"gmail.com", "yahoo.com", "outlook.com", "fpt.vn", "vnu.edu.vn"};
+
+// Like the old search loop, matches are collected into a std::set
+size_t linearScan(const vector<string>& keys, const string& query) {
+    string lowerQuery = query;
+    transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
+    set<const string*> results;
+    for (const string& key : keys) {
+        string lowerKey = key;
+        transform(lowerKey.begin(), lowerKey.end(), lowerKey.begin(), ::tolower);
+        if (lowerKey.find(lowerQuery) != string::npos) {
+            results.insert(&key);
+        }
+    }
+    return results.size();
+}
+
+template<typename Fn>
+double microsPerQuery(int repeats, Fn fn) {
+    bench::Stopwatch timer;
+    size_t total = 0;
+    for (int i = 0; i < repeats; i++) {
+        total += fn();
+    }
+    bench::doNotOptimize(total);
+    return timer.elapsedNs() / repeats / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {200000});
+    ContactManager* manager = ContactManager::getInstance();
+
+    for (size_t n : sizes) {
+        vector<string> names, phones, emails;
+        names.reserve(n);
+        phones.reserve(n);
+        emails.reserve(n);
+        {
+            bench::SilenceStdout quiet;
+            manager->clearAll();
+            for (size_t i = 0; i < n; i++) {
+                string family = FAMILY_NAMES[(i * 7) % 10];
+                string given = GIVEN_NAMES[(i * 13) % 19];
+                string name = family + " " + given + " " + to_string(i);
+                string phone = "09" + to_string(10000000 + (i * 2654435761u) % 90000000);
+                string email = given + "." + family + to_string(i) + "@" + DOMAINS[i % 5];
+                transform(email.begin(), email.end(), email.begin(), ::tolower);
+
+                manager->addContact(name);
+                Contact* contact = manager->findContact(name);
+                manager->setContactPhone(contact, phone);
+                manager->setContactEmail(contact, email);
+                names.push_back(name);
+                phones.push_back(phone);
+                emails.push_back(email);
+            }
+        }
+
+        printf("%zu contacts\n", n);
+        printf("  %-8s %-16s %8s %14s %14s\n", "field", "query", "matches", "linear us", "trigram us");
+
+        struct Query {
+            const char* field;
+            const char* text;
+        };
+        const Query queries[] = {
+            {"name", "ng"}, {"name", "tuan"}, {"name", "nguyen"}, {"name", "nguyen an 12"},
+            {"phone", "45"}, {"phone", "4567"}, {"phone", "0912345"},
+            {"email", "@gm"}, {"email", "@gmail"}, {"email", "minh.le12"},
+        };
+
+        for (const Query& query : queries) {
+            string field = query.field;
+            const vector<string>& keys = field == "name" ? names : field == "phone" ? phones : emails;
+            size_t matches = 0;
+            double indexedUs = microsPerQuery(5, [&]() {
+                matches = field == "name" ? manager->searchByName(query.text).size()
+                        : field == "phone" ? manager->searchByPhone(query.text).size()
+                        : manager->searchByEmail(query.text).size();
+                return matches;
+            });
+            double linearUs = microsPerQuery(2, [&]() { return linearScan(keys, query.text); });
+            printf("  %-8s %-16s %8zu %14.1f %14.1f\n", query.field, query.text, matches, linearUs, indexedUs);
+        }
+
+        // Mutations last: they change the keys the queries above verify against
+        const size_t EDITS = min<size_t>(n, 2000);
+        printf("  %-8s %-16s %8s %14s\n", "edit", "", "count", "us/op");
+        const char* const edits[] = {"name", "phone", "email"};
+        for (const char* edit : edits) {
+            string kind = edit;
+            double editUs;
+            {
+                bench::SilenceStdout quiet;
+                bench::Stopwatch timer;
+                for (size_t k = 0; k < EDITS; k++) {
+                    size_t i = (k * 2654435761u) % n;
+                    Contact* contact = manager->findContact(names[i]);
+                    if (kind == "name") {
+                        names[i] += " b";
+                        manager->renameContact(contact, names[i]);
+                    } else if (kind == "phone") {
+                        manager->setContactPhone(contact, "08" + to_string(10000000 + (i * 40503u) % 90000000));
+                    } else {
+                        manager->setContactEmail(contact, "b." + emails[i]);
+                    }
+                }
+                editUs = timer.elapsedNs() / EDITS / 1000.0;
+            }
+            printf("  %-8s %-16s %8zu %14.1f\n", edit, "", EDITS, editUs);
+        }
+
+        bench::SilenceStdout quiet;
+        manager->clearAll();
+    }
+    return 0;
+}
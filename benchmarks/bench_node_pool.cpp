@@ -0,0 +1,137 @@
+// Tree node allocation: one heap allocation per node vs the slab NodePool.
+//
+// For each tree and allocator this reports heap allocations and time for
+// inserting n shuffled keys, random lookup latency, a full in-order scan
+// and clear(). Contact* values with int keys are trivially destructible,
+// so a pooled clear() drops the slabs without visiting a single node;
+// string keys still need their destructors run.
+//
+// Lookups are measured twice: right after the inserts, and after a churn
+// phase (remove and re-insert random halves while unrelated allocations
+// interleave) that scatters heap-allocated nodes the way a long-running
+// address book does.
+//
+// Usage: bench_node_pool [size ...]   (default 1M)
+
+#include "BenchUtil.h"
+#include "AllocCounter.h"
+#include "BinarySearchTree.h"
+#include "NodePool.h"
+#include "RedBlackTree.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Contact;
+
+string phoneKey(size_t i) {
+    return "09" + to_string(10000000 + i * 7919 % 90000000);
+}
+
+template<typename K>
+K makeKey(size_t i);
+
+template<>
+int makeKey<int>(size_t i) {
+    return static_cast<int>(i);
+}
+
+template<>
+string makeKey<string>(size_t i) {
+    return phoneKey(i);
+}
+
+template<typename Tree, typename K>
+void run(const char* label, size_t n) {
+    vector<K> keys(n);
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = makeKey<K>(i);
+    }
+    vector<size_t> order(n);
+    for (size_t i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    shuffle(order.begin(), order.end(), mt19937_64(7));
+    vector<size_t> probes = bench::randomIndexes(1000000, n, 11);
+
+    unique_ptr<Tree> tree(new Tree());
+
+    size_t before = bench::allocationCount();
+    bench::Stopwatch timer;
+    for (size_t i : order) {
+        tree->insert(keys[i], nullptr);
+    }
+    double insertMs = timer.elapsedMs();
+    size_t insertAllocs = bench::allocationCount() - before;
+
+    auto lookupNs = [&]() {
+        bench::Stopwatch lookupTimer;
+        size_t found = 0;
+        for (size_t i : probes) {
+            found += tree->contains(keys[i]);
+        }
+        bench::doNotOptimize(found);
+        return lookupTimer.elapsedNs() / probes.size();
+    };
+    double freshNs = lookupNs();
+
+    timer.reset();
+    size_t visited = 0;
+    for (const auto& entry : *tree) {
+        visited += entry.second == nullptr;
+    }
+    bench::doNotOptimize(visited);
+    double scanMs = timer.elapsedMs();
+
+    // Churn: unrelated allocations interleave with node frees and re-inserts
+    vector<unique_ptr<char[]>> noise;
+    for (int round = 0; round < 4; round++) {
+        vector<size_t> victims = bench::randomIndexes(n / 2, n, 100 + round);
+        for (size_t i : victims) {
+            tree->remove(keys[i]);
+            noise.emplace_back(new char[48]);
+        }
+        for (size_t i : victims) {
+            tree->insert(keys[i], nullptr);
+        }
+    }
+    double churnedNs = lookupNs();
+    noise.clear();
+
+    timer.reset();
+    tree->clear();
+    double clearMs = timer.elapsedMs();
+
+    printf("  %-34s %10zu %11.1f %11.1f %11.1f %9.1f %9.2f\n", label, insertAllocs, insertMs, freshNs, churnedNs,
+           scanMs, clearMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {1000000});
+
+    for (size_t n : sizes) {
+        printf("%zu keys\n", n);
+        printf("  %-34s %10s %11s %11s %11s %9s %9s\n", "tree / allocator", "allocs", "insert ms", "find ns",
+               "churned ns", "scan ms", "clear ms");
+
+        run<BinarySearchTree<int, Contact*, HeapNodeAllocator>, int>("BST<int>       heap", n);
+        run<BinarySearchTree<int, Contact*, NodePool>, int>("BST<int>       pool", n);
+        run<RedBlackTree<int, Contact*, HeapNodeAllocator>, int>("RBT<int>       heap", n);
+        run<RedBlackTree<int, Contact*, NodePool>, int>("RBT<int>       pool", n);
+        run<BinarySearchTree<string, Contact*, HeapNodeAllocator>, string>("BST<string>    heap", n);
+        run<BinarySearchTree<string, Contact*, NodePool>, string>("BST<string>    pool", n);
+        run<RedBlackTree<string, Contact*, HeapNodeAllocator>, string>("RBT<string>    heap", n);
+        run<RedBlackTree<string, Contact*, NodePool>, string>("RBT<string>    pool", n);
+    }
+    return 0;
+}
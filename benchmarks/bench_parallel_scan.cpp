@@ -0,0 +1,136 @@
+// Parallel in-order filter (parallelFilter) vs a single-threaded iterator
+// walk over the same tree.
+//
+// Keys are folded name keys ("nguyen van minh 123456"), the form the name
+// index searches; the predicate is a substring test on the key, as in a
+// searchByName scan. The RedBlackTree is bulk loaded; the BinarySearchTree
+// is filled in random order (a random BST, mean depth ~1.4 log2 n).
+// Each pool has threads - 1 workers: the calling thread is the last one.
+// Results are checked against the sequential walk. Speedup cannot exceed
+// the core count printed at the top.
+//
+// Usage: bench_parallel_scan [keys ...]   (default 1000000; the request's
+// 10M book needs ~2 GB)
+
+#include "BenchUtil.h"
+#include "BinarySearchTree.h"
+#include "RedBlackTree.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const FAMILY[] = {"nguyen", "tran", "le", "pham", "hoang", "phan", "vu", "dang", "bui", "do"};
+const char* const MIDDLE[] = {"van", "thi", "minh", "ngoc", "duc", "thanh", "quoc", "hong"};
+const char* const GIVEN[] = {"anh", "binh", "chau", "dung", "giang", "hai", "huong", "lan", "long", "mai"};
+
+const int REPEATS = 3;
+
+string keyOf(size_t i) {
+    return string(FAMILY[i % 10]) + " " + MIDDLE[i / 10 % 8] + " " + GIVEN[i / 80 % 10] + " " + to_string(i);
+}
+
+// Substring patterns: a common one and a rare one
+const char* const PATTERNS[] = {"thanh hai", "99"};
+
+template<typename Tree>
+vector<int> sequentialFilter(const Tree& tree, string_view pattern) {
+    vector<int> result;
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        if (string_view(it->first).find(pattern) != string_view::npos) {
+            result.push_back(it->second);
+        }
+    }
+    return result;
+}
+
+template<typename Tree>
+void runTree(const char* label, const Tree& tree, const vector<size_t>& counts) {
+    for (const char* pattern : PATTERNS) {
+        string_view needle(pattern);
+        vector<int> expected;
+        bench::Stopwatch timer;
+        for (int r = 0; r < REPEATS; r++) {
+            expected = sequentialFilter(tree, needle);
+        }
+        double sequentialMs = timer.elapsedMs() / REPEATS;
+        printf("  %-18s %-10s %8s %10.1f %8s %9zu\n", label, pattern, "iter", sequentialMs, "", expected.size());
+
+        for (size_t threads : counts) {
+            WorkStealingPool pool(threads - 1);
+            vector<int> found;
+            timer.reset();
+            for (int r = 0; r < REPEATS; r++) {
+                found = tree.parallelFilter(
+                    [needle](const string& key, int) { return string_view(key).find(needle) != string_view::npos; },
+                    pool);
+            }
+            double ms = timer.elapsedMs() / REPEATS;
+            if (found != expected) {
+                fprintf(stderr, "parallelFilter result differs from the sequential walk\n");
+                exit(1);
+            }
+            printf("  %-18s %-10s %8zu %10.1f %7.2fx %9zu\n", label, pattern, threads, ms, sequentialMs / ms,
+                   found.size());
+        }
+    }
+}
+
+vector<size_t> threadCounts() {
+    size_t cores = max(1u, thread::hardware_concurrency());
+    vector<size_t> counts;
+    for (size_t t = 1; t < cores; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(cores);
+    if (counts.size() == 1) {
+        counts.push_back(2);  // One core: still show the splitting overhead
+    }
+    return counts;
+}
+
+void run(size_t n) {
+    vector<pair<string, int>> sorted;
+    for (size_t i = 0; i < n; i++) {
+        sorted.emplace_back(keyOf(i), static_cast<int>(i));
+    }
+    sort(sorted.begin(), sorted.end());
+
+    unique_ptr<RedBlackTree<string, int>> rbt(new RedBlackTree<string, int>());
+    rbt->buildFromSorted(sorted.begin(), sorted.end());
+
+    vector<pair<string, int>> shuffled = sorted;
+    shuffle(shuffled.begin(), shuffled.end(), mt19937(42));
+    unique_ptr<BinarySearchTree<string, int>> bst(new BinarySearchTree<string, int>());
+    for (const pair<string, int>& entry : shuffled) {
+        bst->insert(entry.first, entry.second);
+    }
+
+    printf("\n%zu keys, %u cores, mean of %d runs\n", n, thread::hardware_concurrency(), REPEATS);
+    printf("  %-18s %-10s %8s %10s %8s %9s\n", "tree", "pattern", "threads", "ms", "speedup", "matches");
+    vector<size_t> counts = threadCounts();
+    runTree("RedBlackTree", *rbt, counts);
+    runTree("BinarySearchTree", *bst, counts);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {1000000});
+    for (size_t n : sizes) {
+        run(n);
+    }
+    return 0;
+}
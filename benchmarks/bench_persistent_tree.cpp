@@ -0,0 +1,322 @@
+// Locked trees vs persistent (path-copying) trees under mixed workloads.
+//
+// Part 0: buildFromSorted of the n base keys (the setup of the other parts,
+// untimed there), so a build that stops being linear shows up.
+//
+// Part 1: every thread runs the same 95/5 mix against one shared tree:
+// 95% find on a present key, 5% writes (insert or remove of a key outside
+// the base set, so the size stays near n). The locked contestants are
+// RedBlackTree / BinarySearchTree behind a shared_mutex (shared for finds,
+// exclusive for writes); the persistent ones read a snapshot with no lock
+// and serialize only writers. Throughput counts all operations over the
+// wall time of the run; it cannot scale past the core count printed at the
+// top, but the gap between the two kinds shows what the lock costs.
+//
+// Part 2: one thread does nothing but full in-order scans while another
+// writes. Behind the lock each scan holds the shared lock for its whole
+// length, so a write waits for the scan in flight; the persistent trees let
+// the writer publish while the scan walks its own version. On one core the
+// two threads only take turns, so the column to read there is "scans".
+//
+// Usage: bench_persistent_tree [keys ...]   (default 100000)
+
+#include "BenchUtil.h"
+#include "BinarySearchTree.h"
+#include "PersistentTree.h"
+#include "RedBlackTree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const size_t OPS_PER_THREAD = 100000;
+const size_t WRITE_PERCENT = 5;
+const size_t SCAN_WRITES = 20000;
+const size_t MAX_THREADS = 32;
+
+string keyOf(size_t i) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "contact%09zu", i);
+    return buffer;
+}
+
+// Tree behind a reader-writer lock, the shape the manager's indexes have
+template<typename Tree>
+class Locked {
+private:
+    Tree tree;
+    mutable shared_mutex lock;
+
+public:
+    bool find(const string& key) const {
+        shared_lock<shared_mutex> guard(lock);
+        return tree.find(key) != nullptr;
+    }
+
+    void insert(const string& key, int value) {
+        unique_lock<shared_mutex> guard(lock);
+        tree.insert(key, value);
+    }
+
+    void remove(const string& key) {
+        unique_lock<shared_mutex> guard(lock);
+        tree.remove(key);
+    }
+
+    size_t scan() const {
+        shared_lock<shared_mutex> guard(lock);
+        size_t count = 0;
+        for (auto it = tree.begin(); it != tree.end(); ++it) {
+            count++;
+        }
+        return count;
+    }
+
+    template<typename InputIt>
+    void build(InputIt first, InputIt last) {
+        tree.buildFromSorted(first, last);
+    }
+};
+
+// Persistent tree: readers take a snapshot, only writers lock (internally)
+template<typename Tree>
+class Lockless {
+private:
+    Tree tree;
+
+public:
+    bool find(const string& key) const {
+        typename Tree::Snapshot snapshot = tree.snapshot();
+        return snapshot.find(key) != nullptr;
+    }
+
+    void insert(const string& key, int value) { tree.insert(key, value); }
+
+    void remove(const string& key) { tree.remove(key); }
+
+    size_t scan() const {
+        typename Tree::Snapshot snapshot = tree.snapshot();
+        size_t count = 0;
+        for (auto it = snapshot.begin(); it != snapshot.end(); ++it) {
+            count++;
+        }
+        return count;
+    }
+
+    template<typename InputIt>
+    void build(InputIt first, InputIt last) {
+        tree.buildFromSorted(first, last);
+    }
+};
+
+// One thread's operations, generated before the clock starts. Writes use
+// keys from [n, 2n), alternating insert and remove per key.
+struct Ops {
+    vector<string> keys;
+    vector<char> isWrite;
+};
+
+Ops makeOps(size_t n, unsigned seed) {
+    Ops ops;
+    vector<size_t> picks = bench::randomIndexes(OPS_PER_THREAD, n, seed);
+    for (size_t i = 0; i < picks.size(); i++) {
+        bool write = picks[i] % 100 < WRITE_PERCENT;
+        ops.keys.push_back(keyOf(write ? n + picks[i] : picks[i]));
+        ops.isWrite.push_back(write);
+    }
+    return ops;
+}
+
+template<typename Tree>
+size_t runOps(Tree& tree, const Ops& ops) {
+    size_t hits = 0;
+    size_t writes = 0;
+    for (size_t i = 0; i < ops.keys.size(); i++) {
+        if (!ops.isWrite[i]) {
+            hits += tree.find(ops.keys[i]);
+        } else if (writes++ % 2 == 0) {
+            tree.insert(ops.keys[i], static_cast<int>(i));
+        } else {
+            tree.remove(ops.keys[i]);
+        }
+    }
+    return hits;
+}
+
+vector<pair<string, int>> sortedBase(size_t n) {
+    vector<pair<string, int>> sorted;
+    for (size_t i = 0; i < n; i++) {
+        sorted.emplace_back(keyOf(i), static_cast<int>(i));
+    }
+    return sorted;
+}
+
+template<typename Tree>
+void buildBase(Tree& tree, size_t n) {
+    vector<pair<string, int>> sorted = sortedBase(n);
+    tree.build(make_move_iterator(sorted.begin()), make_move_iterator(sorted.end()));
+}
+
+// Keys are built before the clock starts; ns per key
+template<typename Tree>
+double measureBuild(size_t n) {
+    vector<pair<string, int>> sorted = sortedBase(n);
+    Tree tree;
+    bench::Stopwatch timer;
+    tree.build(make_move_iterator(sorted.begin()), make_move_iterator(sorted.end()));
+    return timer.elapsedNs() / double(n);
+}
+
+template<typename Tree>
+double measureMix(size_t n, size_t threads, const vector<Ops>& ops) {
+    Tree tree;
+    buildBase(tree, n);
+
+    atomic<bool> go(false);
+    atomic<size_t> hits(0);
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            while (!go.load()) {
+                this_thread::yield();
+            }
+            hits += runOps(tree, ops[t]);
+        });
+    }
+
+    bench::Stopwatch timer;
+    go = true;
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = timer.elapsedNs() / 1e9;
+    bench::doNotOptimize(hits.load());
+    return double(OPS_PER_THREAD * threads) / seconds;
+}
+
+struct ScanResult {
+    double writesPerSecond;
+    double maxWriteUs;
+    size_t scans;
+};
+
+// One scanner, one writer; the writer's time per write is what a scan costs it
+template<typename Tree>
+ScanResult measureScan(size_t n) {
+    Tree tree;
+    buildBase(tree, n);
+
+    atomic<bool> stop(false);
+    atomic<bool> scanning(false);
+    size_t scans = 0;
+    thread scanner([&] {
+        size_t seen = 0;
+        while (!stop.load(memory_order_relaxed)) {
+            seen += tree.scan();
+            scans++;
+            scanning = true;
+        }
+        bench::doNotOptimize(seen);
+    });
+    while (!scanning.load()) {
+        this_thread::yield();
+    }
+
+    double maxNs = 0;
+    bench::Stopwatch total;
+    for (size_t i = 0; i < SCAN_WRITES; i++) {
+        string key = keyOf(n + i / 2);
+        bench::Stopwatch one;
+        if (i % 2 == 0) {
+            tree.insert(key, static_cast<int>(i));
+        } else {
+            tree.remove(key);
+        }
+        maxNs = max(maxNs, one.elapsedNs());
+    }
+    double seconds = total.elapsedNs() / 1e9;
+    stop = true;
+    scanner.join();
+    return ScanResult{SCAN_WRITES / seconds, maxNs / 1e3, scans};
+}
+
+template<typename Tree>
+void printMixRow(const char* label, size_t n, const vector<size_t>& counts, const vector<Ops>& ops) {
+    printf("  %-26s", label);
+    for (size_t threads : counts) {
+        printf(" %10.0f", measureMix<Tree>(n, threads, ops));
+    }
+    printf("\n");
+}
+
+template<typename Tree>
+void printBuildRow(const char* label, size_t n) {
+    printf("  %-26s %12.1f\n", label, measureBuild<Tree>(n));
+}
+
+template<typename Tree>
+void printScanRow(const char* label, size_t n) {
+    ScanResult r = measureScan<Tree>(n);
+    printf("  %-26s %12.0f %14.1f %8zu\n", label, r.writesPerSecond, r.maxWriteUs, r.scans);
+}
+
+typedef RedBlackTree<string, int> RBT;
+typedef BinarySearchTree<string, int> BST;
+typedef PersistentRedBlackTree<string, int> PRBT;
+typedef PersistentBinarySearchTree<string, int> PBST;
+
+void run(size_t n) {
+    vector<size_t> counts;
+    for (size_t t = 1; t <= MAX_THREADS; t *= 2) {
+        counts.push_back(t);
+    }
+    vector<Ops> ops;
+    for (size_t t = 0; t < MAX_THREADS; t++) {
+        ops.push_back(makeOps(n, static_cast<unsigned>(t + 1)));
+    }
+
+    printf("\n%zu keys, buildFromSorted\n", n);
+    printf("  %-26s %12s\n", "", "ns/key");
+    printBuildRow<Locked<RBT>>("RedBlackTree", n);
+    printBuildRow<Lockless<PRBT>>("PersistentRedBlackTree", n);
+    printBuildRow<Locked<BST>>("BinarySearchTree", n);
+    printBuildRow<Lockless<PBST>>("PersistentBinarySearchTree", n);
+
+    printf("\n%zu keys, %u cores, %zu ops per thread, %zu%% writes\n", n, thread::hardware_concurrency(),
+           OPS_PER_THREAD, WRITE_PERCENT);
+    printf("  %-26s", "ops/s by threads");
+    for (size_t threads : counts) {
+        printf(" %10zu", threads);
+    }
+    printf("\n");
+    printMixRow<Locked<RBT>>("RedBlackTree + lock", n, counts, ops);
+    printMixRow<Lockless<PRBT>>("PersistentRedBlackTree", n, counts, ops);
+    printMixRow<Locked<BST>>("BinarySearchTree + lock", n, counts, ops);
+    printMixRow<Lockless<PBST>>("PersistentBinarySearchTree", n, counts, ops);
+
+    printf("\n  1 scanning thread, 1 writer (%zu writes)\n", SCAN_WRITES);
+    printf("  %-26s %12s %14s %8s\n", "", "writes/s", "max write us", "scans");
+    printScanRow<Locked<RBT>>("RedBlackTree + lock", n);
+    printScanRow<Lockless<PRBT>>("PersistentRedBlackTree", n);
+    printScanRow<Locked<BST>>("BinarySearchTree + lock", n);
+    printScanRow<Lockless<PBST>>("PersistentBinarySearchTree", n);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {100000});
+    for (size_t n : sizes) {
+        run(n);
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+// PackedPhoneIndex vs the red-black phone index.
+//
+// Phone numbers are at most 11 ASCII digits (isPhoneNumberValid), so the
+// packed index keeps each one as a 64-bit key in a BTree (four bits per
+// digit). Compared against:
+//   RedBlackTree key     the manager's former contactsByPhoneDigits: key
+//                        digits + '\0' + number (21 bytes, heap-allocated)
+//   RedBlackTree digits  the same tree keyed by the bare digits (inline)
+//
+// Per structure:
+//   insert    ns per insert of n shuffled numbers
+//   bytes     heap bytes per number (glibc in-use bytes)
+//   find      ns per exact lookup from the query string, all hit
+//   prefix    ns per 6-digit prefix query collecting up to 10 numbers
+// then "contains digits" queries (searchByPhone): ms per query for a
+// 2-digit and a 4-digit pattern over every number, with the matches found.
+// The trees scan each key string; the packed index compares packed keys;
+// NGramIndex is the trigram path (intersect posting lists, verify each
+// candidate), which needs at least 3 digits.
+//
+// Usage: bench_phone_index [size ...]   (default 10k 100k 1M)
+
+#include "BenchUtil.h"
+#include "NGramIndex.h"
+#include "PackedPhoneIndex.h"
+#include "RedBlackTree.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+struct Contact;
+
+const size_t CONTAINS_QUERIES = 20;
+
+string phoneFor(size_t i) {
+    return "09" + to_string(10000000 + i * 7919 % 90000000);
+}
+
+// digits + '\0' + original, as the manager keyed its RedBlackTree
+string managerKey(const string& phone) {
+    string key = phone;
+    key.push_back('\0');
+    key += phone;
+    return key;
+}
+
+long long heapInUse() {
+#if defined(__GLIBC__)
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<long long>(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+Contact* valueOf(size_t i) {
+    return reinterpret_cast<Contact*>(i + 1);
+}
+
+struct Queries {
+    vector<size_t> finds;
+    vector<string> prefixes;
+    vector<string> twoDigits, fourDigits;
+};
+
+void printRow(const char* label, double insertNs, double bytes, double findNs, double prefixNs) {
+    printf("  %-22s %10.0f %10.1f %10.0f %10.0f\n", label, insertNs, bytes, findNs, prefixNs);
+}
+
+void printContains(const char* label, double twoMs, size_t twoFound, double fourMs, size_t fourFound) {
+    printf("  %-22s %12.3f %10zu %12.3f %10zu\n", label, twoMs, twoFound, fourMs, fourFound);
+}
+
+template<typename Fn>
+double msPerQuery(const vector<string>& patterns, size_t& found, Fn query) {
+    found = 0;
+    bench::Stopwatch timer;
+    for (const string& pattern : patterns) {
+        found += query(pattern);
+    }
+    return timer.elapsedMs() / patterns.size();
+}
+
+// Tree keyed by string: keyOf turns a number into its key
+void measureTree(const char* label, const vector<string>& phones, const Queries& q, string (*keyOf)(const string&),
+                 double containsMs[2], size_t containsFound[2]) {
+    long long before = heapInUse();
+    RedBlackTree<string, Contact*>* tree = new RedBlackTree<string, Contact*>();
+    bench::Stopwatch timer;
+    for (size_t i = 0; i < phones.size(); i++) {
+        tree->insert(keyOf(phones[i]), valueOf(i));
+    }
+    double insertNs = timer.elapsedNs() / phones.size();
+    double bytes = double(heapInUse() - before) / phones.size();
+
+    size_t hits = 0;
+    timer.reset();
+    for (size_t i : q.finds) {
+        hits += tree->find(keyOf(phones[i])) != nullptr;
+    }
+    double findNs = timer.elapsedNs() / q.finds.size();
+
+    size_t collected = 0;
+    timer.reset();
+    for (const string& prefix : q.prefixes) {
+        auto range = tree->prefixRange(prefix);
+        size_t taken = 0;
+        for (auto it = range.begin(); taken < 10 && it != range.end(); ++it, ++taken) {
+            bench::doNotOptimize((*it).second);
+        }
+        collected += taken;
+    }
+    double prefixNs = timer.elapsedNs() / q.prefixes.size();
+    bench::doNotOptimize(hits + collected);
+    printRow(label, insertNs, bytes, findNs, prefixNs);
+
+    // Only the digits before a '\0' are the number
+    auto scan = [&](const string& pattern) {
+        size_t matches = 0;
+        for (const auto& entry : *tree) {
+            size_t end = entry.first.find('\0');
+            size_t at = entry.first.find(pattern);
+            matches += at != string::npos && at + pattern.size() <= end;
+        }
+        return matches;
+    };
+    containsMs[0] = msPerQuery(q.twoDigits, containsFound[0], scan);
+    containsMs[1] = msPerQuery(q.fourDigits, containsFound[1], scan);
+    delete tree;
+}
+
+void run(size_t n) {
+    vector<string> phones;
+    for (size_t i = 0; i < n; i++) {
+        phones.push_back(phoneFor(i));
+    }
+    shuffle(phones.begin(), phones.end(), mt19937_64(3));
+
+    Queries q;
+    q.finds = bench::randomIndexes(1000000, n);
+    for (size_t k = 0; k < 100000; k++) {
+        q.prefixes.push_back(phones[q.finds[k]].substr(0, 6));
+    }
+    mt19937_64 rng(7);
+    for (size_t k = 0; k < CONTAINS_QUERIES; k++) {
+        q.twoDigits.push_back(to_string(10 + rng() % 90));
+        q.fourDigits.push_back(to_string(1000 + rng() % 9000));
+    }
+
+    printf("\n%zu phone numbers\n", n);
+    printf("  %-22s %10s %10s %10s %10s\n", "index", "insert ns", "bytes", "find ns", "prefix ns");
+
+    double treeMs[2][2];
+    size_t treeFound[2][2];
+    measureTree("RedBlackTree key", phones, q, managerKey, treeMs[0], treeFound[0]);
+    measureTree("RedBlackTree digits", phones, q, [](const string& phone) { return phone; }, treeMs[1], treeFound[1]);
+
+    long long before = heapInUse();
+    PackedPhoneIndex<Contact*>* packed = new PackedPhoneIndex<Contact*>();
+    bench::Stopwatch timer;
+    for (size_t i = 0; i < n; i++) {
+        packed->insert(phones[i], valueOf(i));
+    }
+    double insertNs = timer.elapsedNs() / n;
+    double bytes = double(heapInUse() - before) / n;
+
+    size_t hits = 0;
+    timer.reset();
+    for (size_t i : q.finds) {
+        hits += packed->find(phones[i]) != nullptr;
+    }
+    double findNs = timer.elapsedNs() / q.finds.size();
+
+    size_t collected = 0;
+    timer.reset();
+    for (const string& prefix : q.prefixes) {
+        auto range = packed->prefixRange(prefix);
+        size_t taken = 0;
+        for (auto it = range.begin(); taken < 10 && it != range.end(); ++it, ++taken) {
+            bench::doNotOptimize((*it).second);
+        }
+        collected += taken;
+    }
+    double prefixNs = timer.elapsedNs() / q.prefixes.size();
+    bench::doNotOptimize(hits + collected);
+    printRow("PackedPhoneIndex", insertNs, bytes, findNs, prefixNs);
+
+    auto packedScan = [&](const string& pattern) {
+        size_t matches = 0;
+        packed->forEachContaining(pattern, [&](Contact*) { matches++; });
+        return matches;
+    };
+    double packedMs[2];
+    size_t packedFound[2];
+    packedMs[0] = msPerQuery(q.twoDigits, packedFound[0], packedScan);
+    packedMs[1] = msPerQuery(q.fourDigits, packedFound[1], packedScan);
+
+    NGramIndex grams;
+    for (size_t i = 0; i < n; i++) {
+        grams.add(static_cast<int>(i), phones[i]);
+    }
+    vector<int> ids;
+    size_t gramFound;
+    double gramMs = msPerQuery(q.fourDigits, gramFound, [&](const string& pattern) {
+        size_t matches = 0;
+        grams.candidates(pattern, ids);
+        for (int id : ids) {
+            matches += phones[id].find(pattern) != string::npos;
+        }
+        return matches;
+    });
+
+    printf("  %-22s %12s %10s %12s %10s\n", "contains digits", "2-digit ms", "found", "4-digit ms", "found");
+    printContains("RedBlackTree key", treeMs[0][0], treeFound[0][0], treeMs[0][1], treeFound[0][1]);
+    printContains("RedBlackTree digits", treeMs[1][0], treeFound[1][0], treeMs[1][1], treeFound[1][1]);
+    printContains("PackedPhoneIndex", packedMs[0], packedFound[0], packedMs[1], packedFound[1]);
+    printf("  %-22s %12s %10s %12.3f %10zu\n", "NGramIndex", "-", "-", gramMs, gramFound);
+    delete packed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {10000, 100000, 1000000});
+    for (size_t n : sizes) {
+        run(n);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Prefix (autocomplete) queries: ordered range scan vs full substring scan.
+//
+// searchByName / searchByPhone visit every key; searchByNamePrefix /
+// searchByPhonePrefix seek to lower_bound(prefix) in the normalized index
+// and stop at the first key past the prefix, so cost is O(log n + k).
+//
+// Usage: bench_prefix_search [size ...]   (default 100k; try 1000000)
+
+#include "BenchUtil.h"
+#include "ContactManager.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+const char* const FAMILY_NAMES[] = {"Nguyen", "Tran", "Le", "Pham", "Hoang", "Phan", "Vu", "Dang", "Bui", "Do"};
+const char* const MIDDLE_NAMES[] = {"Van", "Thi", "Minh", "Duc", "Ngoc", "Thanh", "Quoc", "Hai"};
+const char* const PHONE_PREFIXES[] = {"0903", "0912", "0987", "0368", "0779", "0856"};
+
+template<typename Fn>
+double microsPerQuery(int repeats, Fn fn) {
+    bench::Stopwatch timer;
+    size_t total = 0;
+    for (int i = 0; i < repeats; i++) {
+        total += fn();
+    }
+    bench::doNotOptimize(total);
+    return timer.elapsedNs() / repeats / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {100000});
+    ContactManager* manager = ContactManager::getInstance();
+
+    for (size_t n : sizes) {
+        {
+            bench::SilenceStdout quiet;
+            manager->clearAll();
+            for (size_t i = 0; i < n; i++) {
+                string name = string(FAMILY_NAMES[i % 10]) + " " + MIDDLE_NAMES[(i / 10) % 8] + " " + to_string(i);
+                manager->addContact(name);
+                Contact* contact = manager->findContact(name);
+                string phone = string(PHONE_PREFIXES[(i * 7) % 6]) + to_string(100000 + (i * 7919) % 900000);
+                manager->setContactPhone(contact, phone);
+            }
+        }
+
+        printf("%zu contacts\n", n);
+        printf("  %-22s %8s %16s %16s\n", "query", "matches", "full scan us", "prefix us");
+
+        const char* nameQueries[] = {"nguyen", "nguyen van", "nguyen van 1", "nguyen van 1234"};
+        for (const char* query : nameQueries) {
+            size_t matches = manager->searchByNamePrefix(query).size();
+            double scanUs = microsPerQuery(3, [&]() {
+                // Full-scan equivalent: substring search then keep the prefixes
+                size_t count = 0;
+                for (Contact* contact : manager->searchByName(query)) {
+                    count += ContactManager::normalizeName(contact->getName()).compare(0, strlen(query), query) == 0;
+                }
+                return count;
+            });
+            double prefixUs = microsPerQuery(20, [&]() { return manager->searchByNamePrefix(query).size(); });
+            printf("  name \"%-16s %8zu %16.1f %16.1f\n", (string(query) + "\"").c_str(), matches, scanUs, prefixUs);
+        }
+
+        const char* phoneQueries[] = {"09", "0903", "0903-12", "0903 123 4"};
+        for (const char* query : phoneQueries) {
+            size_t matches = manager->searchByPhonePrefix(query).size();
+            double scanUs = microsPerQuery(3, [&]() { return manager->searchByPhone(query).size(); });
+            double prefixUs = microsPerQuery(20, [&]() { return manager->searchByPhonePrefix(query).size(); });
+            printf("  phone \"%-15s %8zu %16.1f %16.1f\n", (string(query) + "\"").c_str(), matches, scanUs, prefixUs);
+        }
+
+        bench::SilenceStdout quiet;
+        manager->clearAll();
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Heap allocations and time of a full index scan.
+//
+// The old search path materialized getAllPairs() (one vector plus a copy
+// of every key) and then made a lowercase copy of each key. Searches now
+// stream the trees through iterators and compare in place, so a scan that
+// matches nothing should perform zero allocations besides the lowercase
+// copy of the query itself.
+//
+// Usage: bench_scan_alloc [size ...]   (default 100k; try 1000000)
+
+#include "BenchUtil.h"
+#include "AllocCounter.h"
+#include "ContactManager.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+namespace {
+
+struct ScanResult {
+    size_t allocations;
+    double ms;
+};
+
+template<typename Fn>
+ScanResult measure(Fn fn) {
+    size_t before = bench::allocationCount();
+    bench::Stopwatch timer;
+    fn();
+    return ScanResult{bench::allocationCount() - before, timer.elapsedMs()};
+}
+
+void report(const char* label, const ScanResult& result) {
+    printf("  %-34s %12zu allocs %10.2f ms\n", label, result.allocations, result.ms);
+}
+
+// The pre-iterator searchByName body, kept for comparison
+size_t oldStyleNameScan(const BinarySearchTree<string, Contact*>& index, const string& lowerName) {
+    size_t matches = 0;
+    vector<pair<string, Contact*>> allPairs = index.getAllPairs();
+    for (const auto& pair : allPairs) {
+        string contactName = pair.first;
+        string lowerContactName = contactName;
+        transform(lowerContactName.begin(), lowerContactName.end(), lowerContactName.begin(), ::tolower);
+        matches += lowerContactName.find(lowerName) != string::npos;
+    }
+    return matches;
+}
+
+size_t iteratorNameScan(const BinarySearchTree<string, Contact*>& index, const string& lowerName) {
+    size_t matches = 0;
+    for (const auto& entry : index) {
+        matches += entry.first.find(lowerName) != string::npos;
+    }
+    return matches;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {100000});
+    ContactManager* manager = ContactManager::getInstance();
+
+    for (size_t n : sizes) {
+        BinarySearchTree<string, Contact*> nameIndex;
+        {
+            bench::SilenceStdout quiet;
+            manager->clearAll();
+            for (size_t i = 0; i < n; i++) {
+                string name = "Nguyen Van " + to_string((i * 2654435761u) % 4294967291u) + "-" + to_string(i);
+                manager->addContact(name);
+                Contact* contact = manager->findContact(name);
+                manager->setContactPhone(contact, "09" + to_string(10000000 + i));
+                manager->setContactEmail(contact, "user" + to_string(i) + "@example.com");
+                nameIndex.insert(name, contact);
+            }
+        }
+
+        printf("%zu contacts, query matching nothing\n", n);
+        report("tree: getAllPairs + lowercase copy", measure([&]() { bench::doNotOptimize(oldStyleNameScan(nameIndex, "zzz")); }));
+        report("tree: iterator walk", measure([&]() { bench::doNotOptimize(iteratorNameScan(nameIndex, "zzz")); }));
+        report("ContactManager::searchByName", measure([&]() { bench::doNotOptimize(manager->searchByName("zzz").size()); }));
+        report("ContactManager::searchByPhone", measure([&]() { bench::doNotOptimize(manager->searchByPhone("1-2-3-4-5-6-7-8").size()); }));
+        report("ContactManager::searchByEmail", measure([&]() { bench::doNotOptimize(manager->searchByEmail("zzz").size()); }));
+
+        bench::SilenceStdout quiet;
+        manager->clearAll();
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+// Write throughput of ShardedContactManager as shards and writer threads are added.
+//
+// Writer threads insert disjoint slices of the same contact list:
+//   add        addContact(name)
+//   add+set    addContact + findContact(name) + setContactPhone + setContactEmail
+// Every call checks uniqueness across all shards (names, phones and emails
+// live in striped UniqueKeyTables). Throughput counts contacts written over
+// the wall time of the whole run, manager construction excluded.
+// The first rows are ConcurrentContactManager: one reader-writer lock over
+// every index, the configuration the shards are meant to replace. Extra
+// writer threads can only help once there are cores to run them on; the
+// core count is printed at the top.
+//
+// Usage: bench_sharded_writes [contacts ...]   (default 200k)
+
+#include "BenchUtil.h"
+#include "ContactManager.h"
+#include "ShardedContactManager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const FAMILY[] = {"Nguyễn", "Trần", "Lê", "Phạm", "Hoàng", "Phan", "Vũ", "Đặng", "Bùi", "Đỗ"};
+const char* const MIDDLE[] = {"Văn", "Thị", "Minh", "Ngọc", "Đức", "Thanh", "Quốc", "Hồng"};
+
+const size_t SHARD_COUNTS[] = {1, 4, 16, 64};
+
+string nameOf(size_t i) {
+    return string(FAMILY[i % 10]) + " " + MIDDLE[i / 10 % 8] + " " + to_string(i);
+}
+
+string phoneOf(size_t i) {
+    return "09" + to_string(10000000 + i);
+}
+
+string emailOf(size_t i) {
+    return "contact" + to_string(i) + "@example.vn";
+}
+
+// Keys generated before the clock starts
+struct Keys {
+    vector<string> names;
+    vector<string> phones;
+    vector<string> emails;
+};
+
+Keys makeKeys(size_t n) {
+    Keys keys;
+    for (size_t i = 0; i < n; i++) {
+        keys.names.push_back(nameOf(i));
+        keys.phones.push_back(phoneOf(i));
+        keys.emails.push_back(emailOf(i));
+    }
+    return keys;
+}
+
+// Writes contacts [begin, end); returns how many were added
+template<typename Manager>
+size_t runWriter(Manager* manager, const Keys& keys, size_t begin, size_t end, bool withFields) {
+    size_t added = 0;
+    for (size_t i = begin; i < end; i++) {
+        if (!manager->addContact(keys.names[i])) {
+            continue;
+        }
+        added++;
+        if (withFields) {
+            Contact* contact = manager->findContact(keys.names[i]);
+            manager->setContactPhone(contact, keys.phones[i]);
+            manager->setContactEmail(contact, keys.emails[i]);
+        }
+    }
+    return added;
+}
+
+template<typename Manager>
+double measure(Manager* manager, const Keys& keys, size_t threads, bool withFields) {
+    size_t n = keys.names.size();
+    atomic<bool> go(false);
+    atomic<size_t> added(0);
+    vector<thread> writers;
+    for (size_t t = 0; t < threads; t++) {
+        writers.emplace_back([&, t] {
+            while (!go.load()) {
+                this_thread::yield();
+            }
+            added += runWriter(manager, keys, n * t / threads, n * (t + 1) / threads, withFields);
+        });
+    }
+
+    bench::Stopwatch timer;
+    go = true;
+    for (thread& writer : writers) {
+        writer.join();
+    }
+    double seconds = timer.elapsedNs() / 1e9;
+    if (added.load() != n) {
+        fprintf(stderr, "expected %zu contacts, added %zu\n", n, added.load());
+    }
+    return n / seconds;
+}
+
+vector<size_t> threadCounts() {
+    size_t cores = max(1u, thread::hardware_concurrency());
+    vector<size_t> counts;
+    for (size_t t = 1; t < cores; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(cores);
+    if (counts.size() == 1) {
+        counts.push_back(2);  // One core: still show two writers competing
+    }
+    return counts;
+}
+
+void run(size_t n) {
+    Keys keys = makeKeys(n);
+    vector<size_t> counts = threadCounts();
+
+    printf("\n%zu contacts, %u cores\n", n, thread::hardware_concurrency());
+    printf("  %-24s %8s %8s %14s %8s\n", "manager", "shards", "writers", "contacts/s", "speedup");
+
+    for (int mix = 0; mix < 2; mix++) {
+        bool withFields = mix == 1;
+        const char* label = withFields ? "add+set" : "add";
+
+        ConcurrentContactManager* single = ConcurrentContactManager::getInstance();
+        double baseline = 0;
+        for (size_t threads : counts) {
+            double rate;
+            {
+                bench::SilenceStdout quiet;
+                rate = measure(single, keys, threads, withFields);
+                single->clearAll();
+            }
+            if (threads == 1) {
+                baseline = rate;
+            }
+            printf("  %-24s %8s %8zu %14.0f %7.2fx  %s\n", "Concurrent", "-", threads, rate, rate / baseline, label);
+        }
+
+        for (size_t shards : SHARD_COUNTS) {
+            for (size_t threads : counts) {
+                double rate;
+                {
+                    bench::SilenceStdout quiet;
+                    ShardedContactManager manager(shards);
+                    rate = measure(&manager, keys, threads, withFields);
+                }
+                printf("  %-24s %8zu %8zu %14.0f %7.2fx  %s\n", "Sharded", shards, threads, rate, rate / baseline,
+                       label);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {200000});
+    for (size_t n : sizes) {
+        run(n);
+    }
+    return 0;
+}
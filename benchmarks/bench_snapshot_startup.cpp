@@ -0,0 +1,131 @@
+// Startup cost: loading a binary snapshot vs rebuilding by re-adding contacts.
+//
+// The snapshot stores records in ID order plus each tree index as a run of
+// record positions already in key order, so loadSnapshot maps the file and
+// bulk-builds every tree in O(n) with buildFromSorted instead of n
+// O(log n) inserts with rebalancing.
+//
+// "cold" drops the file from the page cache first (posix_fadvise), which
+// only approximates a cold start: the kernel may keep pages it cannot drop.
+//
+// Usage: bench_snapshot_startup [size ...]   (default 100k; try 1000000)
+
+#include "BenchUtil.h"
+#include "ContactManager.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char* const FAMILY_NAMES[] = {"Nguyen", "Tran", "Le", "Pham", "Hoang", "Phan", "Vu", "Dang", "Bui", "Do"};
+const char* const MIDDLE_NAMES[] = {"Van", "Thi", "Minh", "Duc", "Ngoc", "Thanh", "Quoc", "Hai"};
+const char* const PHONE_PREFIXES[] = {"0903", "0912", "0987", "0368", "0779", "0856"};
+
+struct Row {
+    string name;
+    string phone;
+    string email;
+    string address;
+};
+
+vector<Row> makeRows(size_t n) {
+    vector<Row> rows(n);
+    for (size_t i = 0; i < n; i++) {
+        rows[i].name = string(FAMILY_NAMES[i % 10]) + " " + MIDDLE_NAMES[(i / 10) % 8] + " " + to_string(i);
+        rows[i].phone = string(PHONE_PREFIXES[(i * 7) % 6]) + to_string(1000000 + i);
+        rows[i].email = "user" + to_string(i) + "@example.vn";
+        rows[i].address = to_string(i % 500) + " Le Loi, Quan 1";
+    }
+    return rows;
+}
+
+void addAll(ContactManager* manager, const vector<Row>& rows) {
+    for (const Row& row : rows) {
+        manager->addContact(row.name);
+        Contact* contact = manager->findContact(row.name);
+        manager->setContactPhone(contact, row.phone);
+        manager->setContactEmail(contact, row.email);
+        contact->setAddress(row.address);
+    }
+}
+
+void dropFromPageCache(const string& path) {
+#if !defined(_WIN32) && defined(POSIX_FADV_DONTNEED)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+long fileSize(const string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {100000});
+    ContactManager* manager = ContactManager::getInstance();
+    const string path = "bench_startup.snapshot";
+
+    printf("%10s %12s %14s %12s %12s %12s\n", "contacts", "file KiB", "re-add ms", "save ms", "load ms", "cold ms");
+    for (size_t n : sizes) {
+        vector<Row> rows = makeRows(n);
+        double addMs, saveMs, loadMs, coldMs;
+        bool ok = true;
+        {
+            bench::SilenceStdout quiet;
+            manager->clearAll();
+            bench::Stopwatch timer;
+            addAll(manager, rows);
+            addMs = timer.elapsedMs();
+
+            timer.reset();
+            ok = ok && manager->saveSnapshot(path);
+            saveMs = timer.elapsedMs();
+
+            timer.reset();
+            ok = ok && manager->loadSnapshot(path);
+            loadMs = timer.elapsedMs();
+
+            dropFromPageCache(path);
+            timer.reset();
+            ok = ok && manager->loadSnapshot(path);
+            coldMs = timer.elapsedMs();
+        }
+
+        if (!ok || static_cast<size_t>(manager->getTotalContacts()) != n) {
+            fprintf(stderr, "snapshot round trip failed for %zu contacts\n", n);
+            remove(path.c_str());
+            return 1;
+        }
+        printf("%10zu %12ld %14.1f %12.1f %12.1f %12.1f\n", n, fileSize(path) / 1024, addMs, saveMs, loadMs, coldMs);
+    }
+
+    remove(path.c_str());
+    {
+        bench::SilenceStdout quiet;
+        manager->clearAll();
+    }
+    return 0;
+}
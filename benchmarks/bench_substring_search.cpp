@@ -0,0 +1,154 @@
+// Case-insensitive substring search over a column of stored values.
+//
+// Compared here, each over every value of a column laid out back to back
+// like ContactStore's arena:
+//   lowercase copy   copy + transform(::tolower) + string::find per value
+//   byte loop        the manager's former in-place loop (tolower per byte)
+//   scalar           bench::findIgnoreCaseScalar (SimdSearch.h)
+//   SIMD             bench::findIgnoreCase, SSE2/AVX2 picked at run time
+//                    (name shown); no folded key needed, not in the library
+//   folded key       string_view::find over the TextSearch::foldKey column,
+//                    what searchByName / searchByEmail now do (the keys are
+//                    written with the value, so folding is not timed)
+// GB/s counts the column bytes scanned per second, averaged over the
+// patterns; "found" is the number of matching values over all patterns
+// and must be the same in every row.
+//
+// Usage: bench_substring_search [values ...]   (default 1M)
+
+#include "BenchUtil.h"
+#include "SimdSearch.h"
+#include "TextSearch.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Column {
+    string arena;
+    vector<size_t> offsets;  // value i is [offsets[i], offsets[i + 1])
+
+    void add(const string& value) {
+        if (offsets.empty()) {
+            offsets.push_back(0);
+        }
+        arena += value;
+        offsets.push_back(arena.size());
+    }
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    string_view at(size_t i) const {
+        return string_view(arena.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
+const char* const FAMILY[] = {"Nguyen", "Tran", "Le", "Pham", "Hoang", "Phan", "Vu", "Dang", "Bui", "Do"};
+const char* const MIDDLE[] = {"Van", "Thi", "Minh", "Ngoc", "Duc", "Thanh", "Quoc", "Hong"};
+const char* const GIVEN[] = {"An", "Binh", "Chau", "Dung", "Giang", "Hai", "Khanh", "Linh", "Nam", "Trang"};
+
+string randomName(mt19937_64& rng) {
+    return string(FAMILY[rng() % 10]) + " " + MIDDLE[rng() % 8] + " " + GIVEN[rng() % 10] + " " + to_string(rng() % 1000);
+}
+
+string randomEmail(mt19937_64& rng) {
+    static const char* const domains[] = {"Gmail.com", "example.vn", "Yahoo.com", "hcmus.edu.vn"};
+    return string(GIVEN[rng() % 10]) + "." + FAMILY[rng() % 10] + to_string(rng() % 100000) + "@" + domains[rng() % 4];
+}
+
+// Long free text, like the notes field
+string randomNote(mt19937_64& rng) {
+    string note;
+    while (note.size() < 200) {
+        note += randomName(rng);
+        note += rng() % 2 ? ", gap lai tai Ha Noi. " : "; Goi Lai Sau. ";
+    }
+    return note;
+}
+
+bool lowercaseCopy(string_view text, const string& pattern) {
+    string lower(text);
+    transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower.find(pattern) != string::npos;
+}
+
+bool byteLoop(string_view text, const string& pattern) {
+    if (pattern.size() > text.size()) {
+        return false;
+    }
+    size_t last = text.size() - pattern.size();
+    for (size_t start = 0; start <= last; start++) {
+        size_t i = 0;
+        while (i < pattern.size() &&
+               tolower(static_cast<unsigned char>(text[start + i])) == static_cast<unsigned char>(pattern[i])) {
+            i++;
+        }
+        if (i == pattern.size()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename Fn>
+void measure(const char* label, const Column& column, const vector<string>& patterns, Fn contains) {
+    size_t found = 0;
+    bench::Stopwatch timer;
+    for (const string& pattern : patterns) {
+        for (size_t i = 0; i < column.size(); i++) {
+            found += contains(column.at(i), pattern);
+        }
+    }
+    double seconds = timer.elapsedNs() / 1e9;
+    double gbPerSecond = double(column.arena.size()) * patterns.size() / seconds / 1e9;
+    printf("  %-22s %10.2f %12zu\n", label, gbPerSecond, found);
+}
+
+void run(const char* kind, size_t n, string (*generate)(mt19937_64&), const vector<string>& patterns) {
+    mt19937_64 rng(5);
+    Column column;
+    Column keys;
+    for (size_t i = 0; i < n; i++) {
+        string value = generate(rng);
+        column.add(value);
+        keys.add(TextSearch::foldKey(value));
+    }
+
+    printf("\n%zu %s, %.1f bytes each, %zu patterns\n", n, kind, double(column.arena.size()) / n, patterns.size());
+    printf("  %-22s %10s %12s\n", "matcher", "GB/s", "found");
+    measure("lowercase copy", column, patterns, lowercaseCopy);
+    measure("byte loop", column, patterns, byteLoop);
+    measure("scalar", column, patterns, [](string_view text, const string& pattern) {
+        return bench::findIgnoreCaseScalar(text, pattern) != string_view::npos;
+    });
+    string label = string("SIMD (") + bench::findKernelName() + ")";
+    measure(label.c_str(), column, patterns, [](string_view text, const string& pattern) {
+        return bench::findIgnoreCase(text, pattern) != string_view::npos;
+    });
+    measure("folded key", keys, patterns, [](string_view key, const string& pattern) {
+        return key.find(pattern) != string_view::npos;
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {1000000});
+    // Short patterns (the column-scan path), trigram verifications, misses
+    vector<string> namePatterns = {"n", "an", "thi", "nguyen", "van linh", "xyz", "hoang minh nam"};
+    vector<string> emailPatterns = {"@", "vn", "gmail", "linh.tran", "hcmus.edu", "qqq"};
+    vector<string> notePatterns = {"ha noi", "goi lai", "nguyen thi linh", "zz"};
+    for (size_t n : sizes) {
+        run("names", n, randomName, namePatterns);
+        run("e-mails", n, randomEmail, emailPatterns);
+        run("notes", max<size_t>(n / 10, 1), randomNote, notePatterns);
+    }
+    return 0;
+}
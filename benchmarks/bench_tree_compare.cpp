@@ -0,0 +1,172 @@
+// Key comparisons per tree operation: two-way vs three-way descent.
+//
+// With only a less-than, a descent has to ask comp(key, node) and then
+// comp(node, key) before it knows whether to go left, go right or stop, so
+// most nodes cost two string comparisons. compareKeys (KeyCompare.h) gives
+// the trees one three-way comparison per node: through a comparator's
+// compare() member, or string_view::compare for std::less on strings.
+//
+// Keys are realistic and share long prefixes, which is what makes each
+// string comparison expensive: Vietnamese full names in UTF-8 ("Nguyễn Thị
+// Thu Hương 1234") and the matching e-mail addresses.
+//
+// Part 1 counts comparator calls per insert / find hit / find miss with a
+// counting comparator that exposes only operator() (two-way) and one that
+// also has compare() (three-way).
+// Part 2 times find on plain string keys: a less-than-only comparator vs
+// the default std::less<string>, which now takes the three-way path.
+//
+// Usage: bench_tree_compare [keys] [lookups]   (defaults 100000 1000000)
+
+#include "BenchUtil.h"
+#include "BinarySearchTree.h"
+#include "RedBlackTree.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+size_t comparisons = 0;
+
+// Only operator(): the trees fall back to two calls per node
+struct CountingLess {
+    bool operator()(const string& a, const string& b) const {
+        comparisons++;
+        return a < b;
+    }
+};
+
+// compare() is used for descents, operator() for bounds
+struct CountingThreeWay {
+    bool operator()(const string& a, const string& b) const {
+        comparisons++;
+        return a < b;
+    }
+    int compare(const string& a, const string& b) const {
+        comparisons++;
+        return a.compare(b);
+    }
+};
+
+// The same ordering as std::less<string>, hidden from compareKeys
+struct TwoWayLess {
+    bool operator()(const string& a, const string& b) const { return a < b; }
+};
+
+const char* const FAMILY[] = {"Nguyễn", "Trần", "Lê", "Phạm", "Hoàng", "Huỳnh", "Phan", "Vũ", "Võ", "Đặng", "Bùi", "Đỗ"};
+const char* const FAMILY_ASCII[] = {"nguyen", "tran", "le", "pham", "hoang", "huynh", "phan", "vu", "vo", "dang", "bui", "do"};
+const char* const MIDDLE[] = {"Văn", "Thị", "Thị Thu", "Minh", "Đức", "Ngọc", "Thanh", "Quốc", "Hải", "Hoàng"};
+const char* const MIDDLE_ASCII[] = {"van", "thi", "thi.thu", "minh", "duc", "ngoc", "thanh", "quoc", "hai", "hoang"};
+const char* const GIVEN[] = {"An", "Anh", "Bình", "Châu", "Dũng", "Giang", "Hà", "Hương", "Khoa", "Linh",
+                             "Long", "Mai", "Nam", "Phúc", "Quân", "Trang", "Tuấn", "Yến"};
+const char* const GIVEN_ASCII[] = {"an", "anh", "binh", "chau", "dung", "giang", "ha", "huong", "khoa", "linh",
+                                   "long", "mai", "nam", "phuc", "quan", "trang", "tuan", "yen"};
+
+// Skewed towards the common family names, like a real phone book
+size_t pickFamily(mt19937_64& rng) {
+    size_t roll = rng() % 100;
+    return roll < 38 ? 0 : roll < 50 ? 1 : roll < 59 ? 2 : roll < 66 ? 3 : 4 + roll % 8;
+}
+
+void makeKeys(size_t n, vector<string>& names, vector<string>& emails) {
+    mt19937_64 rng(11);
+    unordered_set<string> seen;
+    while (names.size() < n) {
+        size_t f = pickFamily(rng), m = rng() % 10, g = rng() % 18, number = rng() % 10000;
+        string name = string(FAMILY[f]) + " " + MIDDLE[m] + " " + GIVEN[g] + " " + to_string(number);
+        if (!seen.insert(name).second) {
+            continue;
+        }
+        names.push_back(name);
+        emails.push_back(string(FAMILY_ASCII[f]) + "." + MIDDLE_ASCII[m] + "." + GIVEN_ASCII[g] + to_string(number) +
+                         "@gmail.com");
+    }
+}
+
+template<template<typename, typename, template<typename> class, typename> class Tree, typename Compare>
+void countComparisons(const char* label, const vector<string>& keys, const vector<string>& hits,
+                      const vector<string>& misses) {
+    Tree<string, int, NodePool, Compare> tree;
+    comparisons = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        tree.insert(keys[i], int(i));
+    }
+    double perInsert = double(comparisons) / keys.size();
+
+    comparisons = 0;
+    for (const string& key : hits) {
+        bench::doNotOptimize(tree.find(key));
+    }
+    double perHit = double(comparisons) / hits.size();
+
+    comparisons = 0;
+    for (const string& key : misses) {
+        bench::doNotOptimize(tree.find(key));
+    }
+    double perMiss = double(comparisons) / misses.size();
+    printf("  %-30s %10.1f %10.1f %10.1f\n", label, perInsert, perHit, perMiss);
+}
+
+template<template<typename, typename, template<typename> class, typename> class Tree, typename Compare>
+void timeFinds(const char* label, const vector<string>& keys, const vector<string>& queries) {
+    Tree<string, int, NodePool, Compare> tree;
+    for (size_t i = 0; i < keys.size(); i++) {
+        tree.insert(keys[i], int(i));
+    }
+    size_t found = 0;
+    bench::Stopwatch timer;
+    for (const string& key : queries) {
+        found += tree.find(key) != nullptr;
+    }
+    printf("  %-30s %10.0f %10zu\n", label, timer.elapsedNs() / queries.size(), found);
+}
+
+void run(const char* title, const vector<string>& keys, size_t lookups) {
+    // Insertion order is random, so the BST stays reasonably shallow
+    vector<string> shuffled = keys;
+    shuffle(shuffled.begin(), shuffled.end(), mt19937_64(5));
+
+    vector<string> hits, misses, mixed;
+    mt19937_64 rng(9);
+    for (size_t i = 0; i < lookups; i++) {
+        const string& key = keys[rng() % keys.size()];
+        hits.push_back(key);
+        misses.push_back(key + "x");  // shares the whole key as a prefix
+        mixed.push_back(i % 2 ? hits.back() : misses.back());
+    }
+
+    printf("\n%s: %zu keys (e.g. \"%s\"), %zu lookups\n", title, keys.size(), keys[0].c_str(), lookups);
+    printf("  %-30s %10s %10s %10s\n", "comparisons per op", "insert", "find hit", "find miss");
+    countComparisons<BinarySearchTree, CountingLess>("BinarySearchTree two-way", shuffled, hits, misses);
+    countComparisons<BinarySearchTree, CountingThreeWay>("BinarySearchTree three-way", shuffled, hits, misses);
+    countComparisons<RedBlackTree, CountingLess>("RedBlackTree two-way", shuffled, hits, misses);
+    countComparisons<RedBlackTree, CountingThreeWay>("RedBlackTree three-way", shuffled, hits, misses);
+
+    printf("  %-30s %10s %10s\n", "find, half hit", "ns/op", "found");
+    timeFinds<BinarySearchTree, TwoWayLess>("BinarySearchTree two-way", shuffled, mixed);
+    timeFinds<BinarySearchTree, less<string>>("BinarySearchTree three-way", shuffled, mixed);
+    timeFinds<RedBlackTree, TwoWayLess>("RedBlackTree two-way", shuffled, mixed);
+    timeFinds<RedBlackTree, less<string>>("RedBlackTree three-way", shuffled, mixed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000;
+    size_t lookups = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+
+    vector<string> names, emails;
+    makeKeys(n, names, emails);
+    run("Vietnamese names", names, lookups);
+    run("E-mail addresses", emails, lookups);
+    return 0;
+}
@@ -0,0 +1,172 @@
+// Iterative tree operations: skewed-tree stress and old-vs-new cost.
+//
+// Part 1 builds a fully skewed BinarySearchTree (keys inserted in sorted
+// order, so the tree is one long right spine) and runs find / traversal /
+// remove / clear on a thread whose stack is only STRESS_STACK bytes. The
+// previous recursive implementation needed one frame per level and
+// overflowed here; the iterative one uses O(1) stack regardless of depth.
+// Building a skewed tree by insertion is inherently O(n^2), so the default
+// depth is kept modest; pass a larger one as the first argument.
+//
+// Part 2 compares insert/find on random keys against a copy of the old
+// recursive algorithms.
+//
+// Usage: bench_tree_iterative [skewed_depth] [random_size]
+
+#include "BenchUtil.h"
+#include "BinarySearchTree.h"
+#include "RedBlackTree.h"
+
+#include <pthread.h>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+const size_t STRESS_STACK = 64 * 1024;
+
+// The pre-iterative BinarySearchTree algorithms, kept only for comparison.
+class RecursiveBst {
+private:
+    struct Node {
+        int key;
+        int value;
+        Node* left;
+        Node* right;
+        Node(int k, int v) : key(k), value(v), left(nullptr), right(nullptr) {}
+    };
+
+    Node* root = nullptr;
+
+    Node* insertRecursive(Node* node, int key, int value) {
+        if (node == nullptr) {
+            return new Node(key, value);
+        }
+        if (key < node->key) {
+            node->left = insertRecursive(node->left, key, value);
+        } else if (key > node->key) {
+            node->right = insertRecursive(node->right, key, value);
+        } else {
+            node->value = value;
+        }
+        return node;
+    }
+
+    Node* findRecursive(Node* node, int key) const {
+        if (node == nullptr || node->key == key) {
+            return node;
+        }
+        if (key < node->key) {
+            return findRecursive(node->left, key);
+        }
+        return findRecursive(node->right, key);
+    }
+
+    void clearRecursive(Node* node) {
+        if (node) {
+            clearRecursive(node->left);
+            clearRecursive(node->right);
+            delete node;
+        }
+    }
+
+public:
+    ~RecursiveBst() { clearRecursive(root); }
+    void insert(int key, int value) { root = insertRecursive(root, key, value); }
+    const int* find(int key) const {
+        Node* node = findRecursive(root, key);
+        return node ? &node->value : nullptr;
+    }
+};
+
+struct StressResult {
+    size_t depth;
+    bool ok;
+    double buildMs;
+    double opsMs;
+};
+
+void* runSkewedStress(void* arg) {
+    StressResult* result = static_cast<StressResult*>(arg);
+    const int n = static_cast<int>(result->depth);
+
+    bench::Stopwatch timer;
+    BinarySearchTree<int, int> tree;
+    for (int i = 0; i < n; i++) {
+        tree.insert(i, i);
+    }
+    result->buildMs = timer.elapsedMs();
+
+    timer.reset();
+    bool ok = tree.size() == static_cast<size_t>(n);
+    ok = ok && tree.find(n - 1) != nullptr && *tree.find(n - 1) == n - 1;
+    ok = ok && tree.find(n) == nullptr;
+    ok = ok && tree.getAllPairs().size() == static_cast<size_t>(n);
+    ok = ok && tree.remove(n - 1) && tree.remove(n / 2) && tree.remove(0);
+    ok = ok && tree.getAllValues().size() == static_cast<size_t>(n - 3);
+    tree.clear();
+    ok = ok && tree.empty();
+    result->opsMs = timer.elapsedMs();
+    result->ok = ok;
+    return nullptr;
+}
+
+template<typename Tree>
+void measureRandom(const char* label, const vector<int>& keys) {
+    Tree tree;
+    bench::Stopwatch timer;
+    for (int key : keys) {
+        tree.insert(key, key);
+    }
+    double insertNs = timer.elapsedNs() / keys.size();
+
+    timer.reset();
+    size_t hits = 0;
+    for (int key : keys) {
+        hits += tree.find(key) != nullptr;
+    }
+    bench::doNotOptimize(hits);
+    double findNs = timer.elapsedNs() / keys.size();
+
+    printf("%-26s %14.1f %14.1f\n", label, insertNs, findNs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t skewedDepth = argc > 1 ? strtoull(argv[1], nullptr, 10) : 30000;
+    size_t randomSize = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+
+    // Part 1: skewed stress on a deliberately tiny stack
+    StressResult stress = {skewedDepth, false, 0, 0};
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, STRESS_STACK);
+    pthread_t thread;
+    if (pthread_create(&thread, &attr, runSkewedStress, &stress) != 0) {
+        fprintf(stderr, "pthread_create failed\n");
+        return 1;
+    }
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+
+    printf("Skewed BST, depth %zu on a %zu KiB stack: %s (build %.1f ms, find/scan/remove/clear %.1f ms)\n\n",
+           stress.depth, STRESS_STACK / 1024, stress.ok ? "OK" : "FAILED", stress.buildMs, stress.opsMs);
+
+    // Part 2: random keys, old recursive vs new iterative
+    vector<int> keys(randomSize);
+    vector<size_t> order = bench::randomIndexes(randomSize, 1u << 30);
+    for (size_t i = 0; i < randomSize; i++) {
+        keys[i] = static_cast<int>(order[i]);
+    }
+
+    printf("%zu random keys\n", randomSize);
+    printf("%-26s %14s %14s\n", "implementation", "insert ns/op", "find ns/op");
+    measureRandom<RecursiveBst>("BST recursive (old)", keys);
+    measureRandom<BinarySearchTree<int, int>>("BST iterative", keys);
+    measureRandom<RedBlackTree<int, int>>("RBT iterative", keys);
+
+    return stress.ok ? 0 : 1;
+}
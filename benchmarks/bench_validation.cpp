@@ -0,0 +1,168 @@
+// Field validation: FieldValidator vs the std::regex checks it replaced.
+//
+// isValidEmail used a function-local static std::regex
+//   [a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}
+// with regex_match, and isPhoneNumberValid an isdigit() loop. Both ran on
+// every record of bulkImport and on every prompt of the UI. FieldValidator
+// classifies each byte through a table in one pass.
+//
+// Inputs are realistic addresses and numbers plus mutated copies (a byte
+// replaced, dropped or appended, a cut-off tail), about half of them
+// invalid. Per checker: ns per input, millions of inputs per second, and
+// the inputs accepted. Every input is also checked against std::regex;
+// "differs" counts disagreements and must be 0.
+//
+// Usage: bench_validation [inputs ...]   (default 100k 1M)
+
+#include "BenchUtil.h"
+#include "FieldValidator.h"
+
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Bytes a mutation may insert: every character class of the patterns,
+// the separators, and a UTF-8 lead byte
+const char MUTATIONS[] = "aZ09._%+-@ #\xc3";
+
+string randomEmail(mt19937_64& rng) {
+    static const char* const domains[] = {"gmail.com", "example.vn", "mail.hcmus.edu.vn", "yahoo.co.uk", "x-y.io"};
+    string email = "user";
+    email += to_string(rng() % 1000000);
+    switch (rng() % 4) {
+    case 0:
+        email += ".nguyen";
+        break;
+    case 1:
+        email += "+tag_" + to_string(rng() % 100);
+        break;
+    default:
+        break;
+    }
+    email += '@';
+    email += domains[rng() % 5];
+    return email;
+}
+
+string randomPhone(mt19937_64& rng) {
+    return "09" + to_string(10000000 + rng() % 90000000);
+}
+
+void mutate(string& text, mt19937_64& rng) {
+    size_t at = rng() % (text.size() + 1);
+    char c = MUTATIONS[rng() % (sizeof(MUTATIONS) - 1)];
+    switch (rng() % 4) {
+    case 0:
+        if (at < text.size()) {
+            text[at] = c;
+        }
+        break;
+    case 1:
+        if (at < text.size()) {
+            text.erase(at, 1);
+        }
+        break;
+    case 2:
+        text.insert(text.begin() + at, c);
+        break;
+    default:
+        text.resize(at);
+        break;
+    }
+}
+
+template<typename Fn>
+vector<string> makeInputs(size_t n, Fn generate) {
+    mt19937_64 rng(11);
+    vector<string> inputs(n);
+    for (string& input : inputs) {
+        input = generate(rng);
+        if (rng() % 2 == 0) {
+            mutate(input, rng);
+        }
+    }
+    return inputs;
+}
+
+template<typename Fn>
+size_t measure(const char* label, const vector<string>& inputs, const vector<char>& expected, Fn check) {
+    size_t accepted = 0;
+    size_t differs = 0;
+    vector<char> results(inputs.size());
+    bench::Stopwatch timer;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        results[i] = check(inputs[i]);
+    }
+    double ns = timer.elapsedNs() / inputs.size();
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        accepted += results[i];
+        differs += results[i] != expected[i];
+    }
+    printf("  %-24s %10.1f %10.1f %10zu %10zu\n", label, ns, 1e3 / ns, accepted, differs);
+    return differs;
+}
+
+// The manager's previous phone check
+bool digitLoopPhone(const string& phone) {
+    if (phone.empty() || phone.length() > 11) {
+        return false;
+    }
+    for (char c : phone) {
+        if (!isdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t run(size_t n) {
+    static const regex emailPattern(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
+    static const regex phonePattern("[0-9]{1,11}");
+    size_t differs = 0;
+
+    vector<string> emails = makeInputs(n, randomEmail);
+    vector<char> expected(n);
+    for (size_t i = 0; i < n; i++) {
+        expected[i] = regex_match(emails[i], emailPattern);
+    }
+    printf("\n%zu e-mail addresses\n", n);
+    printf("  %-24s %10s %10s %10s %10s\n", "checker", "ns/input", "M/s", "accepted", "differs");
+    differs += measure("std::regex (static)", emails, expected,
+                       [](const string& email) { return regex_match(email, emailPattern); });
+    differs += measure("FieldValidator", emails, expected,
+                       [](const string& email) { return FieldValidator::isValidEmail(email); });
+
+    vector<string> phones = makeInputs(n, randomPhone);
+    for (size_t i = 0; i < n; i++) {
+        expected[i] = regex_match(phones[i], phonePattern);
+    }
+    printf("\n%zu phone numbers\n", n);
+    printf("  %-24s %10s %10s %10s %10s\n", "checker", "ns/input", "M/s", "accepted", "differs");
+    differs += measure("isdigit loop", phones, expected, digitLoopPhone);
+    differs += measure("FieldValidator", phones, expected,
+                       [](const string& phone) { return FieldValidator::isValidPhone(phone); });
+    return differs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = bench::parseSizes(argc, argv, {100000, 1000000});
+    size_t differs = 0;
+    for (size_t n : sizes) {
+        differs += run(n);
+    }
+    if (differs != 0) {
+        printf("\nFieldValidator and std::regex disagree on %zu inputs\n", differs);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+// Write-ahead log throughput: mutation rate with and without group commit.
+//
+// Every manager mutation appends one record to the WAL. With
+// syncIntervalMs = 0 each append is written and fdatasync'ed on its own;
+// with a positive interval appends only queue into a batch that a
+// background thread writes and syncs once per interval, so the fsync cost
+// is shared by every mutation in the window.
+//
+// Part 1 runs as fast as possible per interval. Part 2 paces mutations at
+// a fixed target rate (default 100k ops/s) and reports the achieved rate
+// and the per-mutation latency seen by the caller.
+//
+// Usage: bench_wal_throughput [contacts] [target ops/s] [seconds]
+//        (defaults 10000 100000 2)
+
+#include "BenchUtil.h"
+#include "ContactManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const string SNAPSHOT_PATH = "bench_wal.snapshot";
+const string WAL_PATH = "bench_wal.snapshot.wal";
+
+void removeFiles() {
+    remove(SNAPSHOT_PATH.c_str());
+    remove(WAL_PATH.c_str());
+}
+
+// Contact i alternates between two phone numbers that no other contact uses
+string phoneFor(size_t i, uint64_t generation) {
+    string digits = to_string(100000 + i);
+    return (generation % 2 ? "0912" : "0903") + digits;
+}
+
+vector<Contact*> openWithContacts(ContactManager* manager, size_t n, const WalOptions& options) {
+    bench::SilenceStdout quiet;
+    manager->clearAll();
+    removeFiles();
+    manager->openStorage(SNAPSHOT_PATH, WAL_PATH, options);
+
+    vector<Contact*> contacts;
+    contacts.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        string name = "Nguyen Van " + to_string(i);
+        manager->addContact(name);
+        contacts.push_back(manager->findContact(name));
+    }
+    return contacts;
+}
+
+void closeStorage(ContactManager* manager) {
+    bench::SilenceStdout quiet;
+    manager->closeStorage();
+    manager->clearAll();
+    removeFiles();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000;
+    double targetRate = argc > 2 ? atof(argv[2]) : 100000.0;
+    double seconds = argc > 3 ? atof(argv[3]) : 2.0;
+    ContactManager* manager = ContactManager::getInstance();
+
+    printf("%zu contacts, setContactPhone per op\n\n", n);
+    printf("%-22s %10s %12s %10s %14s\n", "mode", "ops", "ops/s", "fsyncs", "ops per fsync");
+
+    // Baseline: same mutations without a log
+    {
+        vector<Contact*> contacts = openWithContacts(manager, n, WalOptions());
+        {
+            bench::SilenceStdout quiet;
+            manager->closeStorage();
+        }
+        size_t ops = 200000;
+        bench::Stopwatch timer;
+        for (size_t op = 0; op < ops; op++) {
+            manager->setContactPhone(contacts[op % n], phoneFor(op % n, op / n + 1));
+        }
+        double elapsed = timer.elapsedNs() / 1e9;
+        printf("%-22s %10zu %12.0f %10s %14s\n", "no WAL", ops, ops / elapsed, "-", "-");
+        closeStorage(manager);
+    }
+
+    const int intervals[] = {0, 1, 10, 100};
+    for (int interval : intervals) {
+        WalOptions options;
+        options.syncIntervalMs = interval;
+        vector<Contact*> contacts = openWithContacts(manager, n, options);
+        uint64_t syncsBefore = manager->writeAheadLog()->stats().syncs;
+
+        // fsync-per-op is slow; keep its run short
+        size_t ops = interval == 0 ? 2000 : 200000;
+        bench::Stopwatch timer;
+        for (size_t op = 0; op < ops; op++) {
+            manager->setContactPhone(contacts[op % n], phoneFor(op % n, op / n + 1));
+        }
+        manager->writeAheadLog()->sync();
+        double elapsed = timer.elapsedNs() / 1e9;
+
+        uint64_t syncs = manager->writeAheadLog()->stats().syncs - syncsBefore;
+        char label[32];
+        snprintf(label, sizeof(label), interval == 0 ? "fsync every op" : "group commit %d ms", interval);
+        printf("%-22s %10zu %12.0f %10llu %14.1f\n", label, ops, ops / elapsed,
+               static_cast<unsigned long long>(syncs), syncs ? double(ops) / syncs : 0.0);
+        closeStorage(manager);
+    }
+
+    // Sustained, paced load
+    printf("\nsustained %.0f ops/s for %.1f s, group commit 10 ms\n", targetRate, seconds);
+    {
+        WalOptions options;
+        options.syncIntervalMs = 10;
+        vector<Contact*> contacts = openWithContacts(manager, n, options);
+        WriteAheadLog::Stats before = manager->writeAheadLog()->stats();
+
+        size_t total = static_cast<size_t>(targetRate * seconds);
+        vector<double> latencyUs;
+        latencyUs.reserve(total);
+        auto start = chrono::steady_clock::now();
+        for (size_t op = 0; op < total; op++) {
+            // Busy-wait until this op's slot; falling behind just runs back-to-back
+            auto due = start + chrono::nanoseconds(static_cast<long long>(op * 1e9 / targetRate));
+            while (chrono::steady_clock::now() < due) {
+            }
+            bench::Stopwatch timer;
+            manager->setContactPhone(contacts[op % n], phoneFor(op % n, op / n + 1));
+            latencyUs.push_back(timer.elapsedNs() / 1000.0);
+        }
+        manager->writeAheadLog()->sync();
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        WriteAheadLog::Stats after = manager->writeAheadLog()->stats();
+
+        sort(latencyUs.begin(), latencyUs.end());
+        printf("  achieved   %.0f ops/s (%zu ops in %.2f s)\n", total / elapsed, total, elapsed);
+        printf("  latency    p50 %.2f us, p99 %.2f us, max %.1f us\n", latencyUs[total / 2],
+               latencyUs[total * 99 / 100], latencyUs.back());
+        printf("  fsyncs     %llu (%.0f ops each)\n", static_cast<unsigned long long>(after.syncs - before.syncs),
+               double(total) / max<uint64_t>(1, after.syncs - before.syncs));
+        printf("  log bytes  %llu\n", static_cast<unsigned long long>(after.bytes));
+        closeStorage(manager);
+    }
+    return 0;
+}
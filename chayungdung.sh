@@ -5,11 +5,21 @@ echo "🔨 Compiling Smart Contact CLI..."
 echo "📁 Using new directory structure..."
 
 # Compile với đường dẫn mới
-g++ -std=c++17 -Wall -Wextra -O2 \
+g++ -std=c++17 -Wall -Wextra -O2 -pthread \
     -I./include \
     src/main.cpp \
     src/Contact.cpp \
+    src/ContactStore.cpp \
     src/ContactManager.cpp \
+    src/NGramIndex.cpp \
+    src/FieldValidator.cpp \
+    src/TextSearch.cpp \
+    src/ContactSnapshot.cpp \
+    src/WriteAheadLog.cpp \
+    src/WorkStealingPool.cpp \
+    src/UniqueKeyTable.cpp \
+    src/ShardedContactManager.cpp \
+    src/BatchCommandRunner.cpp \
     src/ContactUI.cpp \
     -o smart_contact_cli
 
@@ -0,0 +1,1004 @@
+#ifndef B_TREE_H
+#define B_TREE_H
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <utility>
+#include <new>
+#include <type_traits>
+#include "TreeIterator.h"
+#include "KeyCompare.h"
+#include "NodePool.h"
+
+// Default fan-out: about 1 KiB of keys per node (8 to 64 keys), i.e. 32
+// std::strings. One node visit replaces five binary-tree levels and its
+// keys sit next to each other in memory; bench_btree found 8 and 16 keys
+// per node slower for string indexes past 100k keys.
+template<typename K>
+struct BTreeDefaultOrder {
+    static const size_t bytes = 1024 / sizeof(K);
+    static const size_t value = bytes < 8 ? 8 : (bytes > 64 ? 64 : bytes);
+};
+
+// Bidirectional in-order iterator over the leaf chain of a BTree: a
+// position is a leaf and a slot in it, end() is {nullptr, 0}. Dereferencing
+// yields the same {first, second} reference pair as TreeIterator.
+template<typename Tree, typename Leaf, bool IsConst>
+class BTreeIterator {
+private:
+    template<typename, typename, bool> friend class BTreeIterator;
+    friend Tree;
+    
+    const Tree* tree;
+    Leaf* leaf;
+    size_t slot;
+    
+    BTreeIterator(const Tree* t, Leaf* l, size_t s) : tree(t), leaf(l), slot(s) {}
+
+public:
+    using key_type = typename std::remove_reference<decltype(std::declval<Leaf&>().keys[0])>::type;
+    using mapped_type = typename std::remove_reference<decltype(std::declval<Leaf&>().values[0])>::type;
+    using mapped_reference = typename std::conditional<IsConst, const mapped_type&, mapped_type&>::type;
+    
+    struct reference {
+        const key_type& first;
+        mapped_reference second;
+    };
+    
+    struct pointer {
+        reference ref;
+        const reference* operator->() const { return &ref; }
+    };
+    
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<const key_type, mapped_type>;
+    using difference_type = std::ptrdiff_t;
+    
+    BTreeIterator() : tree(nullptr), leaf(nullptr), slot(0) {}
+    
+    // iterator -> const_iterator
+    template<bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+    BTreeIterator(const BTreeIterator<Tree, Leaf, WasConst>& other) : tree(other.tree), leaf(other.leaf), slot(other.slot) {}
+    
+    reference operator*() const { return reference{leaf->keys[slot], leaf->values[slot]}; }
+    pointer operator->() const { return pointer{**this}; }
+    
+    const key_type& key() const { return leaf->keys[slot]; }
+    mapped_reference value() const { return leaf->values[slot]; }
+    
+    BTreeIterator& operator++() {
+        if (++slot == leaf->count) {
+            leaf = leaf->next;
+            slot = 0;
+        }
+        return *this;
+    }
+    
+    BTreeIterator operator++(int) {
+        BTreeIterator old = *this;
+        ++*this;
+        return old;
+    }
+    
+    // --end() is the largest key
+    BTreeIterator& operator--() {
+        if (leaf == nullptr) {
+            leaf = tree->lastLeaf();
+            slot = leaf->count - 1;
+        } else if (slot > 0) {
+            slot--;
+        } else {
+            leaf = leaf->prev;
+            slot = leaf->count - 1;
+        }
+        return *this;
+    }
+    
+    BTreeIterator operator--(int) {
+        BTreeIterator old = *this;
+        --*this;
+        return old;
+    }
+    
+    template<bool OtherConst>
+    bool operator==(const BTreeIterator<Tree, Leaf, OtherConst>& other) const {
+        return leaf == other.leaf && slot == other.slot;
+    }
+    
+    template<bool OtherConst>
+    bool operator!=(const BTreeIterator<Tree, Leaf, OtherConst>& other) const { return !(*this == other); }
+};
+
+// B+ tree with up to Order keys per node: a drop-in alternative to
+// RedBlackTree (same insert/find/remove/contains, ordered queries,
+// iteration and buildFromSorted) for indexes that are mostly searched.
+//
+// Pairs live only in the leaves, which are chained in key order, so an
+// in-order scan walks arrays instead of chasing parent pointers. Inner
+// nodes hold separator keys: every key in children[i] is less than keys[i],
+// every key in children[i + 1] is not. Nodes other than the root stay at
+// least half full. Leaves and inner nodes come from two NodePools.
+//
+// Unlike the binary trees, inserting or removing moves pairs between slots
+// and nodes, so it invalidates iterators and pointers returned by find().
+// Keys and values must be default constructible.
+template<typename K, typename V, size_t Order = BTreeDefaultOrder<K>::value, typename Compare = std::less<K>>
+class BTree {
+private:
+    static_assert(Order >= 4, "a B-tree node needs room for at least 4 keys");
+    
+    static const size_t MIN_LEAF_KEYS = Order / 2;
+    static const size_t MIN_INNER_KEYS = (Order - 1) / 2;
+    static const size_t MAX_HEIGHT = 64;  // inner nodes have >= 2 children
+    
+    struct NodeBase {
+        size_t count;  // keys in use
+        bool isLeaf;
+    };
+    
+    struct Leaf : NodeBase {
+        K keys[Order];
+        V values[Order];
+        Leaf* prev;
+        Leaf* next;
+    };
+    
+    struct Inner : NodeBase {
+        K keys[Order];
+        NodeBase* children[Order + 1];
+    };
+    
+    // Inner nodes from the root down to a leaf, with the child index taken
+    struct Path {
+        Inner* nodes[MAX_HEIGHT];
+        size_t slots[MAX_HEIGHT];
+        size_t depth;
+    };
+    
+    NodeBase* root;  // nullptr when empty
+    size_t size_;
+    NodePool<Leaf> leafPool;
+    NodePool<Inner> innerPool;
+    Compare comp_;
+    
+    template<typename, typename, bool> friend class BTreeIterator;
+    
+    // Helper methods
+    Leaf* createLeaf();
+    Inner* createInner();
+    void destroyNode(NodeBase* node);
+    template<typename Q>
+    size_t lowerIndex(const K* keys, size_t count, const Q& key, bool& found) const;
+    template<typename Q>
+    size_t upperIndex(const K* keys, size_t count, const Q& key) const;
+    template<typename Q>
+    Leaf* descend(const Q& key, Path* path) const;
+    template<typename Key>
+    void insertKey(Key&& key, const V& value);
+    void insertIntoParent(Path& path, K separator, NodeBase* right);
+    void eraseAt(Path& path, Leaf* leaf, size_t slot);
+    void rebalanceLeaf(Path& path, Leaf* leaf);
+    void rebalanceInner(Path& path, size_t level);
+    void removeChild(Inner* node, size_t keySlot);
+    template<typename Q>
+    bool removeKey(const Q& key);
+    template<typename Q>
+    V* findValue(const Q& key) const;
+    template<typename Q>
+    std::pair<Leaf*, size_t> lowerBoundSlot(const Q& key) const;
+    template<typename Q>
+    std::pair<Leaf*, size_t> upperBoundSlot(const Q& key) const;
+    Leaf* firstLeaf() const;
+    Leaf* lastLeaf() const;
+
+public:
+    using iterator = BTreeIterator<BTree, Leaf, false>;
+    using const_iterator = BTreeIterator<BTree, Leaf, true>;
+    
+    BTree() : root(nullptr), size_(0) {}
+    ~BTree() { clear(); }
+    
+    BTree(const BTree&) = delete;
+    BTree& operator=(const BTree&) = delete;
+    
+    // Core operations
+    void insert(const K& key, const V& value) { insertKey(key, value); }
+    void insert(K&& key, const V& value) { insertKey(std::move(key), value); }  // Moves key into the leaf
+    V* find(const K& key) { return findValue(key); }
+    const V* find(const K& key) const { return findValue(key); }
+    bool remove(const K& key) { return removeKey(key); }
+    bool contains(const K& key) const { return findValue(key) != nullptr; }
+    
+    // Utility methods
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear();
+    size_t height() const;  // 0 when empty, 1 for a single leaf
+    
+    // Bulk load: replaces the contents in O(n) with leaves and inner nodes
+    // packed as full as the half-full rule allows. [first, last) must yield
+    // pairs (first = key, second = value) in strictly increasing key order.
+    // Keys are copied, or moved when given move iterators.
+    template<typename InputIt>
+    void buildFromSorted(InputIt first, InputIt last);
+    
+    std::vector<V> getAllValues() const;
+    
+    // Debug
+    void print() const;
+    
+    // In-order iteration along the leaf chain
+    iterator begin() { return iterator(this, firstLeaf(), 0); }
+    iterator end() { return iterator(this, nullptr, 0); }
+    const_iterator begin() const { return const_iterator(this, firstLeaf(), 0); }
+    const_iterator end() const { return const_iterator(this, nullptr, 0); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    
+    // Ordered queries
+    iterator lower_bound(const K& key) {
+        std::pair<Leaf*, size_t> at = lowerBoundSlot(key);
+        return iterator(this, at.first, at.second);
+    }
+    iterator upper_bound(const K& key) {
+        std::pair<Leaf*, size_t> at = upperBoundSlot(key);
+        return iterator(this, at.first, at.second);
+    }
+    const_iterator lower_bound(const K& key) const {
+        std::pair<Leaf*, size_t> at = lowerBoundSlot(key);
+        return const_iterator(this, at.first, at.second);
+    }
+    const_iterator upper_bound(const K& key) const {
+        std::pair<Leaf*, size_t> at = upperBoundSlot(key);
+        return const_iterator(this, at.first, at.second);
+    }
+    TreeRange<const_iterator> range(const K& lo, const K& hi) const {  // keys in [lo, hi)
+        if (!comp_(lo, hi)) {
+            return TreeRange<const_iterator>(end(), end());
+        }
+        return TreeRange<const_iterator>(lower_bound(lo), lower_bound(hi));
+    }
+    TreeRange<const_iterator> prefixRange(const K& prefix) const;  // string keys starting with prefix
+    
+    // Heterogeneous lookup, only when Compare is transparent (see
+    // BinarySearchTree.h)
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    V* find(const Q& key) { return findValue(key); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const V* find(const Q& key) const { return findValue(key); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const Q& key) const { return findValue(key) != nullptr; }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    bool remove(const Q& key) { return removeKey(key); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    iterator lower_bound(const Q& key) {
+        std::pair<Leaf*, size_t> at = lowerBoundSlot(key);
+        return iterator(this, at.first, at.second);
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    iterator upper_bound(const Q& key) {
+        std::pair<Leaf*, size_t> at = upperBoundSlot(key);
+        return iterator(this, at.first, at.second);
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator lower_bound(const Q& key) const {
+        std::pair<Leaf*, size_t> at = lowerBoundSlot(key);
+        return const_iterator(this, at.first, at.second);
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator upper_bound(const Q& key) const {
+        std::pair<Leaf*, size_t> at = upperBoundSlot(key);
+        return const_iterator(this, at.first, at.second);
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    TreeRange<const_iterator> range(const Q& lo, const Q& hi) const {
+        if (!comp_(lo, hi)) {
+            return TreeRange<const_iterator>(end(), end());
+        }
+        return TreeRange<const_iterator>(lower_bound(lo), lower_bound(hi));
+    }
+    
+    // Snapshot copy of all pairs (prefer iterators for scans)
+    std::vector<std::pair<K, V>> getAllPairs() const;
+};
+
+// Implementation
+template<typename K, typename V, size_t Order, typename Compare>
+typename BTree<K, V, Order, Compare>::Leaf* BTree<K, V, Order, Compare>::createLeaf() {
+    Leaf* leaf = leafPool.allocate();
+    try {
+        new (leaf) Leaf();
+    } catch (...) {
+        leafPool.deallocate(leaf);
+        throw;
+    }
+    leaf->count = 0;
+    leaf->isLeaf = true;
+    leaf->prev = nullptr;
+    leaf->next = nullptr;
+    return leaf;
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+typename BTree<K, V, Order, Compare>::Inner* BTree<K, V, Order, Compare>::createInner() {
+    Inner* inner = innerPool.allocate();
+    try {
+        new (inner) Inner();
+    } catch (...) {
+        innerPool.deallocate(inner);
+        throw;
+    }
+    inner->count = 0;
+    inner->isLeaf = false;
+    return inner;
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+void BTree<K, V, Order, Compare>::destroyNode(NodeBase* node) {
+    if (node->isLeaf) {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        leaf->~Leaf();
+        leafPool.deallocate(leaf);
+    } else {
+        Inner* inner = static_cast<Inner*>(node);
+        inner->~Inner();
+        innerPool.deallocate(inner);
+    }
+}
+
+// First slot whose key is not less than key; found is set when it equals key.
+// One three-way comparison per probe, stopping early on a match.
+template<typename K, typename V, size_t Order, typename Compare>
+template<typename Q>
+size_t BTree<K, V, Order, Compare>::lowerIndex(const K* keys, size_t count, const Q& key, bool& found) const {
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int order = compareKeys(comp_, key, keys[mid]);
+        if (order > 0) {
+            lo = mid + 1;
+        } else if (order < 0) {
+            hi = mid;
+        } else {
+            found = true;
+            return mid;
+        }
+    }
+    found = false;
+    return lo;
+}
+
+// First slot whose key is greater than key: the child of an inner node that
+// may hold key
+template<typename K, typename V, size_t Order, typename Compare>
+template<typename Q>
+size_t BTree<K, V, Order, Compare>::upperIndex(const K* keys, size_t count, const Q& key) const {
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int order = compareKeys(comp_, key, keys[mid]);
+        if (order < 0) {
+            hi = mid;
+        } else if (order > 0) {
+            lo = mid + 1;
+        } else {
+            return mid + 1;
+        }
+    }
+    return lo;
+}
+
+// Leaf that holds key if it is present; records the inner nodes on the way
+// when path is given. root must not be nullptr.
+template<typename K, typename V, size_t Order, typename Compare>
+template<typename Q>
+typename BTree<K, V, Order, Compare>::Leaf* BTree<K, V, Order, Compare>::descend(const Q& key, Path* path) const {
+    NodeBase* node = root;
+    if (path != nullptr) {
+        path->depth = 0;
+    }
+    while (!node->isLeaf) {
+        Inner* inner = static_cast<Inner*>(node);
+        size_t slot = upperIndex(inner->keys, inner->count, key);
+        if (path != nullptr) {
+            path->nodes[path->depth] = inner;
+            path->slots[path->depth] = slot;
+            path->depth++;
+        }
+        node = inner->children[slot];
+    }
+    return static_cast<Leaf*>(node);
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+template<typename Q>
+V* BTree<K, V, Order, Compare>::findValue(const Q& key) const {
+    if (root == nullptr) {
+        return nullptr;
+    }
+    Leaf* leaf = descend(key, nullptr);
+    bool found;
+    size_t slot = lowerIndex(leaf->keys, leaf->count, key, found);
+    return found ? &leaf->values[slot] : nullptr;
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+template<typename Key>
+void BTree<K, V, Order, Compare>::insertKey(Key&& key, const V& value) {
+    if (root == nullptr) {
+        Leaf* leaf = createLeaf();
+        leaf->keys[0] = std::forward<Key>(key);
+        leaf->values[0] = value;
+        leaf->count = 1;
+        root = leaf;
+        size_ = 1;
+        return;
+    }
+    
+    Path path;
+    Leaf* leaf = descend(key, &path);
+    bool found;
+    size_t slot = lowerIndex(leaf->keys, leaf->count, key, found);
+    if (found) {
+        // Key already exists, update value
+        leaf->values[slot] = value;
+        return;
+    }
+    
+    if (leaf->count < Order) {
+        for (size_t i = leaf->count; i > slot; i--) {
+            leaf->keys[i] = std::move(leaf->keys[i - 1]);
+            leaf->values[i] = std::move(leaf->values[i - 1]);
+        }
+        leaf->keys[slot] = std::forward<Key>(key);
+        leaf->values[slot] = value;
+        leaf->count++;
+        size_++;
+        return;
+    }
+    
+    // Full leaf: the Order + 1 pairs are split between leaf and a new right
+    // sibling, and the right one's first key goes up as separator
+    Leaf* right = createLeaf();
+    size_t total = Order + 1;
+    size_t leftCount = total / 2;
+    for (size_t i = leftCount; i < total; i++) {
+        size_t to = i - leftCount;
+        if (i == slot) {
+            right->keys[to] = std::forward<Key>(key);
+            right->values[to] = value;
+        } else {
+            size_t from = i < slot ? i : i - 1;
+            right->keys[to] = std::move(leaf->keys[from]);
+            right->values[to] = std::move(leaf->values[from]);
+        }
+    }
+    if (slot < leftCount) {
+        for (size_t i = leftCount - 1; i > slot; i--) {
+            leaf->keys[i] = std::move(leaf->keys[i - 1]);
+            leaf->values[i] = std::move(leaf->values[i - 1]);
+        }
+        leaf->keys[slot] = std::forward<Key>(key);
+        leaf->values[slot] = value;
+    }
+    leaf->count = leftCount;
+    right->count = total - leftCount;
+    for (size_t i = leftCount; i < Order; i++) {
+        leaf->keys[i] = K();  // release moved-from storage early
+    }
+    
+    right->next = leaf->next;
+    right->prev = leaf;
+    if (leaf->next != nullptr) {
+        leaf->next->prev = right;
+    }
+    leaf->next = right;
+    size_++;
+    
+    insertIntoParent(path, right->keys[0], right);
+}
+
+// Links right (split off path's last node) into the parent, splitting inner
+// nodes upwards as needed and growing a new root at the top
+template<typename K, typename V, size_t Order, typename Compare>
+void BTree<K, V, Order, Compare>::insertIntoParent(Path& path, K separator, NodeBase* right) {
+    while (path.depth > 0) {
+        path.depth--;
+        Inner* parent = path.nodes[path.depth];
+        size_t slot = path.slots[path.depth];  // right goes to children[slot + 1]
+    
+        if (parent->count < Order) {
+            for (size_t i = parent->count; i > slot; i--) {
+                parent->keys[i] = std::move(parent->keys[i - 1]);
+                parent->children[i + 1] = parent->children[i];
+            }
+            parent->keys[slot] = std::move(separator);
+            parent->children[slot + 1] = right;
+            parent->count++;
+            return;
+        }
+    
+        // Full inner node: lay out the Order + 1 keys and Order + 2
+        // children in order, keep the lower half, push the middle key up
+        K keys[Order + 1];
+        NodeBase* children[Order + 2];
+        for (size_t i = 0, j = 0; i <= Order; i++) {
+            keys[i] = i == slot ? std::move(separator) : std::move(parent->keys[j++]);
+        }
+        for (size_t i = 0, j = 0; i <= Order + 1; i++) {
+            children[i] = i == slot + 1 ? right : parent->children[j++];
+        }
+    
+        size_t mid = (Order + 1) / 2;
+        Inner* sibling = createInner();
+        for (size_t i = 0; i < mid; i++) {
+            parent->keys[i] = std::move(keys[i]);
+            parent->children[i] = children[i];
+        }
+        parent->children[mid] = children[mid];
+        parent->count = mid;
+        for (size_t i = mid + 1; i <= Order; i++) {
+            sibling->keys[i - mid - 1] = std::move(keys[i]);
+            sibling->children[i - mid - 1] = children[i];
+        }
+        sibling->children[Order - mid] = children[Order + 1];
+        sibling->count = Order - mid;
+    
+        separator = std::move(keys[mid]);
+        right = sibling;
+    }
+    
+    Inner* newRoot = createInner();
+    newRoot->keys[0] = std::move(separator);
+    newRoot->children[0] = root;
+    newRoot->children[1] = right;
+    newRoot->count = 1;
+    root = newRoot;
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+template<typename Q>
+bool BTree<K, V, Order, Compare>::removeKey(const Q& key) {
+    if (root == nullptr) {
+        return false;
+    }
+    Path path;
+    Leaf* leaf = descend(key, &path);
+    bool found;
+    size_t slot = lowerIndex(leaf->keys, leaf->count, key, found);
+    if (!found) {
+        return false;
+    }
+    eraseAt(path, leaf, slot);
+    return true;
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+void BTree<K, V, Order, Compare>::eraseAt(Path& path, Leaf* leaf, size_t slot) {
+    for (size_t i = slot + 1; i < leaf->count; i++) {
+        leaf->keys[i - 1] = std::move(leaf->keys[i]);
+        leaf->values[i - 1] = std::move(leaf->values[i]);
+    }
+    leaf->count--;
+    leaf->keys[leaf->count] = K();
+    leaf->values[leaf->count] = V();
+    size_--;
+    
+    if (path.depth == 0) {
+        // The root leaf may run down to empty
+        if (leaf->count == 0) {
+            destroyNode(leaf);
+            root = nullptr;
+        }
+        return;
+    }
+    if (leaf->count < MIN_LEAF_KEYS) {
+        rebalanceLeaf(path, leaf);
+    }
+    // Separators equal to the removed key stay valid: they still order the
+    // subtrees on either side
+}
+
+// Refills an underfull leaf from a sibling under the same parent, or merges
+// the two when the sibling has nothing to spare
+template<typename K, typename V, size_t Order, typename Compare>
+void BTree<K, V, Order, Compare>::rebalanceLeaf(Path& path, Leaf* leaf) {
+    Inner* parent = path.nodes[path.depth - 1];
+    size_t slot = path.slots[path.depth - 1];
+    
+    if (slot > 0) {
+        Leaf* left = static_cast<Leaf*>(parent->children[slot - 1]);
+        if (left->count > MIN_LEAF_KEYS) {
+            for (size_t i = leaf->count; i > 0; i--) {
+                leaf->keys[i] = std::move(leaf->keys[i - 1]);
+                leaf->values[i] = std::move(leaf->values[i - 1]);
+            }
+            left->count--;
+            leaf->keys[0] = std::move(left->keys[left->count]);
+            leaf->values[0] = std::move(left->values[left->count]);
+            left->keys[left->count] = K();
+            leaf->count++;
+            parent->keys[slot - 1] = leaf->keys[0];
+            return;
+        }
+    }
+    if (slot < parent->count) {
+        Leaf* right = static_cast<Leaf*>(parent->children[slot + 1]);
+        if (right->count > MIN_LEAF_KEYS) {
+            leaf->keys[leaf->count] = std::move(right->keys[0]);
+            leaf->values[leaf->count] = std::move(right->values[0]);
+            leaf->count++;
+            for (size_t i = 1; i < right->count; i++) {
+                right->keys[i - 1] = std::move(right->keys[i]);
+                right->values[i - 1] = std::move(right->values[i]);
+            }
+            right->count--;
+            right->keys[right->count] = K();
+            parent->keys[slot] = right->keys[0];
+            return;
+        }
+    }
+    
+    // Merge the right one of the pair into the left one
+    Leaf* left = slot > 0 ? static_cast<Leaf*>(parent->children[slot - 1]) : leaf;
+    Leaf* right = slot > 0 ? leaf : static_cast<Leaf*>(parent->children[slot + 1]);
+    size_t separator = slot > 0 ? slot - 1 : slot;
+    for (size_t i = 0; i < right->count; i++) {
+        left->keys[left->count + i] = std::move(right->keys[i]);
+        left->values[left->count + i] = std::move(right->values[i]);
+    }
+    left->count += right->count;
+    left->next = right->next;
+    if (right->next != nullptr) {
+        right->next->prev = left;
+    }
+    destroyNode(right);
+    removeChild(parent, separator);
+    
+    path.depth--;
+    rebalanceInner(path, path.depth);
+}
+
+// Drops keys[keySlot] and children[keySlot + 1] from an inner node
+template<typename K, typename V, size_t Order, typename Compare>
+void BTree<K, V, Order, Compare>::removeChild(Inner* node, size_t keySlot) {
+    for (size_t i = keySlot + 1; i < node->count; i++) {
+        node->keys[i - 1] = std::move(node->keys[i]);
+        node->children[i] = node->children[i + 1];
+    }
+    node->count--;
+    node->keys[node->count] = K();
+}
+
+// path.nodes[level] may have lost a key: collapse the root or refill the
+// node the same way as rebalanceLeaf, continuing upwards after a merge
+template<typename K, typename V, size_t Order, typename Compare>
+void BTree<K, V, Order, Compare>::rebalanceInner(Path& path, size_t level) {
+    Inner* node = path.nodes[level];
+    if (level == 0) {
+        if (node->count == 0) {
+            root = node->children[0];
+            destroyNode(node);
+        }
+        return;
+    }
+    if (node->count >= MIN_INNER_KEYS) {
+        return;
+    }
+    
+    Inner* parent = path.nodes[level - 1];
+    size_t slot = path.slots[level - 1];
+    
+    if (slot > 0) {
+        Inner* left = static_cast<Inner*>(parent->children[slot - 1]);
+        if (left->count > MIN_INNER_KEYS) {
+            // Rotate right through the parent's separator
+            for (size_t i = node->count; i > 0; i--) {
+                node->keys[i] = std::move(node->keys[i - 1]);
+            }
+            for (size_t i = node->count + 1; i > 0; i--) {
+                node->children[i] = node->children[i - 1];
+            }
+            node->keys[0] = std::move(parent->keys[slot - 1]);
+            node->children[0] = left->children[left->count];
+            node->count++;
+            left->count--;
+            parent->keys[slot - 1] = std::move(left->keys[left->count]);
+            left->keys[left->count] = K();
+            return;
+        }
+    }
+    if (slot < parent->count) {
+        Inner* right = static_cast<Inner*>(parent->children[slot + 1]);
+        if (right->count > MIN_INNER_KEYS) {
+            // Rotate left through the parent's separator
+            node->keys[node->count] = std::move(parent->keys[slot]);
+            node->children[node->count + 1] = right->children[0];
+            node->count++;
+            parent->keys[slot] = std::move(right->keys[0]);
+            for (size_t i = 1; i < right->count; i++) {
+                right->keys[i - 1] = std::move(right->keys[i]);
+            }
+            for (size_t i = 1; i <= right->count; i++) {
+                right->children[i - 1] = right->children[i];
+            }
+            right->count--;
+            right->keys[right->count] = K();
+            return;
+        }
+    }
+    
+    // Merge: left keys, the parent's separator, right keys
+    Inner* left = slot > 0 ? static_cast<Inner*>(parent->children[slot - 1]) : node;
+    Inner* right = slot > 0 ? node : static_cast<Inner*>(parent->children[slot + 1]);
+    size_t separator = slot > 0 ? slot - 1 : slot;
+    left->keys[left->count] = std::move(parent->keys[separator]);
+    for (size_t i = 0; i < right->count; i++) {
+        left->keys[left->count + 1 + i] = std::move(right->keys[i]);
+    }
+    for (size_t i = 0; i <= right->count; i++) {
+        left->children[left->count + 1 + i] = right->children[i];
+    }
+    left->count += right->count + 1;
+    destroyNode(right);
+    removeChild(parent, separator);
+    
+    rebalanceInner(path, level - 1);
+}
+
+// Position of the first key not less than key (end() if none). Keys in the
+// next leaf are all >= the separator that sent us left, so when every key
+// here is smaller the answer is the next leaf's first slot.
+template<typename K, typename V, size_t Order, typename Compare>
+template<typename Q>
+std::pair<typename BTree<K, V, Order, Compare>::Leaf*, size_t> BTree<K, V, Order, Compare>::lowerBoundSlot(const Q& key) const {
+    if (root == nullptr) {
+        return std::make_pair(static_cast<Leaf*>(nullptr), size_t(0));
+    }
+    Leaf* leaf = descend(key, nullptr);
+    bool found;
+    size_t slot = lowerIndex(leaf->keys, leaf->count, key, found);
+    if (slot == leaf->count) {
+        return std::make_pair(leaf->next, size_t(0));
+    }
+    return std::make_pair(leaf, slot);
+}
+
+// Position of the first key greater than key (end() if none)
+template<typename K, typename V, size_t Order, typename Compare>
+template<typename Q>
+std::pair<typename BTree<K, V, Order, Compare>::Leaf*, size_t> BTree<K, V, Order, Compare>::upperBoundSlot(const Q& key) const {
+    if (root == nullptr) {
+        return std::make_pair(static_cast<Leaf*>(nullptr), size_t(0));
+    }
+    Leaf* leaf = descend(key, nullptr);
+    size_t slot = upperIndex(leaf->keys, leaf->count, key);
+    if (slot == leaf->count) {
+        return std::make_pair(leaf->next, size_t(0));
+    }
+    return std::make_pair(leaf, slot);
+}
+
+// Keys sharing a prefix are contiguous in order: seek to lower_bound(prefix)
+// and stop at the first key past the prefix, O(log n + k)
+template<typename K, typename V, size_t Order, typename Compare>
+TreeRange<typename BTree<K, V, Order, Compare>::const_iterator> BTree<K, V, Order, Compare>::prefixRange(const K& prefix) const {
+    K upper;
+    if (!prefixUpperBound(prefix, upper)) {
+        return TreeRange<const_iterator>(lower_bound(prefix), end());
+    }
+    return TreeRange<const_iterator>(lower_bound(prefix), lower_bound(upper));
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+typename BTree<K, V, Order, Compare>::Leaf* BTree<K, V, Order, Compare>::firstLeaf() const {
+    NodeBase* node = root;
+    if (node == nullptr) {
+        return nullptr;
+    }
+    while (!node->isLeaf) {
+        node = static_cast<Inner*>(node)->children[0];
+    }
+    return static_cast<Leaf*>(node);
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+typename BTree<K, V, Order, Compare>::Leaf* BTree<K, V, Order, Compare>::lastLeaf() const {
+    NodeBase* node = root;
+    if (node == nullptr) {
+        return nullptr;
+    }
+    while (!node->isLeaf) {
+        Inner* inner = static_cast<Inner*>(node);
+        node = inner->children[inner->count];
+    }
+    return static_cast<Leaf*>(node);
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+size_t BTree<K, V, Order, Compare>::height() const {
+    size_t levels = 0;
+    for (NodeBase* node = root; node != nullptr; levels++) {
+        node = node->isLeaf ? nullptr : static_cast<Inner*>(node)->children[0];
+    }
+    return levels;
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+template<typename InputIt>
+void BTree<K, V, Order, Compare>::buildFromSorted(InputIt first, InputIt last) {
+    clear();
+    
+    // Fill leaves in key order, Order pairs each; the last two are evened
+    // out below so neither is under half full
+    std::vector<NodeBase*> level;
+    try {
+        Leaf* leaf = nullptr;
+        for (; first != last; ++first) {
+            if (leaf == nullptr || leaf->count == Order) {
+                Leaf* next = createLeaf();
+                next->prev = leaf;
+                if (leaf != nullptr) {
+                    leaf->next = next;
+                }
+                leaf = next;
+                level.push_back(leaf);
+            }
+            leaf->keys[leaf->count] = (*first).first;
+            leaf->values[leaf->count] = (*first).second;
+            leaf->count++;
+            size_++;
+        }
+    } catch (...) {
+        for (NodeBase* node : level) {
+            destroyNode(node);
+        }
+        size_ = 0;
+        throw;
+    }
+    if (level.empty()) {
+        return;
+    }
+    if (level.size() > 1) {
+        Leaf* tail = static_cast<Leaf*>(level.back());
+        Leaf* before = static_cast<Leaf*>(level[level.size() - 2]);
+        if (tail->count < MIN_LEAF_KEYS) {
+            // Shift pairs from the full leaf before it: both end up >= Order / 2
+            size_t total = before->count + tail->count;
+            size_t keep = total / 2;
+            size_t moved = before->count - keep;
+            for (size_t i = tail->count; i-- > 0;) {
+                tail->keys[i + moved] = std::move(tail->keys[i]);
+                tail->values[i + moved] = std::move(tail->values[i]);
+            }
+            for (size_t i = 0; i < moved; i++) {
+                tail->keys[i] = std::move(before->keys[keep + i]);
+                tail->values[i] = std::move(before->values[keep + i]);
+                before->keys[keep + i] = K();
+            }
+            before->count = keep;
+            tail->count += moved;
+        }
+    }
+    
+    // Each level above groups Order + 1 children per inner node (evened
+    // out the same way); a child's separator is its subtree's smallest key
+    std::vector<const K*> lowest;
+    for (NodeBase* node : level) {
+        lowest.push_back(&static_cast<Leaf*>(node)->keys[0]);
+    }
+    while (level.size() > 1) {
+        size_t groups = (level.size() + Order) / (Order + 1);
+        std::vector<NodeBase*> parents;
+        std::vector<const K*> parentLowest;
+        size_t next = 0;
+        for (size_t g = 0; g < groups; g++) {
+            size_t take = (level.size() - next) / (groups - g);
+            Inner* inner = createInner();
+            for (size_t i = 0; i < take; i++) {
+                inner->children[i] = level[next + i];
+                if (i > 0) {
+                    inner->keys[i - 1] = *lowest[next + i];
+                }
+            }
+            inner->count = take - 1;
+            parents.push_back(inner);
+            parentLowest.push_back(lowest[next]);
+            next += take;
+        }
+        level.swap(parents);
+        lowest.swap(parentLowest);
+    }
+    root = level[0];
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+std::vector<V> BTree<K, V, Order, Compare>::getAllValues() const {
+    std::vector<V> result;
+    result.reserve(size_);
+    for (Leaf* leaf = firstLeaf(); leaf != nullptr; leaf = leaf->next) {
+        result.insert(result.end(), leaf->values, leaf->values + leaf->count);
+    }
+    return result;
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+std::vector<std::pair<K, V>> BTree<K, V, Order, Compare>::getAllPairs() const {
+    std::vector<std::pair<K, V>> result;
+    result.reserve(size_);
+    for (Leaf* leaf = firstLeaf(); leaf != nullptr; leaf = leaf->next) {
+        for (size_t i = 0; i < leaf->count; i++) {
+            result.push_back(std::make_pair(leaf->keys[i], leaf->values[i]));
+        }
+    }
+    return result;
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+void BTree<K, V, Order, Compare>::clear() {
+    // Nodes with trivially destructible keys and values are not visited:
+    // both pools drop their slabs wholesale
+    if (root != nullptr && !(std::is_trivially_destructible<K>::value && std::is_trivially_destructible<V>::value)) {
+        std::vector<NodeBase*> stack(1, root);
+        while (!stack.empty()) {
+            NodeBase* node = stack.back();
+            stack.pop_back();
+            if (node->isLeaf) {
+                static_cast<Leaf*>(node)->~Leaf();
+            } else {
+                Inner* inner = static_cast<Inner*>(node);
+                stack.insert(stack.end(), inner->children, inner->children + inner->count + 1);
+                inner->~Inner();
+            }
+        }
+    }
+    leafPool.release();
+    innerPool.release();
+    root = nullptr;
+    size_ = 0;
+}
+
+template<typename K, typename V, size_t Order, typename Compare>
+void BTree<K, V, Order, Compare>::print() const {
+    std::cout << "B-Tree (size: " << size_ << ", order: " << Order << "):" << std::endl;
+    
+    // One line per node, children indented under their parent
+    std::vector<std::pair<NodeBase*, int>> stack;
+    if (root != nullptr) {
+        stack.push_back(std::make_pair(root, 0));
+    }
+    while (!stack.empty()) {
+        NodeBase* node = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+    
+        for (int i = 0; i < depth; i++) {
+            std::cout << "  ";
+        }
+        if (node->isLeaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            for (size_t i = 0; i < leaf->count; i++) {
+                std::cout << (i ? ", " : "") << leaf->keys[i] << " -> " << leaf->values[i];
+            }
+            std::cout << std::endl;
+        } else {
+            Inner* inner = static_cast<Inner*>(node);
+            std::cout << "[";
+            for (size_t i = 0; i < inner->count; i++) {
+                std::cout << (i ? " | " : "") << inner->keys[i];
+            }
+            std::cout << "]" << std::endl;
+            for (size_t i = inner->count + 1; i-- > 0;) {
+                stack.push_back(std::make_pair(inner->children[i], depth + 1));
+            }
+        }
+    }
+}
+
+#endif // B_TREE_H
@@ -0,0 +1,62 @@
+#ifndef BATCH_COMMAND_RUNNER_H
+#define BATCH_COMMAND_RUNNER_H
+
+#include "ContactManager.h"
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// 📜 Chế độ batch: đọc từng dòng lệnh từ stream (stdin hoặc file) và chạy trên ContactManager,
+// không menu, không xóa màn hình, không chờ Enter. Mỗi lệnh in đúng một dòng kết quả
+// ("ok ..." hoặc "error <dòng>: <lý do>"); search in thêm một dòng cho mỗi liên hệ tìm thấy.
+// Kết quả ghi vào out bằng '\n', không flush từng dòng. Trong lúc chạy, thông báo của manager
+// trên cout bị bỏ qua; lý do lỗi lấy từ ContactManager::getLastError().
+//
+//   add <tên>                         -> ok <id>
+//   set-phone <id|tên> <số|->         -> ok <id>      ("-" = xóa số điện thoại)
+//   set-email <id|tên> <email|->      -> ok <id>      ("-" = xóa email)
+//   remove <id|tên>                   -> ok <id>
+//   get <id|tên>                      -> ok <id>\t<tên>\t<số>\t<email>\t<địa chỉ>\t<ghi chú>
+//   search name|phone|email <chuỗi>   -> ok <n>, rồi n dòng <id>\t<tên>\t<số>\t<email> theo thứ tự ID
+//
+// Tham chiếu toàn chữ số là ID, còn lại là tên. Dòng trống và dòng bắt đầu bằng '#' được bỏ qua.
+class BatchCommandRunner {
+public:
+    struct Summary {
+        size_t commands;  // Số lệnh đã chạy (không tính dòng trống, chú thích)
+        size_t failures;  // Số lệnh trả về "error"
+    };
+    
+    explicit BatchCommandRunner(ContactManager* manager);
+    
+    Summary run(istream& in, ostream& out);
+
+private:
+    // Bỏ qua những gì manager in ra cout
+    class DiscardBuffer : public streambuf {
+    protected:
+        int overflow(int c) override;
+        streamsize xsputn(const char* s, streamsize n) override;
+    };
+    
+    ContactManager* manager;
+    DiscardBuffer messages;
+    string error;  // Lý do lỗi của lệnh vừa chạy
+    
+    bool execute(string_view line, ostream& out);
+    bool addContact(string_view args, ostream& out);
+    bool setField(string_view command, string_view args, ostream& out);
+    bool removeContact(string_view args, ostream& out);
+    bool getContact(string_view args, ostream& out);
+    bool search(string_view args, ostream& out);
+    
+    Contact* resolve(string_view ref);
+    bool fail(string reason);  // Ghi lý do, trả về false
+    bool failFromManager();    // Lý do lấy từ ContactManager::getLastError()
+};
+
+#endif
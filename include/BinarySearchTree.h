@@ -1,11 +1,28 @@
 #ifndef BINARY_SEARCH_TREE_H
 #define BINARY_SEARCH_TREE_H
 
+#include <functional>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <utility>
+#include <new>
+#include <type_traits>
+#include "TreeIterator.h"
+#include "KeyCompare.h"
+#include "NodePool.h"
+#include "ParallelTreeScan.h"
 
-template<typename K, typename V>
+// All operations are iterative: descents are plain loops and in-order walks
+// follow parent pointers, so a skewed tree (e.g. keys inserted in sorted
+// order) costs O(n) time per operation but never O(n) stack.
+//
+// Nodes come from Allocator<Node> (see NodePool.h); the default slab pool
+// keeps them contiguous and lets clear() drop whole slabs. Keys are ordered
+// by Compare, which must be a strict weak ordering (two keys are equal when
+// neither orders before the other); find/insert/remove descents make one
+// three-way comparison per node (see KeyCompare.h).
+template<typename K, typename V, template<typename> class Allocator = NodePool, typename Compare = std::less<K>>
 class BinarySearchTree {
 private:
     struct Node {
@@ -13,28 +30,52 @@ private:
         V value;
         Node* left;
         Node* right;
-        
-        Node(const K& k, const V& v) : key(k), value(v), left(nullptr), right(nullptr) {}
+        Node* parent;
+    
+        template<typename Key>
+        Node(Key&& k, const V& v, Node* p)
+            : key(std::forward<Key>(k)), value(v), left(nullptr), right(nullptr), parent(p) {}
     };
     
     Node* root;
     size_t size_;
+    Allocator<Node> pool;
+    Compare comp_;
+    
+    template<typename, typename, bool> friend class TreeIterator;
     
     // Helper methods
-    Node* insertRecursive(Node* node, const K& key, const V& value);
-    Node* findRecursive(Node* node, const K& key) const;
-    Node* removeRecursive(Node* node, const K& key);
+    template<typename Key>
+    Node* createNode(Key&& key, const V& value, Node* parent);
+    template<typename Key>
+    void insertKey(Key&& key, const V& value);
+    void destroyNode(Node* node);
+    template<typename Q>
+    Node* findNode(const Q& key) const;
     Node* findMin(Node* node) const;
-    void inorderTraversal(Node* node, std::vector<V>& result) const;
-    void clearRecursive(Node* node);
-    void printRecursive(Node* node, int depth) const;
+    Node* findMax(Node* node) const;
+    Node* successor(Node* node) const;
+    Node* predecessor(Node* node) const;
+    template<typename Q>
+    Node* lowerBoundNode(const Q& key) const;
+    template<typename Q>
+    Node* upperBoundNode(const Q& key) const;
+    void eraseNode(Node* z);
+    void transplant(Node* u, Node* v);
     
 public:
+    using iterator = TreeIterator<BinarySearchTree, Node, false>;
+    using const_iterator = TreeIterator<BinarySearchTree, Node, true>;
+    
     BinarySearchTree() : root(nullptr), size_(0) {}
     ~BinarySearchTree() { clear(); }
     
+    BinarySearchTree(const BinarySearchTree&) = delete;
+    BinarySearchTree& operator=(const BinarySearchTree&) = delete;
+    
     // Core operations
     void insert(const K& key, const V& value);
+    void insert(K&& key, const V& value);  // Moves key into the new node
     V* find(const K& key);
     const V* find(const K& key) const;
     bool remove(const K& key);
@@ -44,189 +85,473 @@ public:
     size_t size() const { return size_; }
     bool empty() const { return size_ == 0; }
     void clear();
+    
+    // Bulk load: replaces the contents with a perfectly balanced tree in O(n).
+    // [first, last) must yield pairs (first = key, second = value) in
+    // strictly increasing key order. Keys are copied, or moved when given
+    // move iterators (std::make_move_iterator).
+    template<typename InputIt>
+    void buildFromSorted(InputIt first, InputIt last);
+    
     std::vector<V> getAllValues() const;
     
     // Debug
     void print() const;
     
-    // Iterator-like functionality
+    // In-order iteration (no allocation, no copies of keys)
+    iterator begin() { return iterator(this, findMin(root)); }
+    iterator end() { return iterator(this, nullptr); }
+    const_iterator begin() const { return const_iterator(this, findMin(root)); }
+    const_iterator end() const { return const_iterator(this, nullptr); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    
+    // Ordered queries
+    iterator lower_bound(const K& key) { return iterator(this, lowerBoundNode(key)); }
+    iterator upper_bound(const K& key) { return iterator(this, upperBoundNode(key)); }
+    const_iterator lower_bound(const K& key) const { return const_iterator(this, lowerBoundNode(key)); }
+    const_iterator upper_bound(const K& key) const { return const_iterator(this, upperBoundNode(key)); }
+    TreeRange<const_iterator> range(const K& lo, const K& hi) const;  // keys in [lo, hi)
+    TreeRange<const_iterator> prefixRange(const K& prefix) const;    // string keys starting with prefix
+    
+    // Heterogeneous lookup, only when Compare is transparent (e.g.
+    // std::less<>): key may be any type Compare orders against K, such as a
+    // string_view or const char* against string keys, and no K is built.
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    V* find(const Q& key) {
+        Node* node = findNode(key);
+        return node != nullptr ? &(node->value) : nullptr;
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const V* find(const Q& key) const {
+        Node* node = findNode(key);
+        return node != nullptr ? &(node->value) : nullptr;
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const Q& key) const { return findNode(key) != nullptr; }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    bool remove(const Q& key) {
+        Node* z = findNode(key);
+        if (z == nullptr) {
+            return false;
+        }
+        eraseNode(z);
+        return true;
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    iterator lower_bound(const Q& key) { return iterator(this, lowerBoundNode(key)); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    iterator upper_bound(const Q& key) { return iterator(this, upperBoundNode(key)); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator lower_bound(const Q& key) const { return const_iterator(this, lowerBoundNode(key)); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator upper_bound(const Q& key) const { return const_iterator(this, upperBoundNode(key)); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    TreeRange<const_iterator> range(const Q& lo, const Q& hi) const {
+        if (!comp_(lo, hi)) {
+            return TreeRange<const_iterator>(end(), end());
+        }
+        return TreeRange<const_iterator>(lower_bound(lo), lower_bound(hi));
+    }
+    
+    // Snapshot copy of all pairs (prefer iterators for scans)
     std::vector<std::pair<K, V>> getAllPairs() const;
-    void getAllPairsRecursive(Node* node, std::vector<std::pair<K, V>>& result) const;
+    
+    // Values of the entries where pred(key, value) holds, in key order, with
+    // the walk spread over pool's threads (see ParallelTreeScan.h). pred is
+    // called from several threads at once; the tree must not change meanwhile.
+    template<typename Pred>
+    std::vector<V> parallelFilter(Pred pred, WorkStealingPool& pool = WorkStealingPool::shared()) const;
 };
 
 // Implementation
-template<typename K, typename V>
-typename BinarySearchTree<K, V>::Node* BinarySearchTree<K, V>::insertRecursive(Node* node, const K& key, const V& value) {
-    if (node == nullptr) {
-        return new Node(key, value);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void BinarySearchTree<K, V, Allocator, Compare>::insert(const K& key, const V& value) {
+    insertKey(key, value);
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void BinarySearchTree<K, V, Allocator, Compare>::insert(K&& key, const V& value) {
+    insertKey(std::move(key), value);
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Key>
+void BinarySearchTree<K, V, Allocator, Compare>::insertKey(Key&& key, const V& value) {
+    Node* parent = nullptr;
+    Node* node = root;
+    int order = 0;  // key vs parent->key, reused to link the new node
+    
+    while (node != nullptr) {
+        parent = node;
+        order = compareKeys(comp_, key, node->key);
+        if (order < 0) {
+            node = node->left;
+        } else if (order > 0) {
+            node = node->right;
+        } else {
+            // Key already exists, update value
+            node->value = value;
+            return;
+        }
     }
     
-    if (key < node->key) {
-        node->left = insertRecursive(node->left, key, value);
-    } else if (key > node->key) {
-        node->right = insertRecursive(node->right, key, value);
+    Node* z = createNode(std::forward<Key>(key), value, parent);
+    if (parent == nullptr) {
+        root = z;
+    } else if (order < 0) {
+        parent->left = z;
     } else {
-        // Key already exists, update value
-        node->value = value;
-        return node;
+        parent->right = z;
     }
-    
-    return node;
-}
-
-template<typename K, typename V>
-void BinarySearchTree<K, V>::insert(const K& key, const V& value) {
-    root = insertRecursive(root, key, value);
     size_++;
 }
 
-template<typename K, typename V>
-typename BinarySearchTree<K, V>::Node* BinarySearchTree<K, V>::findRecursive(Node* node, const K& key) const {
-    if (node == nullptr || node->key == key) {
-        return node;
-    }
-    
-    if (key < node->key) {
-        return findRecursive(node->left, key);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Q>
+typename BinarySearchTree<K, V, Allocator, Compare>::Node* BinarySearchTree<K, V, Allocator, Compare>::findNode(const Q& key) const {
+    Node* node = root;
+    while (node != nullptr) {
+        int order = compareKeys(comp_, key, node->key);
+        if (order < 0) {
+            node = node->left;
+        } else if (order > 0) {
+            node = node->right;
+        } else {
+            break;
+        }
     }
-    
-    return findRecursive(node->right, key);
+    return node;
 }
 
-template<typename K, typename V>
-V* BinarySearchTree<K, V>::find(const K& key) {
-    Node* node = findRecursive(root, key);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+V* BinarySearchTree<K, V, Allocator, Compare>::find(const K& key) {
+    Node* node = findNode(key);
     return node ? &(node->value) : nullptr;
 }
 
-template<typename K, typename V>
-const V* BinarySearchTree<K, V>::find(const K& key) const {
-    Node* node = findRecursive(root, key);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+const V* BinarySearchTree<K, V, Allocator, Compare>::find(const K& key) const {
+    Node* node = findNode(key);
     return node ? &(node->value) : nullptr;
 }
 
-template<typename K, typename V>
-bool BinarySearchTree<K, V>::contains(const K& key) const {
-    return findRecursive(root, key) != nullptr;
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+bool BinarySearchTree<K, V, Allocator, Compare>::contains(const K& key) const {
+    return findNode(key) != nullptr;
 }
 
-template<typename K, typename V>
-typename BinarySearchTree<K, V>::Node* BinarySearchTree<K, V>::findMin(Node* node) const {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+typename BinarySearchTree<K, V, Allocator, Compare>::Node* BinarySearchTree<K, V, Allocator, Compare>::findMin(Node* node) const {
     while (node && node->left) {
         node = node->left;
     }
     return node;
 }
 
-template<typename K, typename V>
-typename BinarySearchTree<K, V>::Node* BinarySearchTree<K, V>::removeRecursive(Node* node, const K& key) {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+typename BinarySearchTree<K, V, Allocator, Compare>::Node* BinarySearchTree<K, V, Allocator, Compare>::findMax(Node* node) const {
+    while (node && node->right) {
+        node = node->right;
+    }
+    return node;
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+typename BinarySearchTree<K, V, Allocator, Compare>::Node* BinarySearchTree<K, V, Allocator, Compare>::successor(Node* node) const {
+    if (node->right) {
+        return findMin(node->right);
+    }
+    
+    Node* parent = node->parent;
+    while (parent && node == parent->right) {
+        node = parent;
+        parent = parent->parent;
+    }
+    return parent;
+}
+
+// In-order predecessor; predecessor(nullptr) (i.e. of end()) is the maximum
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+typename BinarySearchTree<K, V, Allocator, Compare>::Node* BinarySearchTree<K, V, Allocator, Compare>::predecessor(Node* node) const {
     if (node == nullptr) {
-        return nullptr;
+        return findMax(root);
     }
     
-    if (key < node->key) {
-        node->left = removeRecursive(node->left, key);
-    } else if (key > node->key) {
-        node->right = removeRecursive(node->right, key);
-    } else {
-        // Node to delete found
-        
-        // Case 1: Node with only one child or no child
-        if (node->left == nullptr) {
-            Node* temp = node->right;
-            delete node;
-            return temp;
-        } else if (node->right == nullptr) {
-            Node* temp = node->left;
-            delete node;
-            return temp;
+    if (node->left) {
+        return findMax(node->left);
+    }
+    
+    Node* parent = node->parent;
+    while (parent && node == parent->left) {
+        node = parent;
+        parent = parent->parent;
+    }
+    return parent;
+}
+
+// First node whose key is not less than key
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Q>
+typename BinarySearchTree<K, V, Allocator, Compare>::Node* BinarySearchTree<K, V, Allocator, Compare>::lowerBoundNode(const Q& key) const {
+    Node* result = nullptr;
+    Node* node = root;
+    while (node != nullptr) {
+        if (comp_(node->key, key)) {
+            node = node->right;
+        } else {
+            result = node;
+            node = node->left;
+        }
+    }
+    return result;
+}
+
+// First node whose key is greater than key
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Q>
+typename BinarySearchTree<K, V, Allocator, Compare>::Node* BinarySearchTree<K, V, Allocator, Compare>::upperBoundNode(const Q& key) const {
+    Node* result = nullptr;
+    Node* node = root;
+    while (node != nullptr) {
+        if (comp_(key, node->key)) {
+            result = node;
+            node = node->left;
+        } else {
+            node = node->right;
         }
-        
-        // Case 2: Node with two children
-        Node* temp = findMin(node->right);
-        node->key = temp->key;
-        node->value = temp->value;
-        node->right = removeRecursive(node->right, temp->key);
+    }
+    return result;
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+TreeRange<typename BinarySearchTree<K, V, Allocator, Compare>::const_iterator> BinarySearchTree<K, V, Allocator, Compare>::range(const K& lo, const K& hi) const {
+    if (!comp_(lo, hi)) {
+        return TreeRange<const_iterator>(end(), end());
+    }
+    return TreeRange<const_iterator>(lower_bound(lo), lower_bound(hi));
+}
+
+// Keys sharing a prefix are contiguous in order: seek to lower_bound(prefix)
+// and stop at the first key past the prefix, O(log n + k)
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+TreeRange<typename BinarySearchTree<K, V, Allocator, Compare>::const_iterator> BinarySearchTree<K, V, Allocator, Compare>::prefixRange(const K& prefix) const {
+    K upper;
+    if (!prefixUpperBound(prefix, upper)) {
+        return TreeRange<const_iterator>(lower_bound(prefix), end());
+    }
+    return TreeRange<const_iterator>(lower_bound(prefix), lower_bound(upper));
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void BinarySearchTree<K, V, Allocator, Compare>::transplant(Node* u, Node* v) {
+    if (u->parent == nullptr) {
+        root = v;
+    } else if (u == u->parent->left) {
+        u->parent->left = v;
+    } else {
+        u->parent->right = v;
     }
     
-    return node;
+    if (v) {
+        v->parent = u->parent;
+    }
 }
 
-template<typename K, typename V>
-bool BinarySearchTree<K, V>::remove(const K& key) {
-    if (!contains(key)) {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+bool BinarySearchTree<K, V, Allocator, Compare>::remove(const K& key) {
+    Node* z = findNode(key);
+    if (z == nullptr) {
         return false;
     }
+    eraseNode(z);
+    return true;
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void BinarySearchTree<K, V, Allocator, Compare>::eraseNode(Node* z) {
+    if (z->left == nullptr) {
+        // Case 1: Node with only one child or no child
+        transplant(z, z->right);
+    } else if (z->right == nullptr) {
+        transplant(z, z->left);
+    } else {
+        // Case 2: Node with two children - relink the in-order successor
+        // into z's place (nodes are moved, never copied, so pointers
+        // handed out by find() stay valid for the other keys)
+        Node* y = findMin(z->right);
+        if (y->parent != z) {
+            transplant(y, y->right);
+            y->right = z->right;
+            y->right->parent = y;
+        }
+        transplant(z, y);
+        y->left = z->left;
+        y->left->parent = y;
+    }
     
-    root = removeRecursive(root, key);
+    destroyNode(z);
     size_--;
-    return true;
 }
 
-template<typename K, typename V>
-void BinarySearchTree<K, V>::inorderTraversal(Node* node, std::vector<V>& result) const {
-    if (node) {
-        inorderTraversal(node->left, result);
-        result.push_back(node->value);
-        inorderTraversal(node->right, result);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename InputIt>
+void BinarySearchTree<K, V, Allocator, Compare>::buildFromSorted(InputIt first, InputIt last) {
+    clear();
+    
+    // Allocate the nodes in key order first (adjacent keys end up adjacent
+    // in memory), then link them by repeatedly taking the middle element
+    std::vector<Node*> nodes;
+    try {
+        for (; first != last; ++first) {
+            nodes.push_back(createNode((*first).first, (*first).second, nullptr));
+        }
+    } catch (...) {
+        for (Node* node : nodes) {
+            destroyNode(node);
+        }
+        throw;
     }
+    
+    struct Span {
+        size_t lo;
+        size_t hi;
+        Node* parent;
+        bool isLeft;
+    };
+    
+    std::vector<Span> stack;
+    stack.push_back(Span{0, nodes.size(), nullptr, false});
+    while (!stack.empty()) {
+        Span span = stack.back();
+        stack.pop_back();
+        if (span.lo >= span.hi) {
+            continue;
+        }
+        
+        size_t mid = span.lo + (span.hi - span.lo) / 2;
+        Node* node = nodes[mid];
+        node->parent = span.parent;
+        if (span.parent == nullptr) {
+            root = node;
+        } else if (span.isLeft) {
+            span.parent->left = node;
+        } else {
+            span.parent->right = node;
+        }
+        
+        stack.push_back(Span{span.lo, mid, node, true});
+        stack.push_back(Span{mid + 1, span.hi, node, false});
+    }
+    size_ = nodes.size();
 }
 
-template<typename K, typename V>
-std::vector<V> BinarySearchTree<K, V>::getAllValues() const {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+std::vector<V> BinarySearchTree<K, V, Allocator, Compare>::getAllValues() const {
     std::vector<V> result;
-    inorderTraversal(root, result);
+    result.reserve(size_);
+    for (Node* node = findMin(root); node != nullptr; node = successor(node)) {
+        result.push_back(node->value);
+    }
     return result;
 }
 
-template<typename K, typename V>
-void BinarySearchTree<K, V>::getAllPairsRecursive(Node* node, std::vector<std::pair<K, V>>& result) const {
-    if (node) {
-        getAllPairsRecursive(node->left, result);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+std::vector<std::pair<K, V>> BinarySearchTree<K, V, Allocator, Compare>::getAllPairs() const {
+    std::vector<std::pair<K, V>> result;
+    result.reserve(size_);
+    for (Node* node = findMin(root); node != nullptr; node = successor(node)) {
         result.push_back(std::make_pair(node->key, node->value));
-        getAllPairsRecursive(node->right, result);
     }
+    return result;
 }
 
-template<typename K, typename V>
-std::vector<std::pair<K, V>> BinarySearchTree<K, V>::getAllPairs() const {
-    std::vector<std::pair<K, V>> result;
-    getAllPairsRecursive(root, result);
-    return result;
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Pred>
+std::vector<V> BinarySearchTree<K, V, Allocator, Compare>::parallelFilter(Pred pred, WorkStealingPool& pool) const {
+    auto keep = [&pred](const Node* node, std::vector<V>& out) {
+        if (pred(node->key, node->value)) {
+            out.push_back(node->value);
+        }
+    };
+    return parallelInOrder<V>(static_cast<const Node*>(root), static_cast<const Node*>(nullptr), pool, keep);
 }
 
-template<typename K, typename V>
-void BinarySearchTree<K, V>::clearRecursive(Node* node) {
-    if (node) {
-        clearRecursive(node->left);
-        clearRecursive(node->right);
-        delete node;
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Key>
+typename BinarySearchTree<K, V, Allocator, Compare>::Node* BinarySearchTree<K, V, Allocator, Compare>::createNode(Key&& key, const V& value, Node* parent) {
+    Node* node = pool.allocate();
+    try {
+        return new (node) Node(std::forward<Key>(key), value, parent);
+    } catch (...) {
+        pool.deallocate(node);
+        throw;
     }
 }
 
-template<typename K, typename V>
-void BinarySearchTree<K, V>::clear() {
-    clearRecursive(root);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void BinarySearchTree<K, V, Allocator, Compare>::destroyNode(Node* node) {
+    node->~Node();
+    pool.deallocate(node);
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void BinarySearchTree<K, V, Allocator, Compare>::clear() {
+    // Trivially destructible nodes in a pool are not visited at all: the
+    // slabs are dropped wholesale, O(slabs).
+    if (!Allocator<Node>::releasesAll || !std::is_trivially_destructible<Node>::value) {
+        // Rotate left subtrees away until the current node has no left child,
+        // then destroy it and continue down the right spine: O(n), O(1) space.
+        Node* node = root;
+        while (node != nullptr) {
+            if (node->left != nullptr) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                if (Allocator<Node>::releasesAll) {
+                    node->~Node();  // storage goes with the slabs below
+                } else {
+                    destroyNode(node);
+                }
+                node = right;
+            }
+        }
+    }
+    pool.release();
     root = nullptr;
     size_ = 0;
 }
 
-template<typename K, typename V>
-void BinarySearchTree<K, V>::printRecursive(Node* node, int depth) const {
-    if (node) {
-        printRecursive(node->right, depth + 1);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void BinarySearchTree<K, V, Allocator, Compare>::print() const {
+    std::cout << "Binary Search Tree (size: " << size_ << "):" << std::endl;
+    
+    // Reverse in-order (right, node, left) with an explicit stack
+    std::vector<std::pair<Node*, int>> stack;
+    Node* node = root;
+    int depth = 0;
+    while (node != nullptr || !stack.empty()) {
+        while (node != nullptr) {
+            stack.push_back(std::make_pair(node, depth));
+            node = node->right;
+            depth++;
+        }
+    
+        node = stack.back().first;
+        depth = stack.back().second;
+        stack.pop_back();
+    
         for (int i = 0; i < depth; i++) {
             std::cout << "  ";
         }
         std::cout << node->key << " -> " << node->value << std::endl;
-        printRecursive(node->left, depth + 1);
+    
+        node = node->left;
+        depth++;
     }
 }
 
-template<typename K, typename V>
-void BinarySearchTree<K, V>::print() const {
-    std::cout << "Binary Search Tree (size: " << size_ << "):" << std::endl;
-    printRecursive(root, 0);
-}
-
 #endif // BINARY_SEARCH_TREE_H
@@ -1,41 +1,70 @@
 #ifndef CONTACT_H
 #define CONTACT_H
 
+#include "ContactStore.h"
+#include <atomic>
 #include <string>
+#include <string_view>
 #include <set>
 
 using namespace std;
 
+// 🗄️ Các trường (tên, số điện thoại, email, địa chỉ, ghi chú) nằm trong các cột của
+// ContactStore; Contact chỉ giữ ID và handle. Bản thân các Contact được cấp phát liền
+// nhau theo slab (NodePool) của store thay vì mỗi liên hệ một lần new riêng.
 class Contact {
 private:
-    string name;
-    string phoneNumber;  // 🔑 Chỉ 1 số điện thoại duy nhất
-    string email;        // 🔑 Chỉ 1 email duy nhất
-    string address;
-    string notes;
     int id;
-    static int nextId;
+    ContactStore::Handle handle;  // Vị trí các trường trong ContactStore
+    static atomic<int> nextId;  // 🔒 Nguyên tử: cấp ID an toàn khi nhiều luồng tạo liên hệ
+    
+    // Chỉ tạo/xóa qua create/destroy: bản ghi nằm trong slab của store
+    Contact(string_view name, ContactStore* store);
+    Contact(int id, string_view name, ContactStore* store);
+    ~Contact();
 
 public:
-    Contact();
-    Contact(const string& name);
+    // 🗄️ store: nơi chứa các trường và slab chứa chính Contact (mỗi manager, mỗi shard có
+    // store riêng). Như các trường, slab được bảo vệ bởi khóa của manager sở hữu store.
+    static Contact* create(string_view name, ContactStore* store = ContactStore::getInstance());
+    static Contact* create(int id, string_view name, ContactStore* store);  // Khôi phục liên hệ với ID đã có (snapshot/WAL)
+    static void destroy(Contact* contact);  // Trả bản ghi về slab của store ghi trong handle
+    
+    Contact(const Contact&) = delete;
+    Contact& operator=(const Contact&) = delete;
     
-    // Getters
+    // ID allocation
+    static int getNextId();
+    static int allocateId();  // Lấy trước một ID mới (ShardedContactManager chọn shard theo ID)
+    static void reserveIdsUpTo(int id);  // Đảm bảo nextId > id
+    
+    // Getters: trỏ thẳng vào cột của ContactStore, không sao chép.
+    // ⚠️ Chỉ hợp lệ tới lần ghi tiếp theo vào cùng trường (của bất kỳ liên hệ nào):
+    // cần giữ lâu hơn thì sao chép sang string.
     int getId() const;
-    string getName() const;
-    string getPhoneNumber() const;  // 🔑 Lấy số điện thoại duy nhất
-    string getEmail() const;        // 🔑 Lấy email duy nhất
-    string getAddress() const;
-    string getNotes() const;
+    ContactStore::Handle getHandle() const { return handle; }
+    string_view getName() const;
+    string_view getPhoneNumber() const;  // 🔑 Lấy số điện thoại duy nhất
+    string_view getEmail() const;        // 🔑 Lấy email duy nhất
+    string_view getAddress() const;
+    string_view getNotes() const;
+    
+    // 🔎 Khóa tìm kiếm (TextSearch::foldKey): chữ thường, bỏ dấu tiếng Việt.
+    // Được ghi cùng lúc với tên/email nên tìm kiếm không phải chuẩn hóa lại.
+    // Số điện thoại đã hợp lệ chỉ gồm chữ số nên chính nó là khóa.
+    string_view getNameKey() const;
+    string_view getEmailKey() const;
     
-    // Setters
-    void setName(const string& name);
-    void setAddress(const string& address);
-    void setNotes(const string& notes);
+    // Setters: giá trị được chép thẳng vào cột, không qua string trung gian.
+    // ⚠️ Chỉ ghi ContactStore: không kiểm tra hợp lệ, không cập nhật index, không ghi WAL.
+    // Liên hệ do manager quản lý phải sửa qua renameContact/setContact* của manager.
+    void setName(string_view name);
+    void setAddress(string_view address);
+    void setNotes(string_view notes);
     
     // Phone and email management
-    void setPhoneNumber(const string& phone);  // 🔑 Set số điện thoại (thay thế)
-    void setEmail(const string& email);        // 🔑 Set email (thay thế)
+    void setPhoneNumber(string_view phone);  // 🔑 Set số điện thoại (thay thế)
+    void setEmail(string_view email);        // 🔑 Set email (thay thế)
     
     // Utility methods
     bool hasPhoneNumber() const;  // 🔑 Kiểm tra có số điện thoại không
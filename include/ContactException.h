@@ -43,4 +43,10 @@ public:
         : ContactException("Trường " + field + " không được để trống") {}
 };
 
+class StorageError : public ContactException {
+public:
+    StorageError(const string& detail) 
+        : ContactException("Lỗi lưu trữ: " + detail) {}
+};
+
 #endif
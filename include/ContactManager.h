@@ -5,30 +5,155 @@
 #include "ContactException.h"
 #include "BinarySearchTree.h"
 #include "RedBlackTree.h"
+#include "BTree.h"
+#include "HashIndex.h"
+#include "PackedPhoneIndex.h"
+#include "IdSlotTable.h"
+#include "NGramIndex.h"
+#include "WriteAheadLog.h"
+#include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <vector>
 
 using namespace std;
 
-class ContactManager {
+// 📥 Một dòng dữ liệu khi nhập hàng loạt (bulkImport)
+struct ContactRecord {
+    string name;
+    string phoneNumber;
+    string email;
+    string address;
+    string notes;
+};
+
+// 🔒 Khóa rỗng: ContactManager mặc định chỉ dùng từ một luồng nên không trả giá khóa
+struct NullSharedMutex {
+    void lock() {}
+    bool try_lock() { return true; }
+    void unlock() {}
+    void lock_shared() {}
+    bool try_lock_shared() { return true; }
+    void unlock_shared() {}
+};
+
+// 🔧 Chọn cấu trúc cho từng index lúc biên dịch (không dùng hàm ảo).
+// Name/Phone/Email: khóa string, cần insert/find/remove/contains/clear/size/empty, duyệt theo
+// thứ tự (entry.first/second), buildFromSorted và print; NameIndex cần thêm prefixRange.
+// Nên dùng less<> để tra cứu bằng string_view (giá trị trong ContactStore) không tạo string tạm.
+// Id: khóa int, cần insert/find/remove/contains/clear/size, duyệt và print.
+// BinarySearchTree, RedBlackTree, BTree và IdSlotTable (chỉ cho ID) đều thỏa giao diện này.
+// Lock: khóa đọc-ghi bảo vệ toàn bộ index (lock/unlock, lock_shared/unlock_shared).
+template<typename Name, typename Id, typename Phone, typename Email, typename Lock = NullSharedMutex>
+struct IndexPolicy {
+    typedef Name NameIndex;
+    typedef Id IdIndex;
+    typedef Phone PhoneIndex;
+    typedef Email EmailIndex;
+    typedef Lock LockType;
+};
+
+// Cùng các index với Policy, đổi kiểu khóa
+template<typename Policy, typename Lock>
+struct WithIndexLock : Policy {
+    typedef Lock LockType;
+};
+
+// Mặc định: BTree tìm nhanh hơn RBT từ ~100k khóa và duyệt nhanh hơn trên 10 lần (xem bench_btree);
+// ID cấp phát tăng dần nên bảng slot tra cứu O(1) (xem bench_id_lookup).
+typedef IndexPolicy<BinarySearchTree<string, Contact*, NodePool, less<>>,
+                    IdSlotTable<Contact*>,
+                    BTree<string, Contact*, BTreeDefaultOrder<string>::value, less<>>,
+                    BTree<string, Contact*, BTreeDefaultOrder<string>::value, less<>>> DefaultIndexPolicy;
+
+// 🔒 Chế độ đa luồng: nhiều luồng cùng đọc (findContact, searchBy*, search*Prefix, kiểm tra trùng,
+// canAdd*, display*, copyContact, saveSnapshot), các thao tác ghi chạy lần lượt. Một khóa đọc-ghi
+// chung cho mọi index: một thao tác ghi sửa tới 10 cấu trúc, người đọc không bao giờ thấy chúng lệch nhau.
+// ⚠️ Contact* trả về còn hợp lệ tới khi liên hệ bị xóa, nhưng các trường của nó nằm trong ContactStore
+// dùng chung: khi có luồng ghi, đọc trường bằng copyContact (dưới khóa đọc) thay vì contact->get*(),
+// và chỉ sửa liên hệ qua các hàm setContact*/renameContact của manager.
+typedef WithIndexLock<DefaultIndexPolicy, shared_mutex> ConcurrentIndexPolicy;
+
+// Định nghĩa các hàm thành viên nằm trong ContactManagerImpl.h
+template<typename Policy>
+class BasicContactManager {
 private:
-    static ContactManager* instance;
-    ContactManager();
+    // Mỗi shard của ShardedContactManager là một BasicContactManager với ContactStore riêng
+    friend class ShardedContactManager;
+    explicit BasicContactManager(ContactStore* store);
+    
+    typedef typename Policy::NameIndex NameIndex;
+    typedef typename Policy::IdIndex IdIndex;
+    typedef typename Policy::PhoneIndex PhoneIndex;
+    typedef typename Policy::EmailIndex EmailIndex;
+    
+    // 🔒 Hàm public lấy khóa rồi gọi phần thân; bên trong manager chỉ gọi các hàm *Locked
+    // (người gọi đã giữ khóa), không bao giờ lấy khóa lần hai
+    typedef typename Policy::LockType LockType;
+    typedef shared_lock<LockType> ReadGuard;
+    typedef unique_lock<LockType> WriteGuard;
+    mutable LockType indexLock;
+    
+    ContactStore* store;  // Nơi chứa trường của các liên hệ do manager này tạo
     
     // Main data structures using custom implementations
-    BinarySearchTree<string, Contact*> contactsByName;  // Sorted by name
-    RedBlackTree<string, Contact*> contactsByPhone;    // Phone number -> Contact (balanced)
-    RedBlackTree<string, Contact*> contactsByEmail;    // Email -> Contact (balanced)
-    BinarySearchTree<int, Contact*> contactsById;      // ID -> Contact
+    NameIndex contactsByName;            // Sorted by name
+    PhoneIndex contactsByPhone;          // Phone number -> Contact
+    EmailIndex contactsByEmail;          // Email -> Contact
+    IdIndex contactsById;                // ID -> Contact
+    
+    // Prefix search on normalized keys
+    typedef PackedPhoneIndex<Contact*> PhoneDigitsIndex;
+    RedBlackTree<string, Contact*> contactsByNameKey;  // name key + '\0' + name -> Contact
+    PhoneDigitsIndex contactsByPhoneDigits;            // phone packed 4 bits/digit -> Contact (prefix, contains)
+    
+    // 🔑 Tra cứu chính xác O(1) cho kiểm tra trùng lặp; luôn cùng nội dung với contactsByPhone/contactsByEmail
+    // (cây vẫn dùng cho duyệt theo thứ tự, snapshot và tìm tiền tố)
+    typedef HashIndex<string, Contact*, StringHash, equal_to<>> ExactIndex;
+    ExactIndex phoneLookup;  // phone -> owner
+    ExactIndex emailLookup;  // email -> owner
+    
+    // Trigram indexes for substring search (contact IDs, resolved via contactsById)
+    NGramIndex nameGrams;   // lowercase names
+    NGramIndex phoneGrams;  // digits-only phones
+    NGramIndex emailGrams;  // lowercase emails
+    
+    // 💾 Durable storage (openStorage): every mutation is logged before it is applied
+    WriteAheadLog* wal;     // nullptr = không ghi log
+    
+    static thread_local string lastError;  // Lý do thất bại gần nhất của luồng này
+    static void reportError(const ContactException& e);  // Ghi lastError, in " Lỗi: ..." như trước
+    WalOptions walOptions;
+    string snapshotPath;
     
     // Helper methods
     void removeFromIndexes(Contact* contact);
     void addToIndexes(Contact* contact);
-    void updatePhoneIndex(Contact* contact, const string& oldPhone, const string& newPhone);
-    void updateEmailIndex(Contact* contact, const string& oldEmail, const string& newEmail);
+    void updatePhoneIndex(Contact* contact, string_view newPhone);  // Bỏ số cũ khỏi index, ghi số mới, index lại
+    void updateEmailIndex(Contact* contact, string_view newEmail);
+    void indexPhone(Contact* contact, string_view phone);
+    void unindexPhone(Contact* contact, string_view phone);
+    void indexEmail(Contact* contact, string_view email);
+    void unindexEmail(Contact* contact, string_view email);
+    void logMutation(WriteAheadLog::Op op, int id, const string& value = "");
+    void applyLogRecord(const WriteAheadLog::Record& record);
+    uint64_t restoreSnapshot(const string& path);
+    
+    Contact* findContactLocked(int id) const;
+    bool isPhoneNumberDuplicateLocked(string_view phone, Contact* excludeContact) const;
+    bool isEmailDuplicateLocked(string_view email, Contact* excludeContact) const;
+    bool renameContactLocked(Contact* contact, const string& newName);
+    bool setContactPhoneLocked(Contact* contact, const string& phone);
+    bool setContactEmailLocked(Contact* contact, const string& email);
+    bool saveSnapshotLocked(const string& path) const;
+    bool checkpointLocked();
+    bool saveImportLocked();  // Snapshot sau bulkImport; false nếu snapshot chưa ghi được
+    void clearAllLocked();
 
 public:
-    static ContactManager* getInstance();
+    static BasicContactManager* getInstance();
     
     // Core operations
     bool addContact(const string& name);
@@ -36,12 +161,39 @@ public:
     bool removeContact(const string& name);
     Contact* findContact(int id);
     Contact* findContact(const string& name);
+    bool copyContact(int id, ContactRecord& out) const;  // Sao chép các trường (an toàn khi có luồng ghi)
+    
+    // ❗ Lý do (e.what()) của thao tác gần nhất trả về false trên luồng đang gọi, "" nếu chưa có.
+    // Riêng cho từng luồng nên luồng khác không ghi đè; người gọi không cần đọc lại cout.
+    static const string& getLastError();
+    
+    // 📥 Nhập hàng loạt: mỗi index sắp xếp khóa một lần rồi dựng lại cây O(n) bằng buildFromSorted.
+    // Bỏ qua bản ghi có tên rỗng/trùng; số điện thoại, email không hợp lệ hoặc trùng thì bị bỏ trống.
+    // Khi storage đang mở, lô được lưu bằng một snapshot; không lưu được thì cả lô bị hủy,
+    // trả về 0 và lý do nằm trong getLastError().
+    size_t bulkImport(const vector<ContactRecord>& records);  // Trả về số liên hệ đã nhập
+    
+    // 🔑 Cập nhật thông tin: kiểm tra hợp lệ/trùng, cập nhật mọi index và ghi WAL cùng lúc
+    bool renameContact(Contact* contact, const string& newName);
+    bool setContactPhone(Contact* contact, const string& phone);  // "" = xóa số điện thoại
+    bool setContactEmail(Contact* contact, const string& email);  // "" = xóa email
+    bool setContactAddress(Contact* contact, const string& address);
+    bool setContactNotes(Contact* contact, const string& notes);
     
     // Search operations
     set<Contact*> searchByName(const string& name);
     set<Contact*> searchByPhone(const string& phone);
     set<Contact*> searchByEmail(const string& email);
     
+    // 🔍 Prefix search (autocomplete): O(log n + k), results in key order, limit 0 = no limit
+    vector<Contact*> searchByNamePrefix(const string& prefix, bool ignoreCase = true, size_t limit = 0) const;
+    vector<Contact*> searchByPhonePrefix(const string& prefix, size_t limit = 0) const;  // digits only, formatting ignored
+    
+    // Normalized forms of queries, matching the stored search keys
+    static string normalizeName(string_view name);    // TextSearch::foldKey (lowercase, no diacritics)
+    static string normalizePhone(string_view phone);  // digits only
+    static string normalizeEmail(string_view email);  // TextSearch::foldKey
+    
     // Display operations
     void displayAllContacts() const;
     void displayContact(int id) const;
@@ -52,25 +204,39 @@ public:
     bool isEmpty() const;
     
     // Cleanup
-    ~ContactManager();
+    ~BasicContactManager();
     void clearAll();
     
-    // 🔧 Debug và sửa chữa
-    void syncAllIndexes(Contact* contact);  // ⚠️ QUAN TRỌNG: Đồng bộ tất cả index
+    // 💾 Persistence: binary snapshot (xem ContactSnapshot.h)
+    bool saveSnapshot(const string& path) const;
+    bool loadSnapshot(const string& path);  // Thay thế toàn bộ danh bạ hiện tại
+    
+    // 💾 Persistence: snapshot + write-ahead log (xem WriteAheadLog.h)
+    bool openStorage(const string& snapshotPath, const string& walPath, const WalOptions& options = WalOptions());
+    bool checkpoint();    // Ghi snapshot mới rồi cắt WAL
+    bool closeStorage();  // Checkpoint rồi đóng WAL; false nếu storage chưa mở hoặc checkpoint lỗi
+    WriteAheadLog* writeAheadLog() const { return wal; }  // Thống kê, sync() thủ công
     
     // 🔑 Public validation methods
     bool canAddPhoneNumber(const string& phone, Contact* excludeContact = nullptr) const;
     bool canAddEmail(const string& email, Contact* excludeContact = nullptr) const;
     
     // 🔑 Validation methods for duplicate checking
-    bool isPhoneNumberDuplicate(const string& phone, Contact* excludeContact = nullptr) const;
-    bool isEmailDuplicate(const string& email, Contact* excludeContact = nullptr) const;
-    bool isPhoneNumberValid(const string& phone) const;  // Check length and format
-    bool isValidPhone(const string& phone) const;
-    bool isValidEmail(const string& email) const;
+    bool isPhoneNumberDuplicate(string_view phone, Contact* excludeContact = nullptr) const;
+    bool isEmailDuplicate(string_view email, Contact* excludeContact = nullptr) const;
+    bool isPhoneNumberValid(string_view phone) const;  // Check length and format (FieldValidator)
+    bool isValidPhone(string_view phone) const;
+    bool isValidEmail(string_view email) const;
     
     // 🔍 Debug methods for tree visualization
     void printTreeStructures() const;
 };
 
+typedef BasicContactManager<DefaultIndexPolicy> ContactManager;
+typedef BasicContactManager<ConcurrentIndexPolicy> ConcurrentContactManager;
+
+// Biên dịch sẵn một lần trong ContactManager.cpp
+extern template class BasicContactManager<DefaultIndexPolicy>;
+extern template class BasicContactManager<ConcurrentIndexPolicy>;
+
 #endif
@@ -0,0 +1,1301 @@
+#ifndef CONTACT_MANAGER_IMPL_H
+#define CONTACT_MANAGER_IMPL_H
+
+// Member definitions of BasicContactManager. Only translation units that
+// instantiate the manager with their own IndexPolicy include this header;
+// ContactManager (the default policy) is instantiated once in ContactManager.cpp.
+
+#include "ContactManager.h"
+#include "ContactSnapshot.h"
+#include "FieldValidator.h"
+#include "TextSearch.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+namespace manager_detail {
+
+// 🔤 Chuẩn hóa truy vấn số điện thoại: chỉ giữ chữ số, nối vào cuối out
+inline void appendDigits(string& out, string_view text) {
+    for (char c : text) {
+        if (isdigit(static_cast<unsigned char>(c))) {
+            out.push_back(c);
+        }
+    }
+}
+
+// 🔑 Khóa cho index tiền tố tên: khóa tìm kiếm của liên hệ + '\0' + tên gốc
+// (tên gốc giữ cho khóa duy nhất khi hai tên chỉ khác hoa/thường hoặc dấu)
+inline string nameKey(const Contact* contact) {
+    string_view folded = contact->getNameKey();
+    string_view name = contact->getName();
+    string key;
+    key.reserve(folded.size() + 1 + name.size());
+    key += folded;
+    key.push_back('\0');
+    key += name;
+    return key;
+}
+
+// 🔑 Khóa nén của số điện thoại đã được kiểm tra hợp lệ (chỉ gồm chữ số, tối đa 11 số)
+inline PackedPhoneIndex<Contact*>::Key packedPhone(string_view phone) {
+    PackedPhoneIndex<Contact*>::Key key;
+    if (!PackedPhoneIndex<Contact*>::pack(phone, key)) {
+        throw StorageError("số điện thoại không hợp lệ: " + string(phone));
+    }
+    return key;
+}
+
+// 💾 Build one tree index from a snapshot run (record positions already in key order);
+// keyOf returns the index's key type
+template<typename Tree, typename KeyFn>
+void buildFromRun(Tree& tree, const ContactSnapshot& snapshot, ContactSnapshot::Run run,
+                  const vector<Contact*>& contacts, KeyFn keyOf) {
+    size_t length = snapshot.runLength(run);
+    const uint32_t* positions = snapshot.run(run);
+    
+    vector<pair<decltype(keyOf(contacts[0])), Contact*>> entries;
+    entries.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+        Contact* contact = contacts[positions[i]];
+        entries.emplace_back(keyOf(contact), contact);
+        // buildFromSorted trusts the order, so a corrupt run must not get through
+        if (i > 0 && !(entries[i - 1].first < entries[i].first)) {
+            throw StorageError("chỉ mục trong snapshot không đúng thứ tự");
+        }
+    }
+    tree.buildFromSorted(make_move_iterator(entries.begin()), make_move_iterator(entries.end()));
+}
+
+// 📥 Rebuild a tree index with extra entries: the new entries are sorted
+// (skipped when already in order), merged with the existing in-order keys
+// in one linear pass and the result is bulk-built balanced.
+// Keys in added must not already be in the tree; added is consumed.
+template<typename Tree, typename Key>
+void rebuildWith(Tree& tree, vector<pair<Key, Contact*>>& added) {
+    auto byKey = [](const pair<Key, Contact*>& a, const pair<Key, Contact*>& b) { return a.first < b.first; };
+    if (!is_sorted(added.begin(), added.end(), byKey)) {
+        sort(added.begin(), added.end(), byKey);
+    }
+    
+    if (tree.empty()) {
+        tree.buildFromSorted(make_move_iterator(added.begin()), make_move_iterator(added.end()));
+        return;
+    }
+    
+    vector<pair<Key, Contact*>> merged;
+    merged.reserve(tree.size() + added.size());
+    auto next = added.begin();
+    for (const auto& entry : tree) {
+        while (next != added.end() && next->first < entry.first) {
+            merged.push_back(move(*next++));
+        }
+        merged.emplace_back(entry.first, entry.second);
+    }
+    merged.insert(merged.end(), make_move_iterator(next), make_move_iterator(added.end()));
+    tree.buildFromSorted(make_move_iterator(merged.begin()), make_move_iterator(merged.end()));
+}
+
+// Record positions ordered by one field; stable, so the first occurrence of
+// a duplicate comes first and is the one kept
+template<typename FieldFn>
+vector<size_t> sortedPositions(const vector<size_t>& positions, FieldFn field) {
+    vector<size_t> sorted = positions;
+    stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) { return field(a) < field(b); });
+    return sorted;
+}
+
+// Collect the contacts of a prefix range in key order
+template<typename Tree>
+void collectPrefix(const Tree& tree, const string& prefix, size_t limit, vector<Contact*>& results) {
+    for (const auto& entry : tree.prefixRange(prefix)) {
+        if (limit != 0 && results.size() >= limit) {
+            break;
+        }
+        results.push_back(entry.second);
+    }
+}
+
+} // namespace manager_detail
+
+template<typename Policy>
+BasicContactManager<Policy>::BasicContactManager(ContactStore* store) : store(store), wal(nullptr) {}
+
+// 🔒 Khởi tạo static cục bộ an toàn luồng (C++11); không bao giờ delete, như trước.
+// Mỗi loại manager có ContactStore riêng: quét cột (tìm chuỗi ngắn hơn trigram)
+// chỉ thấy liên hệ của chính manager này
+template<typename Policy>
+BasicContactManager<Policy>* BasicContactManager<Policy>::getInstance() {
+    static BasicContactManager* instance = new BasicContactManager(ContactStore::create());
+    return instance;
+}
+
+template<typename Policy>
+thread_local string BasicContactManager<Policy>::lastError;
+
+template<typename Policy>
+const string& BasicContactManager<Policy>::getLastError() {
+    return lastError;
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::reportError(const ContactException& e) {
+    lastError = e.what();
+    cout << " Lỗi: " << lastError << endl;
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::addContact(const string& name) {
+    WriteGuard guard(indexLock);
+    try {
+        if (name.empty()) {
+            throw EmptyInput("tên");
+        }
+        
+        if (contactsByName.contains(name)) {
+            throw ContactAlreadyExists(name);
+        }
+        
+        // ID lấy trước: nextId dùng chung với mọi manager/shard, luồng khác có thể lấy
+        // ID giữa lúc ghi log và lúc tạo liên hệ
+        int id = Contact::allocateId();
+        logMutation(WriteAheadLog::OP_ADD, id, name);
+        Contact* newContact = Contact::create(id, name, store);
+        addToIndexes(newContact);
+        
+        cout << " Liên hệ '" << name << "' đã được thêm thành công với ID: " << newContact->getId() << endl;
+        // Chỉ in khi thêm từng liên hệ; phát lại WAL, bulkImport và shard thì im lặng
+        cout << "  📊 Index sizes - Names: " << contactsByName.size() 
+             << ", IDs: " << contactsById.size() 
+             << ", Phones: " << contactsByPhone.size() 
+             << ", Emails: " << contactsByEmail.size() << endl;
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+size_t BasicContactManager<Policy>::bulkImport(const vector<ContactRecord>& records) {
+    WriteGuard guard(indexLock);
+    
+    // 1. Tên: sắp xếp một lần, bản ghi trùng (trong lô hoặc với danh bạ) bị bỏ qua
+    vector<size_t> all(records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        all[i] = i;
+    }
+    
+    vector<bool> accepted(records.size(), false);
+    vector<size_t> byName = manager_detail::sortedPositions(all, [&](size_t i) -> const string& { return records[i].name; });
+    vector<size_t> acceptedByName;
+    acceptedByName.reserve(records.size());
+    for (size_t i : byName) {
+        const string& name = records[i].name;
+        if (name.empty() || (!acceptedByName.empty() && records[acceptedByName.back()].name == name) ||
+            contactsByName.contains(name)) {
+            continue;
+        }
+        accepted[i] = true;
+        acceptedByName.push_back(i);
+    }
+    
+    // 2. Số điện thoại / email: giá trị không hợp lệ hoặc trùng thì để trống
+    vector<size_t> kept;
+    kept.reserve(acceptedByName.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        if (accepted[i]) {
+            kept.push_back(i);
+        }
+    }
+    
+    size_t droppedFields = 0;
+    vector<size_t> phoneOrder;
+    for (size_t i : manager_detail::sortedPositions(kept, [&](size_t i) -> const string& { return records[i].phoneNumber; })) {
+        const string& phone = records[i].phoneNumber;
+        if (phone.empty()) {
+            continue;
+        }
+        if (!isPhoneNumberValid(phone) || (!phoneOrder.empty() && records[phoneOrder.back()].phoneNumber == phone) ||
+            phoneLookup.contains(phone)) {
+            droppedFields++;
+            continue;
+        }
+        phoneOrder.push_back(i);
+    }
+    
+    vector<size_t> emailOrder;
+    for (size_t i : manager_detail::sortedPositions(kept, [&](size_t i) -> const string& { return records[i].email; })) {
+        const string& email = records[i].email;
+        if (email.empty()) {
+            continue;
+        }
+        if (!isValidEmail(email) || (!emailOrder.empty() && records[emailOrder.back()].email == email) ||
+            emailLookup.contains(email)) {
+            droppedFields++;
+            continue;
+        }
+        emailOrder.push_back(i);
+    }
+    
+    // 3. Tạo liên hệ theo thứ tự đầu vào (ID tăng dần)
+    vector<Contact*> created(records.size(), nullptr);
+    for (size_t i : kept) {
+        created[i] = Contact::create(records[i].name, store);
+        created[i]->setAddress(records[i].address);
+        created[i]->setNotes(records[i].notes);
+    }
+    for (size_t i : phoneOrder) {
+        created[i]->setPhoneNumber(records[i].phoneNumber);
+    }
+    for (size_t i : emailOrder) {
+        created[i]->setEmail(records[i].email);
+    }
+    
+    // 4. Dựng lại các cây từ khóa đã sắp xếp
+    vector<pair<string, Contact*>> entries;
+    entries.reserve(kept.size());
+    for (size_t i : acceptedByName) {
+        entries.emplace_back(records[i].name, created[i]);
+    }
+    manager_detail::rebuildWith(contactsByName, entries);
+    
+    entries.clear();
+    for (size_t i : acceptedByName) {
+        entries.emplace_back(manager_detail::nameKey(created[i]), created[i]);
+    }
+    manager_detail::rebuildWith(contactsByNameKey, entries);  // Thứ tự khóa tìm kiếm khác thứ tự tên: sắp xếp lần nữa
+    
+    entries.clear();
+    for (size_t i : phoneOrder) {
+        entries.emplace_back(records[i].phoneNumber, created[i]);
+    }
+    manager_detail::rebuildWith(contactsByPhone, entries);
+    phoneLookup.reserve(phoneLookup.size() + phoneOrder.size());
+    for (size_t i : phoneOrder) {
+        phoneLookup.insert(records[i].phoneNumber, created[i]);
+    }
+    
+    // Số hợp lệ chỉ gồm chữ số: khóa nén cùng thứ tự với contactsByPhone
+    vector<pair<PhoneDigitsIndex::Key, Contact*>> packed;
+    packed.reserve(phoneOrder.size());
+    for (size_t i : phoneOrder) {
+        packed.emplace_back(manager_detail::packedPhone(records[i].phoneNumber), created[i]);
+    }
+    manager_detail::rebuildWith(contactsByPhoneDigits, packed);
+    
+    entries.clear();
+    for (size_t i : emailOrder) {
+        entries.emplace_back(records[i].email, created[i]);
+    }
+    manager_detail::rebuildWith(contactsByEmail, entries);
+    emailLookup.reserve(emailLookup.size() + emailOrder.size());
+    for (size_t i : emailOrder) {
+        emailLookup.insert(records[i].email, created[i]);
+    }
+    
+    // 5. ID và trigram theo thứ tự ID: chỉ nối thêm vào cuối
+    for (size_t i : kept) {
+        Contact* contact = created[i];
+        contactsById.insert(contact->getId(), contact);
+        nameGrams.add(contact->getId(), contact->getNameKey());
+        if (!contact->getPhoneNumber().empty()) {
+            phoneGrams.add(contact->getId(), contact->getPhoneNumber());
+        }
+        if (!contact->getEmail().empty()) {
+            emailGrams.add(contact->getId(), contact->getEmailKey());
+        }
+    }
+    
+    // 6. Lô nhập không đi qua WAL: một snapshot làm nó bền vững trong một lần ghi.
+    // Không ghi được snapshot thì gỡ cả lô, để danh bạ trong bộ nhớ không hơn trên đĩa
+    if (wal != nullptr && !kept.empty() && !saveImportLocked()) {
+        for (size_t i : kept) {
+            removeFromIndexes(created[i]);
+            Contact::destroy(created[i]);
+        }
+        cout << " Đã hủy lô nhập " << kept.size() << " liên hệ: không lưu được vào " << snapshotPath << endl;
+        return 0;
+    }
+    
+    cout << " Đã nhập " << kept.size() << "/" << records.size() << " liên hệ";
+    if (droppedFields != 0) {
+        cout << " (bỏ " << droppedFields << " số điện thoại/email không hợp lệ hoặc trùng)";
+    }
+    cout << endl;
+    return kept.size();
+}
+
+// Như checkpointLocked, nhưng chỉ lỗi khi snapshot chưa ghi được: nếu cắt WAL lỗi sau đó,
+// snapshot đã chứa cả lô (các bản ghi WAL cũ được bỏ qua theo số thứ tự khi mở lại)
+template<typename Policy>
+bool BasicContactManager<Policy>::saveImportLocked() {
+    bool saved = false;
+    try {
+        wal->sync();
+        saved = saveSnapshotLocked(snapshotPath);
+        if (saved) {
+            wal->reset();
+        }
+    } catch (const ContactException& e) {
+        reportError(e);
+    }
+    return saved;
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::removeContact(int id) {
+    WriteGuard guard(indexLock);
+    try {
+        Contact** contactPtr = contactsById.find(id);
+        if (contactPtr == nullptr) {
+            throw ContactNotFound("ID " + to_string(id));
+        }
+        
+        Contact* contact = *contactPtr;
+        logMutation(WriteAheadLog::OP_REMOVE, id);
+        removeFromIndexes(contact);
+        
+        // Tên nằm trong ContactStore: in trước khi delete thay vì sao chép
+        cout << " Liên hệ '" << contact->getName() << "' (ID: " << id << ") đã được xóa thành công!" << endl;
+        Contact::destroy(contact);
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::removeContact(const string& name) {
+    WriteGuard guard(indexLock);
+    try {
+        Contact** contactPtr = contactsByName.find(name);
+        if (contactPtr == nullptr) {
+            throw ContactNotFound(name);
+        }
+        
+        Contact* contact = *contactPtr;
+        int id = contact->getId();
+        logMutation(WriteAheadLog::OP_REMOVE, id);
+        removeFromIndexes(contact);
+        Contact::destroy(contact);
+        
+        cout << " Liên hệ '" << name << "' (ID: " << id << ") đã được xóa thành công!" << endl;
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+Contact* BasicContactManager<Policy>::findContact(int id) {
+    ReadGuard guard(indexLock);
+    return findContactLocked(id);
+}
+
+template<typename Policy>
+Contact* BasicContactManager<Policy>::findContactLocked(int id) const {
+    Contact* const* contactPtr = contactsById.find(id);
+    return contactPtr ? *contactPtr : nullptr;
+}
+
+template<typename Policy>
+Contact* BasicContactManager<Policy>::findContact(const string& name) {
+    ReadGuard guard(indexLock);
+    Contact** contactPtr = contactsByName.find(name);
+    return contactPtr ? *contactPtr : nullptr;
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::copyContact(int id, ContactRecord& out) const {
+    ReadGuard guard(indexLock);
+    Contact* contact = findContactLocked(id);
+    if (contact == nullptr) {
+        return false;
+    }
+    
+    out.name.assign(contact->getName());
+    out.phoneNumber.assign(contact->getPhoneNumber());
+    out.email.assign(contact->getEmail());
+    out.address.assign(contact->getAddress());
+    out.notes.assign(contact->getNotes());
+    return true;
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::renameContact(Contact* contact, const string& newName) {
+    WriteGuard guard(indexLock);
+    return renameContactLocked(contact, newName);
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::renameContactLocked(Contact* contact, const string& newName) {
+    try {
+        if (newName.empty()) {
+            throw EmptyInput("tên");
+        }
+        
+        if (newName == contact->getName()) {
+            return true;
+        }
+        
+        if (contactsByName.contains(newName)) {
+            throw ContactAlreadyExists(newName);
+        }
+        
+        // Khóa cũ được bỏ khỏi index trước setName (getName/getNameKey hết hợp lệ sau đó)
+        logMutation(WriteAheadLog::OP_RENAME, contact->getId(), newName);
+        contactsByName.remove(contact->getName());
+        contactsByNameKey.remove(manager_detail::nameKey(contact));
+        nameGrams.remove(contact->getId(), contact->getNameKey());
+        contact->setName(newName);
+        contactsByName.insert(newName, contact);
+        contactsByNameKey.insert(manager_detail::nameKey(contact), contact);
+        nameGrams.add(contact->getId(), contact->getNameKey());
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::setContactPhone(Contact* contact, const string& phone) {
+    WriteGuard guard(indexLock);
+    return setContactPhoneLocked(contact, phone);
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::setContactPhoneLocked(Contact* contact, const string& phone) {
+    try {
+        if (!phone.empty() && !isPhoneNumberValid(phone)) {
+            throw InvalidInput("số điện thoại");
+        }
+        
+        if (!phone.empty() && isPhoneNumberDuplicateLocked(phone, contact)) {
+            throw ContactException("Số điện thoại đã tồn tại trong liên hệ khác: " + phone);
+        }
+        
+        logMutation(WriteAheadLog::OP_SET_PHONE, contact->getId(), phone);
+        updatePhoneIndex(contact, phone);
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::setContactEmail(Contact* contact, const string& email) {
+    WriteGuard guard(indexLock);
+    return setContactEmailLocked(contact, email);
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::setContactEmailLocked(Contact* contact, const string& email) {
+    try {
+        if (!email.empty() && !isValidEmail(email)) {
+            throw InvalidInput("email");
+        }
+        
+        if (!email.empty() && isEmailDuplicateLocked(email, contact)) {
+            throw ContactException("Email đã tồn tại trong liên hệ khác: " + email);
+        }
+        
+        logMutation(WriteAheadLog::OP_SET_EMAIL, contact->getId(), email);
+        updateEmailIndex(contact, email);
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::setContactAddress(Contact* contact, const string& address) {
+    WriteGuard guard(indexLock);
+    try {
+        logMutation(WriteAheadLog::OP_SET_ADDRESS, contact->getId(), address);
+        contact->setAddress(address);
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::setContactNotes(Contact* contact, const string& notes) {
+    WriteGuard guard(indexLock);
+    try {
+        logMutation(WriteAheadLog::OP_SET_NOTES, contact->getId(), notes);
+        contact->setNotes(notes);
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+set<Contact*> BasicContactManager<Policy>::searchByName(const string& name) {
+    ReadGuard guard(indexLock);
+    set<Contact*> results;
+    
+    // If input is empty, return empty results
+    if (name.empty()) {
+        return results;
+    }
+    
+    // Fold the query like the stored keys (lowercase, no Vietnamese diacritics)
+    string foldedName = normalizeName(name);
+    
+    // Trigram candidates, verified against the precomputed name key
+    vector<int> ids;
+    if (nameGrams.candidates(foldedName, ids)) {
+        for (int id : ids) {
+            Contact* contact = findContactLocked(id);
+            if (contact && contact->getNameKey().find(foldedName) != string_view::npos) {
+                results.insert(contact);
+            }
+        }
+        return results;
+    }
+    
+    // Query shorter than a trigram: scan the name key column, no per-entry folding
+    store->scan(ContactStore::FIELD_NAME_KEY, [&](ContactStore::Handle handle, string_view key) {
+        if (key.find(foldedName) != string_view::npos) {
+            results.insert(store->owner(handle));
+        }
+    });
+    
+    return results;
+}
+
+template<typename Policy>
+set<Contact*> BasicContactManager<Policy>::searchByPhone(const string& phone) {
+    ReadGuard guard(indexLock);
+    set<Contact*> results;
+    
+    // First try exact match (fastest)
+    Contact** contactPtr = phoneLookup.find(phone);
+    if (contactPtr != nullptr) {
+        Contact* contact = *contactPtr;
+        results.insert(contact);
+        return results;
+    }
+    
+    // If exact match not found, try partial search
+    // Clean the input phone number (remove spaces, dashes, etc.)
+    string cleanPhone = normalizePhone(phone);
+    
+    // If input is empty after cleaning, return empty results
+    if (cleanPhone.empty()) {
+        return results;
+    }
+    
+    // Trigram candidates, verified against the real phone number
+    // (indexed numbers are validated digits only: the number is its own search key)
+    vector<int> ids;
+    if (phoneGrams.candidates(cleanPhone, ids)) {
+        for (int id : ids) {
+            Contact* contact = findContactLocked(id);
+            if (contact && contact->getPhoneNumber().find(cleanPhone) != string_view::npos) {
+                results.insert(contact);
+            }
+        }
+        return results;
+    }
+    
+    // Shorter than a trigram: one pass over the packed keys, no string is read
+    contactsByPhoneDigits.forEachContaining(cleanPhone, [&](Contact* contact) { results.insert(contact); });
+    
+    return results;
+}
+
+template<typename Policy>
+set<Contact*> BasicContactManager<Policy>::searchByEmail(const string& email) {
+    ReadGuard guard(indexLock);
+    set<Contact*> results;
+    
+    // Fold the query like the stored keys
+    string foldedEmail = normalizeEmail(email);
+    
+    // Trigram candidates, verified against the precomputed email key
+    vector<int> ids;
+    if (emailGrams.candidates(foldedEmail, ids)) {
+        for (int id : ids) {
+            Contact* contact = findContactLocked(id);
+            if (contact && contact->getEmailKey().find(foldedEmail) != string_view::npos) {
+                results.insert(contact);
+            }
+        }
+        return results;
+    }
+    
+    // Query shorter than a trigram: scan the email key column, no per-entry folding
+    store->scan(ContactStore::FIELD_EMAIL_KEY, [&](ContactStore::Handle handle, string_view key) {
+        if (key.find(foldedEmail) != string_view::npos) {
+            results.insert(store->owner(handle));
+        }
+    });
+    
+    return results;
+}
+
+template<typename Policy>
+vector<Contact*> BasicContactManager<Policy>::searchByNamePrefix(const string& prefix, bool ignoreCase, size_t limit) const {
+    ReadGuard guard(indexLock);
+    vector<Contact*> results;
+    if (prefix.empty()) {
+        return results;
+    }
+    
+    if (ignoreCase) {
+        manager_detail::collectPrefix(contactsByNameKey, normalizeName(prefix), limit, results);
+    } else {
+        manager_detail::collectPrefix(contactsByName, prefix, limit, results);
+    }
+    return results;
+}
+
+template<typename Policy>
+vector<Contact*> BasicContactManager<Policy>::searchByPhonePrefix(const string& prefix, size_t limit) const {
+    ReadGuard guard(indexLock);
+    vector<Contact*> results;
+    string digits = normalizePhone(prefix);
+    if (digits.empty()) {
+        return results;
+    }
+    
+    manager_detail::collectPrefix(contactsByPhoneDigits, digits, limit, results);
+    return results;
+}
+
+template<typename Policy>
+string BasicContactManager<Policy>::normalizeName(string_view name) {
+    return TextSearch::foldKey(name);  // Cùng quy tắc với Contact::getNameKey
+}
+
+template<typename Policy>
+string BasicContactManager<Policy>::normalizeEmail(string_view email) {
+    return TextSearch::foldKey(email);  // Cùng quy tắc với Contact::getEmailKey
+}
+
+template<typename Policy>
+string BasicContactManager<Policy>::normalizePhone(string_view phone) {
+    string result;
+    result.reserve(phone.size());
+    manager_detail::appendDigits(result, phone);
+    return result;
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::displayAllContacts() const {
+    ReadGuard guard(indexLock);
+    if (contactsByName.empty()) {
+        cout << " Không có liên hệ nào trong danh bạ!" << endl;
+        return;
+    }
+    
+    cout << "\n=== TẤT CẢ LIÊN HỆ (" << contactsByName.size() << ") ===" << endl;
+    for (const auto& entry : contactsByName) {
+        entry.second->display();
+    }
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::displayContact(int id) const {
+    ReadGuard guard(indexLock);
+    try {
+        Contact* const* contactPtr = contactsById.find(id);
+        if (contactPtr == nullptr) {
+            throw ContactNotFound("ID " + to_string(id));
+        }
+        Contact* contact = *contactPtr;
+        contact->display();
+    } catch (const ContactException& e) {
+        reportError(e);
+    }
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::displayContact(const string& name) const {
+    ReadGuard guard(indexLock);
+    try {
+        Contact* const* contactPtr = contactsByName.find(name);
+        if (contactPtr == nullptr) {
+            throw ContactNotFound(name);
+        }
+        Contact* contact = *contactPtr;
+        contact->display();
+    } catch (const ContactException& e) {
+        reportError(e);
+    }
+}
+
+template<typename Policy>
+int BasicContactManager<Policy>::getTotalContacts() const {
+    ReadGuard guard(indexLock);
+    return contactsByName.size();
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::isEmpty() const {
+    ReadGuard guard(indexLock);
+    return contactsByName.empty();
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::removeFromIndexes(Contact* contact) {
+    contactsByName.remove(contact->getName());
+    contactsByNameKey.remove(manager_detail::nameKey(contact));
+    nameGrams.remove(contact->getId(), contact->getNameKey());
+    contactsById.remove(contact->getId());
+    
+    // Remove from phone and email indexes
+    unindexPhone(contact, contact->getPhoneNumber());
+    unindexEmail(contact, contact->getEmail());
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::addToIndexes(Contact* contact) {
+    contactsByName.insert(string(contact->getName()), contact);
+    contactsByNameKey.insert(manager_detail::nameKey(contact), contact);
+    nameGrams.add(contact->getId(), contact->getNameKey());
+    contactsById.insert(contact->getId(), contact);
+    
+    // 🔑 Thêm số điện thoại và email vào index với validation
+    indexPhone(contact, contact->getPhoneNumber());
+    indexEmail(contact, contact->getEmail());
+}
+
+// 🔑 Bỏ số cũ khỏi index trước khi ghi đè, nên không cần giữ bản sao của số cũ
+template<typename Policy>
+void BasicContactManager<Policy>::updatePhoneIndex(Contact* contact, string_view newPhone) {
+    // Remove old phone from index if it exists
+    unindexPhone(contact, contact->getPhoneNumber());
+    
+    contact->setPhoneNumber(newPhone);  // 🔑 Thay thế số điện thoại cũ
+    
+    // 🔑 Add new phone to index với validation
+    indexPhone(contact, contact->getPhoneNumber());
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::updateEmailIndex(Contact* contact, string_view newEmail) {
+    // Remove old email from index if it exists
+    unindexEmail(contact, contact->getEmail());
+    
+    contact->setEmail(newEmail);  // 🔑 Thay thế email cũ
+    
+    // 🔑 Add new email to index với validation
+    indexEmail(contact, contact->getEmail());
+}
+
+// 🔑 Thêm số điện thoại vào index nếu không trùng với liên hệ khác
+template<typename Policy>
+void BasicContactManager<Policy>::indexPhone(Contact* contact, string_view phone) {
+    if (phone.empty()) {
+        return;
+    }
+    
+    if (isPhoneNumberDuplicateLocked(phone, contact)) {
+        return;  // Số trùng: không tạo khóa nào
+    }
+    
+    contactsByPhone.insert(string(phone), contact);
+    phoneLookup.insert(string(phone), contact);
+    contactsByPhoneDigits.insert(phone, contact);
+    phoneGrams.add(contact->getId(), phone);  // Số hợp lệ chỉ gồm chữ số
+}
+
+// 🔑 Chỉ xóa khỏi index nếu khóa đang thuộc về chính liên hệ này
+template<typename Policy>
+void BasicContactManager<Policy>::unindexPhone(Contact* contact, string_view phone) {
+    if (phone.empty()) {
+        return;
+    }
+    
+    Contact** owner = phoneLookup.find(phone);
+    if (owner != nullptr && *owner == contact) {
+        phoneLookup.remove(phone);
+        contactsByPhone.remove(phone);
+        contactsByPhoneDigits.remove(phone);
+        phoneGrams.remove(contact->getId(), phone);
+    }
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::indexEmail(Contact* contact, string_view email) {
+    if (email.empty()) {
+        return;
+    }
+    
+    if (isEmailDuplicateLocked(email, contact)) {
+        return;
+    }
+    
+    contactsByEmail.insert(string(email), contact);
+    emailLookup.insert(string(email), contact);
+    emailGrams.add(contact->getId(), contact->getEmailKey());  // email là email hiện tại của contact
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::unindexEmail(Contact* contact, string_view email) {
+    if (email.empty()) {
+        return;
+    }
+    
+    Contact** owner = emailLookup.find(email);
+    if (owner != nullptr && *owner == contact) {
+        emailLookup.remove(email);
+        contactsByEmail.remove(email);
+        emailGrams.remove(contact->getId(), contact->getEmailKey());
+    }
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::isValidPhone(string_view phone) const {
+    // 🔑 Sử dụng validation mới (tối đa 11 số)
+    return isPhoneNumberValid(phone);
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::isValidEmail(string_view email) const {
+    // Cùng ngôn ngữ với regex [a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}, quét một lượt
+    return FieldValidator::isValidEmail(email);
+}
+
+// 🔑 Kiểm tra số điện thoại có bị trùng lặp với liên hệ khác không
+template<typename Policy>
+bool BasicContactManager<Policy>::isPhoneNumberDuplicate(string_view phone, Contact* excludeContact) const {
+    ReadGuard guard(indexLock);
+    return isPhoneNumberDuplicateLocked(phone, excludeContact);
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::isPhoneNumberDuplicateLocked(string_view phone, Contact* excludeContact) const {
+    Contact* const* existingContactPtr = phoneLookup.find(phone);
+    if (existingContactPtr == nullptr) {
+        return false;  // Không tìm thấy -> không trùng lặp
+    }
+    
+    Contact* existingContact = *existingContactPtr;
+    // Nếu tìm thấy, kiểm tra có phải liên hệ khác không
+    if (excludeContact && existingContact == excludeContact) {
+        return false;  // Cùng một liên hệ -> không trùng lặp
+    }
+    
+    return true;  // Trùng lặp với liên hệ khác
+}
+
+// 🔑 Kiểm tra email có bị trùng lặp với liên hệ khác không
+template<typename Policy>
+bool BasicContactManager<Policy>::isEmailDuplicate(string_view email, Contact* excludeContact) const {
+    ReadGuard guard(indexLock);
+    return isEmailDuplicateLocked(email, excludeContact);
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::isEmailDuplicateLocked(string_view email, Contact* excludeContact) const {
+    Contact* const* existingContactPtr = emailLookup.find(email);
+    if (existingContactPtr == nullptr) {
+        return false;  // Không tìm thấy -> không trùng lặp
+    }
+    
+    Contact* existingContact = *existingContactPtr;
+    // Nếu tìm thấy, kiểm tra có phải liên hệ khác không
+    if (excludeContact && existingContact == excludeContact) {
+        return false;  // Cùng một liên hệ -> không trùng lặp
+    }
+    
+    return true;  // Trùng lặp với liên hệ khác
+}
+
+// 🔑 Public method để kiểm tra có thể thêm số điện thoại không
+template<typename Policy>
+bool BasicContactManager<Policy>::canAddPhoneNumber(const string& phone, Contact* excludeContact) const {
+    // Kiểm tra format và độ dài
+    if (!isPhoneNumberValid(phone)) {
+        return false;
+    }
+    
+    // Kiểm tra trùng lặp
+    ReadGuard guard(indexLock);
+    if (isPhoneNumberDuplicateLocked(phone, excludeContact)) {
+        return false;
+    }
+    
+    return true;
+}
+
+// 🔑 Public method để kiểm tra có thể thêm email không
+template<typename Policy>
+bool BasicContactManager<Policy>::canAddEmail(const string& email, Contact* excludeContact) const {
+    // Kiểm tra format email
+    if (!isValidEmail(email)) {
+        return false;
+    }
+    
+    // Kiểm tra trùng lặp
+    ReadGuard guard(indexLock);
+    if (isEmailDuplicateLocked(email, excludeContact)) {
+        return false;
+    }
+    
+    return true;
+}
+
+// 🔑 Kiểm tra format và độ dài số điện thoại (tối đa 11 số)
+template<typename Policy>
+bool BasicContactManager<Policy>::isPhoneNumberValid(string_view phone) const {
+    // Không rỗng, chỉ gồm chữ số, tối đa FieldValidator::MAX_PHONE_DIGITS (11) số
+    return FieldValidator::isValidPhone(phone);
+}
+
+template<typename Policy>
+BasicContactManager<Policy>::~BasicContactManager() {
+    delete wal;  // Flushes the pending batch
+    clearAllLocked();
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::clearAll() {
+    WriteGuard guard(indexLock);
+    clearAllLocked();
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::clearAllLocked() {
+    for (const auto& entry : contactsById) {
+        Contact::destroy(entry.second);
+    }
+    contactsByName.clear();
+    contactsByNameKey.clear();
+    contactsByPhone.clear();
+    contactsByPhoneDigits.clear();
+    contactsByEmail.clear();
+    phoneLookup.clear();
+    emailLookup.clear();
+    contactsById.clear();
+    nameGrams.clear();
+    phoneGrams.clear();
+    emailGrams.clear();
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::saveSnapshot(const string& path) const {
+    ReadGuard guard(indexLock);
+    return saveSnapshotLocked(path);
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::saveSnapshotLocked(const string& path) const {
+    try {
+        // Records in ascending ID order; runs refer to them by position
+        vector<Contact*> contacts;
+        contacts.reserve(contactsById.size());
+        IdSlotTable<uint32_t> positions;
+        for (const auto& entry : contactsById) {
+            positions.insert(entry.first, static_cast<uint32_t>(contacts.size()));
+            contacts.push_back(entry.second);
+        }
+        
+        vector<uint32_t> runs[ContactSnapshot::RUN_COUNT];
+        auto appendRun = [&](vector<uint32_t>& run, Contact* contact) {
+            run.push_back(*positions.find(contact->getId()));
+        };
+        for (const auto& entry : contactsByName) {
+            appendRun(runs[ContactSnapshot::RUN_NAME], entry.second);
+        }
+        for (const auto& entry : contactsByNameKey) {
+            appendRun(runs[ContactSnapshot::RUN_NAME_KEY], entry.second);
+        }
+        for (const auto& entry : contactsByPhone) {
+            appendRun(runs[ContactSnapshot::RUN_PHONE], entry.second);
+        }
+        for (const auto& entry : contactsByPhoneDigits) {
+            appendRun(runs[ContactSnapshot::RUN_PHONE_DIGITS], entry.second);
+        }
+        for (const auto& entry : contactsByEmail) {
+            appendRun(runs[ContactSnapshot::RUN_EMAIL], entry.second);
+        }
+        
+        ContactSnapshot::write(path, contacts, runs, Contact::getNextId(), wal ? wal->lastSequence() : 0);
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+// Throws on failure and leaves the manager empty; returns the WAL sequence the snapshot covers
+template<typename Policy>
+uint64_t BasicContactManager<Policy>::restoreSnapshot(const string& path) {
+    ContactSnapshot snapshot(path);  // mmap + kiểm tra toàn bộ offset
+    clearAllLocked();
+    
+    try {
+        // Contacts arrive in ascending ID order: the ID table and the
+        // trigram posting lists only ever append
+        size_t count = snapshot.recordCount();
+        vector<Contact*> contacts;
+        contacts.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            int id = snapshot.recordId(i);
+            if (i > 0 && id <= contacts.back()->getId()) {
+                throw StorageError("ID trong snapshot không tăng dần");
+            }
+            
+            Contact* contact = Contact::create(id, snapshot.field(i, ContactSnapshot::FIELD_NAME), store);
+            contactsById.insert(id, contact);
+            contacts.push_back(contact);
+            contact->setPhoneNumber(snapshot.field(i, ContactSnapshot::FIELD_PHONE));
+            contact->setEmail(snapshot.field(i, ContactSnapshot::FIELD_EMAIL));
+            contact->setAddress(snapshot.field(i, ContactSnapshot::FIELD_ADDRESS));
+            contact->setNotes(snapshot.field(i, ContactSnapshot::FIELD_NOTES));
+            nameGrams.add(id, contact->getNameKey());
+        }
+        
+        // Tree indexes are bulk-built from the pre-sorted runs
+        manager_detail::buildFromRun(contactsByName, snapshot, ContactSnapshot::RUN_NAME, contacts,
+                                     [](Contact* c) { return string(c->getName()); });
+        if (snapshot.version() >= 3) {
+            manager_detail::buildFromRun(contactsByNameKey, snapshot, ContactSnapshot::RUN_NAME_KEY, contacts,
+                                         [](Contact* c) { return manager_detail::nameKey(c); });
+        } else {
+            // Snapshot phiên bản 2 sắp khóa tên chưa bỏ dấu: sắp xếp lại
+            vector<pair<string, Contact*>> keys;
+            keys.reserve(count);
+            for (Contact* contact : contacts) {
+                keys.emplace_back(manager_detail::nameKey(contact), contact);
+            }
+            manager_detail::rebuildWith(contactsByNameKey, keys);
+        }
+        manager_detail::buildFromRun(contactsByPhone, snapshot, ContactSnapshot::RUN_PHONE, contacts,
+                                     [](Contact* c) { return string(c->getPhoneNumber()); });
+        manager_detail::buildFromRun(contactsByPhoneDigits, snapshot, ContactSnapshot::RUN_PHONE_DIGITS, contacts,
+                                     [](Contact* c) { return manager_detail::packedPhone(c->getPhoneNumber()); });
+        manager_detail::buildFromRun(contactsByEmail, snapshot, ContactSnapshot::RUN_EMAIL, contacts,
+                                     [](Contact* c) { return string(c->getEmail()); });
+        
+        if (contactsByName.size() != count) {
+            throw StorageError("index tên trong snapshot không đầy đủ");
+        }
+        
+        // Only the phone/email owners are in the trigram and hash indexes, again in ID order
+        vector<bool> ownsPhone(count, false);
+        vector<bool> ownsEmail(count, false);
+        for (size_t i = 0; i < snapshot.runLength(ContactSnapshot::RUN_PHONE); i++) {
+            ownsPhone[snapshot.run(ContactSnapshot::RUN_PHONE)[i]] = true;
+        }
+        for (size_t i = 0; i < snapshot.runLength(ContactSnapshot::RUN_EMAIL); i++) {
+            ownsEmail[snapshot.run(ContactSnapshot::RUN_EMAIL)[i]] = true;
+        }
+        phoneLookup.reserve(contactsByPhone.size());
+        emailLookup.reserve(contactsByEmail.size());
+        for (size_t i = 0; i < count; i++) {
+            if (ownsPhone[i]) {
+                phoneGrams.add(contacts[i]->getId(), contacts[i]->getPhoneNumber());
+                phoneLookup.insert(string(contacts[i]->getPhoneNumber()), contacts[i]);
+            }
+            if (ownsEmail[i]) {
+                emailGrams.add(contacts[i]->getId(), contacts[i]->getEmailKey());
+                emailLookup.insert(string(contacts[i]->getEmail()), contacts[i]);
+            }
+        }
+        
+        Contact::reserveIdsUpTo(snapshot.nextId() - 1);
+    } catch (...) {
+        clearAllLocked();  // Không để lại danh bạ nạp dở
+        throw;
+    }
+    return snapshot.walSequence();
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::loadSnapshot(const string& path) {
+    WriteGuard guard(indexLock);
+    try {
+        if (wal != nullptr) {
+            throw StorageError("không thể nạp snapshot khi WAL đang mở");
+        }
+        restoreSnapshot(path);
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::openStorage(const string& snapshotPath, const string& walPath, const WalOptions& options) {
+    WriteGuard guard(indexLock);
+    try {
+        if (wal != nullptr) {
+            throw StorageError("WAL đã được mở");
+        }
+        
+        // Snapshot first, then every logged mutation it does not include yet
+        uint64_t sequence = 0;
+        if (ifstream(snapshotPath).good()) {
+            sequence = restoreSnapshot(snapshotPath);
+        } else {
+            clearAllLocked();
+        }
+        
+        vector<WriteAheadLog::Record> records;
+        uint64_t validBytes = WriteAheadLog::read(walPath, records);
+        try {
+            for (const WriteAheadLog::Record& record : records) {
+                if (record.sequence > sequence) {
+                    applyLogRecord(record);
+                    sequence = record.sequence;
+                }
+            }
+            
+            wal = new WriteAheadLog(walPath, validBytes, sequence + 1, options);
+        } catch (...) {
+            clearAllLocked();
+            throw;
+        }
+        
+        walOptions = options;
+        this->snapshotPath = snapshotPath;
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::checkpoint() {
+    WriteGuard guard(indexLock);
+    return checkpointLocked();
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::checkpointLocked() {
+    try {
+        if (wal == nullptr) {
+            throw StorageError("WAL chưa được mở");
+        }
+        
+        // The snapshot records lastSequence(), so if we crash before the reset
+        // the next open simply skips the records it already covers
+        wal->sync();
+        if (!saveSnapshotLocked(snapshotPath)) {
+            return false;
+        }
+        wal->reset();
+        return true;
+    } catch (const ContactException& e) {
+        reportError(e);
+        return false;
+    }
+}
+
+template<typename Policy>
+bool BasicContactManager<Policy>::closeStorage() {
+    WriteGuard guard(indexLock);
+    if (wal == nullptr) {
+        return false;  // Không có gì để lưu: openStorage chưa chạy hoặc đã lỗi
+    }
+    
+    bool saved = checkpointLocked();
+    delete wal;  // Nếu checkpoint lỗi, WAL vẫn còn nguyên để lần sau phát lại
+    wal = nullptr;
+    return saved;
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::logMutation(WriteAheadLog::Op op, int id, const string& value) {
+    if (wal == nullptr) {
+        return;
+    }
+    
+    // Compact before appending: at this point every logged record has been
+    // applied, so the new snapshot covers the whole log
+    if (walOptions.checkpointBytes != 0 && wal->stats().bytes >= walOptions.checkpointBytes) {
+        checkpointLocked();
+    }
+    wal->append(op, id, value);  // Ném StorageError: thao tác bị hủy, dữ liệu không đổi
+}
+
+// Replay goes through the same index maintenance as the live mutators;
+// a record that no longer applies means the log and snapshot disagree
+template<typename Policy>
+void BasicContactManager<Policy>::applyLogRecord(const WriteAheadLog::Record& record) {
+    string where = "bản ghi WAL #" + to_string(record.sequence);
+    
+    if (record.op == WriteAheadLog::OP_ADD) {
+        if (record.value.empty() || contactsById.contains(record.id) || contactsByName.contains(record.value)) {
+            throw StorageError(where + " thêm liên hệ trùng");
+        }
+        addToIndexes(Contact::create(record.id, record.value, store));
+        return;
+    }
+    
+    Contact* contact = findContactLocked(record.id);
+    if (contact == nullptr) {
+        throw StorageError(where + " tham chiếu ID " + to_string(record.id) + " không tồn tại");
+    }
+    
+    bool applied = true;
+    switch (record.op) {
+        case WriteAheadLog::OP_REMOVE:
+            removeFromIndexes(contact);
+            Contact::destroy(contact);
+            break;
+        case WriteAheadLog::OP_RENAME:
+            applied = renameContactLocked(contact, record.value);
+            break;
+        case WriteAheadLog::OP_SET_PHONE:
+            applied = setContactPhoneLocked(contact, record.value);
+            break;
+        case WriteAheadLog::OP_SET_EMAIL:
+            applied = setContactEmailLocked(contact, record.value);
+            break;
+        case WriteAheadLog::OP_SET_ADDRESS:
+            contact->setAddress(record.value);
+            break;
+        case WriteAheadLog::OP_SET_NOTES:
+            contact->setNotes(record.value);
+            break;
+        default:
+            applied = false;
+            break;
+    }
+    
+    if (!applied) {
+        throw StorageError(where + " không áp dụng được");
+    }
+}
+
+template<typename Policy>
+void BasicContactManager<Policy>::printTreeStructures() const {
+    ReadGuard guard(indexLock);
+    cout << "\n=== CẤU TRÚC CÂY DỮ LIỆU ===" << endl;
+    
+    cout << "\n🌳 Index - Contacts by Name:" << endl;
+    contactsByName.print();
+    
+    cout << "\n📞 Index - Contacts by Phone:" << endl;
+    contactsByPhone.print();
+    
+    cout << "\n📧 Index - Contacts by Email:" << endl;
+    contactsByEmail.print();
+    
+    cout << "\n📇 Index - Contacts by ID:" << endl;
+    contactsById.print();
+    
+    cout << "=================================" << endl;
+}
+
+#endif // CONTACT_MANAGER_IMPL_H
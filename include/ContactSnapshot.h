@@ -0,0 +1,89 @@
+#ifndef CONTACT_SNAPSHOT_H
+#define CONTACT_SNAPSHOT_H
+
+#include "Contact.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// 💾 Binary snapshot of the address book.
+//
+// Layout (little-endian, every section 8-byte aligned):
+//   Header         magic "SCSNAP01", version, last WAL sequence, offsets
+//   Records        one fixed-size record per contact, ascending ID
+//   Runs           RUN_COUNT arrays of record positions, each already in
+//                  the key order of one index, so loading can bulk-build
+//                  the trees without sorting or comparing keys
+//   Strings        all field bytes, referenced by (offset, length)
+//
+// Reading maps the file read-only (mmap) and hands out pointers into the
+// mapping; nothing is copied until the caller builds Contact objects.
+class ContactSnapshot {
+public:
+    enum Field { FIELD_NAME, FIELD_PHONE, FIELD_EMAIL, FIELD_ADDRESS, FIELD_NOTES, FIELD_COUNT };
+    enum Run { RUN_NAME, RUN_NAME_KEY, RUN_PHONE, RUN_PHONE_DIGITS, RUN_EMAIL, RUN_COUNT };
+    
+    // Version 3 orders RUN_NAME_KEY by the diacritic-folded name key;
+    // version 2 files (lowercase-only order) are still read
+    static const uint32_t VERSION = 3;
+    static const uint32_t MIN_VERSION = 2;
+    
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        int32_t nextId;
+        uint64_t walSequence;  // last write-ahead log record already included
+        uint64_t recordCount;
+        uint64_t recordsOffset;
+        uint64_t runsOffset;
+        uint64_t runLengths[RUN_COUNT];
+        uint64_t stringsOffset;
+        uint64_t stringsSize;
+    };
+    
+    struct Record {
+        int32_t id;
+        uint32_t length[FIELD_COUNT];
+        uint64_t offset[FIELD_COUNT];
+    };
+    
+    // Writes contacts (ascending ID) and the per-index runs (positions into
+    // contacts) to path atomically: a temporary file is renamed over path.
+    // Returns only once both the file and the rename are on disk (fsync of
+    // the file and its directory); throws StorageError otherwise.
+    static void write(const string& path, const vector<Contact*>& contacts,
+                      const vector<uint32_t> runs[RUN_COUNT], int nextId, uint64_t walSequence = 0);
+    
+    // Maps and validates path; throws StorageError on any inconsistency
+    explicit ContactSnapshot(const string& path);
+    ~ContactSnapshot();
+    
+    ContactSnapshot(const ContactSnapshot&) = delete;
+    ContactSnapshot& operator=(const ContactSnapshot&) = delete;
+    
+    size_t recordCount() const { return header->recordCount; }
+    int nextId() const { return header->nextId; }
+    uint64_t walSequence() const { return header->walSequence; }
+    uint32_t version() const { return header->version; }
+    int recordId(size_t index) const { return records[index].id; }
+    string_view field(size_t index, Field field) const;  // Points into the mapping
+    const uint32_t* run(Run run) const { return runs[run]; }
+    size_t runLength(Run run) const { return header->runLengths[run]; }
+    
+private:
+    const char* data;
+    size_t size;
+    bool mapped;  // false when the platform fallback read the file into memory
+    const Header* header;
+    const Record* records;
+    const uint32_t* runs[RUN_COUNT];
+    const char* strings;
+    
+    void validate(const string& path);
+    void release();
+};
+
+#endif
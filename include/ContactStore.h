@@ -0,0 +1,138 @@
+#ifndef CONTACT_STORE_H
+#define CONTACT_STORE_H
+
+#include "NodePool.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class Contact;
+
+// 🗄️ Column-wise storage for contact fields.
+//
+// Each field (name, phone, email, address, notes) has its own column: one
+// byte arena holding the values back to back, plus one {offset, length}
+// entry per handle. The name and e-mail also have a search key column
+// (TextSearch::foldKey of the value), written by the Contact setters
+// together with the value, so searches never normalize a stored value. A Contact only keeps its handle, so a scan over one
+// field (e.g. every email) reads that column's entries and arena and
+// nothing else.
+//
+// Handles are small integers, stable for the contact's lifetime and reused
+// after release(). Overwritten values leave garbage in the arena; a column
+// is compacted (rewritten in handle order) once garbage outweighs live
+// bytes.
+//
+// string_views returned by get()/scan() point into an arena and are only
+// valid until the next set() or release(). The store itself is not
+// synchronized: ConcurrentContactManager reads it under its read lock and
+// writes it under its write lock.
+//
+// getInstance() holds contacts built without a store; every manager
+// instance, and every shard of ShardedContactManager, gets its own from
+// create(), so a column scan only sees that manager's contacts and each
+// store is guarded by its owner's lock. The Contact records themselves come
+// from the same store's slab (allocateRecord, used by Contact::create), so
+// shards never share an allocator either. The top STORE_BITS of a handle name its store, so of(handle)
+// finds a contact's fields without a per-contact store pointer.
+class ContactStore {
+public:
+    enum Field {
+        FIELD_NAME,
+        FIELD_PHONE,
+        FIELD_EMAIL,
+        FIELD_ADDRESS,
+        FIELD_NOTES,
+        FIELD_NAME_KEY,   // derived from FIELD_NAME
+        FIELD_EMAIL_KEY,  // derived from FIELD_EMAIL
+        FIELD_COUNT
+    };
+    
+    typedef uint32_t Handle;
+    
+    static const unsigned STORE_BITS = 7;
+    static const unsigned SLOT_BITS = 32 - STORE_BITS;  // 32M handles per store
+    static const size_t MAX_STORES = size_t(1) << STORE_BITS;
+    
+    struct Stats {
+        size_t records;      // live handles
+        size_t handles;      // live + free handles
+        size_t entryBytes;   // {offset, length} entries, all columns
+        size_t liveBytes;    // value bytes still referenced
+        size_t arenaBytes;   // value bytes allocated (live + garbage + spare capacity)
+    };
+    
+    static ContactStore* getInstance();
+    static ContactStore* create();
+    static void destroy(ContactStore* store);  // Every handle must have been released
+    static ContactStore* of(Handle handle) { return stores[handle >> SLOT_BITS]; }
+    
+    Handle allocate(Contact* owner);  // All fields start empty
+    void release(Handle handle);
+    
+    Contact* owner(Handle handle) const { return owners[slotOf(handle)]; }
+    
+    // Uninitialized storage for one Contact, from this store's slab
+    void* allocateRecord();
+    void releaseRecord(void* record);
+    
+    string_view get(Handle handle, Field field) const {
+        const Column& column = columns[field];
+        const Entry& entry = column.entries[slotOf(handle)];
+        return string_view(column.bytes.data() + entry.offset, entry.length);
+    }
+    
+    void set(Handle handle, Field field, string_view value);
+    
+    // Calls fn(handle, value) for every non-empty value of field, in handle
+    // order. Only that column's entries and arena are read.
+    template<typename Fn>
+    void scan(Field field, Fn fn) const {
+        const Column& column = columns[field];
+        const char* bytes = column.bytes.data();
+        size_t count = column.entries.size();
+        for (size_t slot = 0; slot < count; slot++) {
+            const Entry& entry = column.entries[slot];
+            if (entry.length != 0) {
+                fn(firstHandle | static_cast<Handle>(slot), string_view(bytes + entry.offset, entry.length));
+            }
+        }
+    }
+    
+    Stats stats() const;
+    void shrinkToFit();  // Compacts every column and drops spare capacity
+
+private:
+    struct Entry {
+        uint32_t offset;
+        uint32_t length;
+    };
+    
+    struct Column {
+        vector<char> bytes;
+        vector<Entry> entries;  // indexed by handle
+        size_t garbage = 0;     // bytes no entry refers to any more
+    };
+    
+    static const Handle SLOT_MASK = (Handle(1) << SLOT_BITS) - 1;
+    
+    static ContactStore* stores[MAX_STORES];  // index -> store, nullptr when free
+    
+    explicit ContactStore(size_t index);
+    ~ContactStore();  // Only through destroy()
+    
+    static size_t slotOf(Handle handle) { return handle & SLOT_MASK; }
+    
+    Handle firstHandle;          // index << SLOT_BITS
+    Column columns[FIELD_COUNT];
+    vector<Contact*> owners;     // slot -> Contact, nullptr when free
+    vector<Handle> freeHandles;
+    NodePool<Contact>* records;  // Contact is incomplete here
+    
+    void compact(Column& column);
+};
+
+#endif
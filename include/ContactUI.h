@@ -2,6 +2,7 @@
 #define CONTACT_UI_H
 
 #include "ContactManager.h"
+#include <istream>
 #include <string>
 
 using namespace std;
@@ -9,6 +10,7 @@ using namespace std;
 class ContactUI {
 private:
     ContactManager* manager;
+    string dataFile;  // Snapshot file ("" = chỉ trong bộ nhớ, không lưu)
     
     // Menu methods
     void showMainMenu() const;
@@ -49,16 +51,27 @@ private:
     void searchByName() const;
     void searchByPhone() const;
     void searchByEmail() const;
+    void searchByNamePrefix() const;
+    void searchByPhonePrefix() const;
     
     // Display operations
     void displayAllContacts() const;
     void displaySearchResults(const set<Contact*>& results) const;
+    void displaySearchResults(const vector<Contact*>& results) const;
+    
+    // Persistence
+    bool loadData() const;  // false nếu không mở được snapshot/WAL
+    bool saveData() const;  // false nếu không có gì được lưu
+    bool confirmInMemoryMode();  // Hỏi người dùng khi loadData lỗi
 
 public:
-    ContactUI();
+    explicit ContactUI(const string& dataFile = "contacts.snapshot");
     ~ContactUI();
     
     void run();
+    // 📜 Chạy lệnh từ stream (xem BatchCommandRunner.h); false nếu không mở/lưu được dữ liệu
+    // hoặc có lệnh lỗi
+    bool runBatch(istream& in);
     void showWelcome() const;
     void showGoodbye() const;
 };
@@ -0,0 +1,191 @@
+#ifndef EPOCH_RECLAIMER_H
+#define EPOCH_RECLAIMER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Epoch-based reclamation for structures whose readers take no lock
+// (PersistentTree): a writer unlinks nodes, then retires them, and a
+// retired node is freed only once no reader can still be looking at it.
+//
+// There is one global epoch. A reader pins the current epoch for the
+// duration of a Guard; the epoch advances only when every pinned thread
+// has seen the current value. A node retired at epoch e is freed once the
+// epoch reaches e + 2: by then every reader that could have reached it has
+// unpinned. Readers never wait: pinning is one load and one store to the
+// thread's own slot. Writers never wait for readers either; a reader that
+// stays pinned only delays the freeing of garbage.
+//
+// Retire only after the unlinking store has been published (the epoch is
+// read at retire time). Guards nest; the outermost one pins.
+class EpochReclaimer {
+private:
+    struct Slot;
+
+public:
+    typedef void (*Destroy)(void*);
+    
+    // Pins the calling thread's epoch for the guard's lifetime
+    class Guard {
+    public:
+        Guard() : slot(EpochReclaimer::getInstance().pin()) {}
+        ~Guard() { EpochReclaimer::getInstance().unpin(slot); }
+    
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    
+    private:
+        Slot* slot;
+    };
+    
+    static EpochReclaimer& getInstance() {
+        static EpochReclaimer* instance = new EpochReclaimer();  // Never destroyed: threads may exit after main
+        return *instance;
+    }
+    
+    // Queues objects for destroy(object) once no pinned reader can reach them
+    void retire(void* object, Destroy destroy) {
+        std::lock_guard<std::mutex> guard(retiredLock);
+        retired.push_back(Retired{object, destroy, epoch.load()});
+    }
+    
+    template<typename T>
+    void retire(T* object) {
+        retire(object, &destroyObject<T>);
+    }
+    
+    // One lock and one epoch read for a whole write's worth of objects
+    template<typename T>
+    void retireAll(const std::vector<T*>& objects) {
+        if (objects.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(retiredLock);
+        uint64_t now = epoch.load();
+        for (T* object : objects) {
+            retired.push_back(Retired{object, &destroyObject<T>, now});
+        }
+    }
+    
+    // Tries to advance the epoch and frees what is old enough. Cheap when
+    // nothing is pending; writers call it after publishing.
+    void collect() {
+        std::vector<Retired> ready;
+        {
+            std::lock_guard<std::mutex> guard(retiredLock);
+            if (retired.empty()) {
+                return;
+            }
+            tryAdvance();
+            uint64_t current = epoch.load();
+            size_t count = 0;
+            while (count < retired.size() && retired[count].epoch + 2 <= current) {
+                count++;
+            }
+            ready.assign(retired.begin(), retired.begin() + count);
+            retired.erase(retired.begin(), retired.begin() + count);
+        }
+        for (const Retired& item : ready) {
+            item.destroy(item.object);
+        }
+    }
+    
+    size_t pending() const {
+        std::lock_guard<std::mutex> guard(retiredLock);
+        return retired.size();
+    }
+
+private:
+    static const uint64_t IDLE = UINT64_MAX;
+    
+    // One per thread that has ever pinned, linked into a list that only
+    // grows; a slot is handed to a new thread once its owner has exited
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{IDLE};
+        std::atomic<bool> owned{true};
+        Slot* next = nullptr;
+        unsigned depth = 0;  // Guard nesting, touched by the owner only
+    };
+    
+    struct Retired {
+        void* object;
+        Destroy destroy;
+        uint64_t epoch;
+    };
+    
+    // Releases the thread's slot when the thread exits
+    struct ThreadSlot {
+        Slot* slot = nullptr;
+        ~ThreadSlot() {
+            if (slot != nullptr) {
+                slot->owned.store(false);
+            }
+        }
+    };
+    
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<Slot*> slots{nullptr};
+    mutable std::mutex retiredLock;
+    std::vector<Retired> retired;  // in retire order, so epochs never decrease
+    
+    EpochReclaimer() {}
+    
+    template<typename T>
+    static void destroyObject(void* object) {
+        delete static_cast<T*>(object);
+    }
+    
+    Slot* threadSlot() {
+        static thread_local ThreadSlot mine;
+        if (mine.slot != nullptr) {
+            return mine.slot;
+        }
+        for (Slot* slot = slots.load(); slot != nullptr; slot = slot->next) {
+            bool free = false;
+            if (!slot->owned.load() && slot->owned.compare_exchange_strong(free, true)) {
+                mine.slot = slot;
+                return slot;
+            }
+        }
+        Slot* slot = new Slot();
+        slot->next = slots.load();
+        while (!slots.compare_exchange_weak(slot->next, slot)) {
+        }
+        mine.slot = slot;
+        return slot;
+    }
+    
+    // All orderings are sequentially consistent: the pin store must be
+    // ordered before the reader's root load, and the writer's epoch read
+    // in retire() after its root store.
+    Slot* pin() {
+        Slot* slot = threadSlot();
+        if (slot->depth++ == 0) {
+            slot->epoch.store(epoch.load());
+        }
+        return slot;
+    }
+    
+    void unpin(Slot* slot) {
+        if (--slot->depth == 0) {
+            slot->epoch.store(IDLE, std::memory_order_release);
+        }
+    }
+    
+    // Moves from e to e + 1 when every pinned thread has pinned e
+    void tryAdvance() {
+        uint64_t current = epoch.load();
+        for (Slot* slot = slots.load(); slot != nullptr; slot = slot->next) {
+            uint64_t pinned = slot->epoch.load();
+            if (pinned != IDLE && pinned != current) {
+                return;
+            }
+        }
+        epoch.compare_exchange_strong(current, current + 1);
+    }
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef FIELD_VALIDATOR_H
+#define FIELD_VALIDATOR_H
+
+#include <cstddef>
+#include <string_view>
+
+using namespace std;
+
+// ✅ Format checks for contact fields, one pass over the bytes.
+//
+// Each byte is classified through a 256-entry table; nothing is allocated
+// and no std::regex is involved. The accepted language is exactly that of
+// the patterns the manager used before (full match, byte-wise):
+//   phone  [0-9]{1,11}
+//   email  [a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}
+// bench_validation checks both against std::regex on every input it times.
+class FieldValidator {
+public:
+    static const size_t MAX_PHONE_DIGITS = 11;
+    
+    static bool isValidPhone(string_view phone);
+    static bool isValidEmail(string_view email);
+};
+
+#endif
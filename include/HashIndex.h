@@ -0,0 +1,276 @@
+#ifndef HASH_INDEX_H
+#define HASH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Transparent string hash: std::string, std::string_view and C strings hash
+// alike, so a HashIndex<std::string, V, StringHash, std::equal_to<>> can be
+// probed with a string_view without building a std::string.
+struct StringHash {
+    using is_transparent = void;
+    
+    std::size_t operator()(std::string_view text) const { return std::hash<std::string_view>()(text); }
+};
+
+// Unordered exact-match index with open addressing.
+// Entries live densely in insertion order (removal moves the last entry
+// into the hole), each with the full hash of its key computed once at
+// insert. Probing runs over a separate table of 8-byte slots, each holding
+// the low 32 bits of an entry's hash as a tag and the entry's position, so
+// a probe touches one small slot per step and only compares a key when the
+// tag matches. Growing rehashes from the stored hashes, never from keys.
+// Linear probing at a load factor of at most 1/2; removal shifts the
+// following slots back instead of leaving tombstones.
+//
+// Insert and remove may move entries: pointers returned by find() are
+// valid until the next insert or remove.
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class HashIndex {
+private:
+    struct Entry {
+        std::size_t hash;
+        K key;
+        V value;
+    };
+    
+    struct Slot {
+        uint32_t tag;    // 0 = empty; tags of stored hashes are never 0
+        uint32_t entry;  // Position in entries
+    };
+    
+    std::vector<Entry> entries;
+    std::vector<Slot> slots;  // Power-of-two size, or empty
+    unsigned shift_;          // 64 - log2(slots.size())
+    Hash hasher_;
+    KeyEqual equal_;
+    
+    static uint32_t tagOf(std::size_t hash) { return static_cast<uint32_t>(hash) | 1u; }
+    
+    // Fibonacci hashing: the high bits of the product pick the home slot,
+    // so weak low bits (std::hash<int> is the identity) still spread out
+    size_t homeOf(std::size_t hash) const {
+        return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+    
+    // Helper methods
+    template<typename Q>
+    size_t findSlot(const Q& key, std::size_t hash) const;  // slots.size() when absent
+    void placeSlot(uint32_t entry);
+    void eraseSlot(size_t slot);
+    void rehash(size_t slotCount);
+    void insertEntry(std::size_t hash, K&& key, const V& value);
+    void eraseEntry(size_t slot);
+
+public:
+    HashIndex() : shift_(64) {}
+    
+    // Core operations (insert replaces the value of an existing key)
+    void insert(const K& key, const V& value) { insertEntry(hasher_(key), K(key), value); }
+    void insert(K&& key, const V& value) {
+        std::size_t hash = hasher_(key);
+        insertEntry(hash, std::move(key), value);
+    }
+    V* find(const K& key) {
+        size_t slot = findSlot(key, hasher_(key));
+        return slot != slots.size() ? &entries[slots[slot].entry].value : nullptr;
+    }
+    const V* find(const K& key) const {
+        size_t slot = findSlot(key, hasher_(key));
+        return slot != slots.size() ? &entries[slots[slot].entry].value : nullptr;
+    }
+    bool remove(const K& key) {
+        size_t slot = findSlot(key, hasher_(key));
+        if (slot == slots.size()) {
+            return false;
+        }
+        eraseEntry(slot);
+        return true;
+    }
+    bool contains(const K& key) const { return findSlot(key, hasher_(key)) != slots.size(); }
+    
+    // Heterogeneous lookup, only when both Hash and KeyEqual are transparent
+    // (e.g. StringHash with std::equal_to<>): a string_view or const char*
+    // probes string keys without building a K. Hash must give equal keys
+    // of either type the same hash.
+    template<typename Q, typename H = Hash, typename = typename H::is_transparent,
+             typename E = KeyEqual, typename = typename E::is_transparent>
+    V* find(const Q& key) {
+        size_t slot = findSlot(key, hasher_(key));
+        return slot != slots.size() ? &entries[slots[slot].entry].value : nullptr;
+    }
+    template<typename Q, typename H = Hash, typename = typename H::is_transparent,
+             typename E = KeyEqual, typename = typename E::is_transparent>
+    const V* find(const Q& key) const {
+        size_t slot = findSlot(key, hasher_(key));
+        return slot != slots.size() ? &entries[slots[slot].entry].value : nullptr;
+    }
+    template<typename Q, typename H = Hash, typename = typename H::is_transparent,
+             typename E = KeyEqual, typename = typename E::is_transparent>
+    bool contains(const Q& key) const { return findSlot(key, hasher_(key)) != slots.size(); }
+    template<typename Q, typename H = Hash, typename = typename H::is_transparent,
+             typename E = KeyEqual, typename = typename E::is_transparent>
+    bool remove(const Q& key) {
+        size_t slot = findSlot(key, hasher_(key));
+        if (slot == slots.size()) {
+            return false;
+        }
+        eraseEntry(slot);
+        return true;
+    }
+    
+    // Utility methods
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    size_t capacity() const { return slots.size(); }
+    void reserve(size_t count);  // Room for count keys without rehashing
+    void clear();
+    
+    // Debug
+    void print() const;
+};
+
+// Implementation
+template<typename K, typename V, typename Hash, typename KeyEqual>
+template<typename Q>
+size_t HashIndex<K, V, Hash, KeyEqual>::findSlot(const Q& key, std::size_t hash) const {
+    if (slots.empty()) {
+        return 0;
+    }
+    
+    size_t mask = slots.size() - 1;
+    uint32_t tag = tagOf(hash);
+    for (size_t slot = homeOf(hash);; slot = (slot + 1) & mask) {
+        const Slot& probe = slots[slot];
+        if (probe.tag == 0) {
+            return slots.size();
+        }
+        if (probe.tag == tag) {
+            const Entry& entry = entries[probe.entry];
+            if (entry.hash == hash && equal_(entry.key, key)) {
+                return slot;
+            }
+        }
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashIndex<K, V, Hash, KeyEqual>::placeSlot(uint32_t entry) {
+    std::size_t hash = entries[entry].hash;
+    size_t mask = slots.size() - 1;
+    size_t slot = homeOf(hash);
+    while (slots[slot].tag != 0) {
+        slot = (slot + 1) & mask;
+    }
+    slots[slot] = Slot{tagOf(hash), entry};
+}
+
+// Backward-shift deletion: walk the cluster after the hole and move back
+// every slot whose home is not between the hole and its current position
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashIndex<K, V, Hash, KeyEqual>::eraseSlot(size_t slot) {
+    size_t mask = slots.size() - 1;
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask; slots[next].tag != 0; next = (next + 1) & mask) {
+        size_t home = homeOf(entries[slots[next].entry].hash);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole] = Slot{0, 0};
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashIndex<K, V, Hash, KeyEqual>::rehash(size_t slotCount) {
+    slots.assign(slotCount, Slot{0, 0});
+    shift_ = 64;
+    for (size_t n = slotCount; n > 1; n >>= 1) {
+        shift_--;
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+        placeSlot(static_cast<uint32_t>(i));
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashIndex<K, V, Hash, KeyEqual>::insertEntry(std::size_t hash, K&& key, const V& value) {
+    size_t slot = findSlot(key, hash);
+    if (slot != slots.size()) {
+        entries[slots[slot].entry].value = value;
+        return;
+    }
+    
+    if (2 * (entries.size() + 1) > slots.size()) {
+        rehash(slots.empty() ? 16 : 2 * slots.size());
+    }
+    entries.push_back(Entry{hash, std::move(key), value});
+    placeSlot(static_cast<uint32_t>(entries.size() - 1));
+}
+
+// Removes the entry behind slot; the last entry moves into its place and
+// its slot is repointed
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashIndex<K, V, Hash, KeyEqual>::eraseEntry(size_t slot) {
+    uint32_t removed = slots[slot].entry;
+    eraseSlot(slot);
+    
+    uint32_t last = static_cast<uint32_t>(entries.size() - 1);
+    if (removed != last) {
+        size_t mask = slots.size() - 1;
+        size_t moved = homeOf(entries[last].hash);
+        while (slots[moved].entry != last || slots[moved].tag == 0) {
+            moved = (moved + 1) & mask;
+        }
+        slots[moved].entry = removed;
+        entries[removed] = std::move(entries[last]);
+    }
+    entries.pop_back();
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashIndex<K, V, Hash, KeyEqual>::reserve(size_t count) {
+    if (count == 0) {
+        return;
+    }
+    entries.reserve(count);
+    size_t slotCount = slots.empty() ? 16 : slots.size();
+    while (2 * count > slotCount) {
+        slotCount *= 2;
+    }
+    if (slotCount != slots.size()) {
+        rehash(slotCount);
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashIndex<K, V, Hash, KeyEqual>::clear() {
+    std::vector<Entry>().swap(entries);
+    std::vector<Slot>().swap(slots);
+    shift_ = 64;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void HashIndex<K, V, Hash, KeyEqual>::print() const {
+    size_t longest = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        size_t slot = findSlot(entries[i].key, entries[i].hash);
+        size_t distance = (slot - homeOf(entries[i].hash)) & (slots.size() - 1);
+        if (distance > longest) {
+            longest = distance;
+        }
+    }
+    std::cout << "Hash Index (size: " << entries.size() << ", slots: " << slots.size()
+              << ", longest probe: " << longest << "):" << std::endl;
+    for (const Entry& entry : entries) {
+        std::cout << "  " << entry.key << " -> " << entry.value << std::endl;
+    }
+}
+
+#endif // HASH_INDEX_H
@@ -0,0 +1,286 @@
+#ifndef ID_SLOT_TABLE_H
+#define ID_SLOT_TABLE_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+// Dense table indexed directly by integer ID.
+// Contact IDs are handed out sequentially by Contact::nextId, so a plain
+// array slot per ID gives O(1) insert/find/remove with no tree descent and
+// no recursion. Slots are stored relative to base_; once the free slots
+// below the lowest live ID make up half the table, remove() drops them and
+// rebases, so a table whose low IDs were all removed does not keep them
+// allocated.
+// With a stride N (setStride), every key must leave the same remainder mod N
+// and slot i holds key base_ + i * N: a shard of ShardedContactManager holds
+// one ID in N, and its table stays N times smaller than the whole ID range.
+// insert() rejects a key with another remainder instead of flooring it onto
+// a neighbour's slot.
+template<typename V>
+class IdSlotTable {
+private:
+    std::vector<V> slots;
+    std::vector<unsigned char> used;
+    int base_;
+    int stride_;
+    size_t size_;
+    size_t head_;  // index of the lowest occupied slot (0 when empty)
+    
+    // Helper methods
+    int keyAt(size_t index) const { return base_ + static_cast<int>(index) * stride_; }
+    bool slotIndex(int key, size_t& index) const;
+    bool fitsStride(int key) const;
+    void growTo(int key);
+    void trimFront();
+    
+public:
+    // Forward iterator over occupied slots in ascending ID order
+    class const_iterator {
+    private:
+        friend class IdSlotTable;
+        
+        const IdSlotTable* table;
+        size_t index;
+        
+        const_iterator(const IdSlotTable* t, size_t i) : table(t), index(i) { skipFree(); }
+        
+        void skipFree() {
+            while (index < table->slots.size() && !table->used[index]) {
+                index++;
+            }
+        }
+        
+    public:
+        struct reference {
+            int first;
+            const V& second;
+        };
+        
+        reference operator*() const {
+            return reference{table->keyAt(index), table->slots[index]};
+        }
+        
+        const_iterator& operator++() {
+            index++;
+            skipFree();
+            return *this;
+        }
+        
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+    };
+    
+    IdSlotTable() : base_(0), stride_(1), size_(0), head_(0) {}
+    
+    // Core operations
+    bool insert(int key, const V& value);  // false if key is off the stride
+    V* find(int key);
+    const V* find(int key) const;
+    bool remove(int key);
+    bool contains(int key) const;
+    
+    // Utility methods
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return slots.size(); }
+    void setStride(int stride);  // Only while empty
+    void clear();
+    std::vector<V> getAllValues() const;
+    
+    // Debug
+    void print() const;
+    
+    // Iteration (no allocation)
+    const_iterator begin() const { return const_iterator(this, head_); }
+    const_iterator end() const { return const_iterator(this, slots.size()); }
+    
+    // Snapshot copy of all pairs (prefer iterators for scans)
+    std::vector<std::pair<int, V>> getAllPairs() const;
+};
+
+// Implementation
+template<typename V>
+bool IdSlotTable<V>::slotIndex(int key, size_t& index) const {
+    if (slots.empty() || key < base_) {
+        return false;
+    }
+    
+    index = static_cast<size_t>(key - base_);
+    if (stride_ != 1) {
+        size_t stride = static_cast<size_t>(stride_);
+        if (index % stride != 0) {
+            return false;
+        }
+        index /= stride;
+    }
+    return index < slots.size();
+}
+
+// Any key fits an empty table (it becomes base_)
+template<typename V>
+bool IdSlotTable<V>::fitsStride(int key) const {
+    if (stride_ == 1 || slots.empty()) {
+        return true;
+    }
+    long long offset = static_cast<long long>(key) - base_;
+    return offset % stride_ == 0;
+}
+
+// key must satisfy fitsStride
+template<typename V>
+void IdSlotTable<V>::growTo(int key) {
+    if (slots.empty()) {
+        base_ = key;
+    }
+    
+    if (key < base_) {
+        // Rebase: shift existing slots up so that key becomes slot 0
+        size_t shift = static_cast<size_t>(base_ - key) / static_cast<size_t>(stride_);
+        slots.insert(slots.begin(), shift, V());
+        used.insert(used.begin(), shift, 0);
+        base_ = key;
+        head_ += shift;
+        return;
+    }
+    
+    size_t index = static_cast<size_t>(key - base_) / static_cast<size_t>(stride_);
+    if (index >= slots.size()) {
+        // Geometric growth keeps sequential inserts amortized O(1)
+        size_t newSize = slots.size() * 2;
+        if (newSize <= index) {
+            newSize = index + 1;
+        }
+        slots.resize(newSize, V());
+        used.resize(newSize, 0);
+    }
+}
+
+template<typename V>
+bool IdSlotTable<V>::insert(int key, const V& value) {
+    if (!fitsStride(key)) {
+        return false;
+    }
+    growTo(key);
+    
+    size_t index = static_cast<size_t>(key - base_) / static_cast<size_t>(stride_);
+    if (!used[index]) {
+        used[index] = 1;
+        size_++;
+    }
+    slots[index] = value;
+    if (size_ == 1 || index < head_) {
+        head_ = index;
+    }
+    return true;
+}
+
+template<typename V>
+V* IdSlotTable<V>::find(int key) {
+    size_t index;
+    if (!slotIndex(key, index) || !used[index]) {
+        return nullptr;
+    }
+    return &slots[index];
+}
+
+template<typename V>
+const V* IdSlotTable<V>::find(int key) const {
+    size_t index;
+    if (!slotIndex(key, index) || !used[index]) {
+        return nullptr;
+    }
+    return &slots[index];
+}
+
+template<typename V>
+bool IdSlotTable<V>::contains(int key) const {
+    return find(key) != nullptr;
+}
+
+template<typename V>
+bool IdSlotTable<V>::remove(int key) {
+    size_t index;
+    if (!slotIndex(key, index) || !used[index]) {
+        return false;
+    }
+    
+    used[index] = 0;
+    slots[index] = V();
+    size_--;
+    
+    if (size_ == 0) {
+        clear();
+    } else if (index == head_) {
+        // head_ only moves up between inserts below it, so this scan is amortized O(1)
+        while (!used[head_]) {
+            head_++;
+        }
+        if (head_ >= slots.size() / 2) {
+            trimFront();
+        }
+    }
+    return true;
+}
+
+// Drops the free slots below head_ and rebases; copies the live half into
+// right-sized vectors so the memory is actually returned
+template<typename V>
+void IdSlotTable<V>::trimFront() {
+    std::vector<V>(slots.begin() + head_, slots.end()).swap(slots);
+    std::vector<unsigned char>(used.begin() + head_, used.end()).swap(used);
+    base_ = keyAt(head_);
+    head_ = 0;
+}
+
+template<typename V>
+void IdSlotTable<V>::setStride(int stride) {
+    if (size_ == 0 && stride > 0) {
+        stride_ = stride;
+    }
+}
+
+template<typename V>
+void IdSlotTable<V>::clear() {
+    std::vector<V>().swap(slots);
+    std::vector<unsigned char>().swap(used);
+    base_ = 0;
+    size_ = 0;
+    head_ = 0;
+}
+
+template<typename V>
+std::vector<V> IdSlotTable<V>::getAllValues() const {
+    std::vector<V> result;
+    result.reserve(size_);
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (used[i]) {
+            result.push_back(slots[i]);
+        }
+    }
+    return result;
+}
+
+template<typename V>
+std::vector<std::pair<int, V>> IdSlotTable<V>::getAllPairs() const {
+    std::vector<std::pair<int, V>> result;
+    result.reserve(size_);
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (used[i]) {
+            result.push_back(std::make_pair(keyAt(i), slots[i]));
+        }
+    }
+    return result;
+}
+
+template<typename V>
+void IdSlotTable<V>::print() const {
+    std::cout << "ID Slot Table (size: " << size_ << ", slots: " << slots.size() << "):" << std::endl;
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (used[i]) {
+            std::cout << "  [" << keyAt(i) << "] -> " << slots[i] << std::endl;
+        }
+    }
+}
+
+#endif // ID_SLOT_TABLE_H
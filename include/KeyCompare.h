@@ -0,0 +1,81 @@
+#ifndef KEY_COMPARE_H
+#define KEY_COMPARE_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus > 201703L && __has_include(<compare>)
+#include <compare>
+#endif
+
+// Three-way key comparison for the tree descents: negative, zero or positive
+// as a orders before, equal to or after b. A descent makes one such call per
+// node instead of a less-than followed by a greater-than (or equality) test,
+// which on long keys with shared prefixes ("Nguyễn Thị ...") means one pass
+// over the common bytes instead of two.
+//
+// compareKeys(comp, a, b) uses, in order of preference:
+//   1. comp.compare(a, b) when Compare has such a member returning int;
+//   2. string_view::compare when Compare is std::less (std::less<string> or
+//      the transparent std::less<>) and a string is compared against a
+//      string, string_view or C string;
+//   3. a <=> b when Compare is std::less and the keys support it (C++20);
+//   4. otherwise two calls to comp(a, b) / comp(b, a).
+// All of them must agree with comp's ordering.
+
+namespace key_compare_detail {
+
+template<typename C, typename A, typename B, typename = void>
+struct HasCompareMember : std::false_type {};
+
+template<typename C, typename A, typename B>
+struct HasCompareMember<C, A, B, std::void_t<decltype(
+    int(std::declval<const C&>().compare(std::declval<const A&>(), std::declval<const B&>())))>>
+    : std::true_type {};
+
+template<typename C>
+struct IsStdLess : std::false_type {};
+
+template<typename T>
+struct IsStdLess<std::less<T>> : std::true_type {};
+
+template<typename T>
+struct IsStringClass : std::false_type {};
+
+template<typename Ch, typename Tr, typename Al>
+struct IsStringClass<std::basic_string<Ch, Tr, Al>> : std::is_same<Ch, char> {};
+
+template<typename Ch, typename Tr>
+struct IsStringClass<std::basic_string_view<Ch, Tr>> : std::is_same<Ch, char> {};
+
+// At least one side must be a string class: two bare const char* would be
+// compared by address under std::less<const char*>
+template<typename A, typename B>
+struct AreStrings : std::integral_constant<bool,
+    (IsStringClass<A>::value || IsStringClass<B>::value) &&
+    std::is_convertible<const A&, std::string_view>::value &&
+    std::is_convertible<const B&, std::string_view>::value> {};
+
+} // namespace key_compare_detail
+
+template<typename Compare, typename A, typename B>
+inline int compareKeys(const Compare& comp, const A& a, const B& b) {
+    using namespace key_compare_detail;
+    if constexpr (HasCompareMember<Compare, A, B>::value) {
+        return comp.compare(a, b);
+    } else if constexpr (IsStdLess<Compare>::value && AreStrings<A, B>::value) {
+        return std::string_view(a).compare(std::string_view(b));
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+    } else if constexpr (IsStdLess<Compare>::value && std::three_way_comparable_with<A, B>) {
+        auto order = a <=> b;
+        return order < 0 ? -1 : (order > 0 ? 1 : 0);
+#endif
+    } else {
+        return comp(a, b) ? -1 : (comp(b, a) ? 1 : 0);
+    }
+}
+
+#endif // KEY_COMPARE_H
@@ -0,0 +1,68 @@
+#ifndef NGRAM_INDEX_H
+#define NGRAM_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+using namespace std;
+
+// Trigram inverted index for substring search.
+// Every 3-byte window of an (already normalized) text maps to a posting
+// list of the IDs containing it. A pattern of length >= 3 can only occur
+// in texts that contain all of its trigrams, so intersecting those posting
+// lists yields a small candidate set that the caller verifies with a real
+// substring check. Posting lists are sorted ID vectors: contact IDs grow
+// monotonically, so new contacts append at the end.
+// Common trigrams ("ngu", "com") cover most contacts, so erasing from or
+// inserting into the middle of such a list would move megabytes per edit.
+// Removals and out-of-order inserts (a rename or new e-mail of an old
+// contact) go to two small sorted side lists instead, merged back in one
+// pass once they outgrow ~sqrt(list size): O(sqrt n) per edit, amortized.
+class NGramIndex {
+private:
+    static const size_t GRAM = 3;
+    
+    struct Posting {
+        vector<int> ids;    // sorted; may still hold removed IDs
+        vector<int> dead;   // sorted: removed IDs still in ids
+        vector<int> extra;  // sorted: live IDs below ids.back(), not yet in ids
+        size_t sideLimit;   // merge once dead + extra outgrow this
+    
+        Posting() : sideLimit(0) {}
+        size_t live() const { return ids.size() - dead.size() + extra.size(); }
+        bool clean() const { return dead.empty() && extra.empty(); }
+        bool contains(int id) const;
+        bool add(int id);     // false if already present
+        bool remove(int id);  // false if absent
+        void liveIds(vector<int>& out) const;  // Sorted live IDs
+        void compact();
+    };
+    
+    unordered_map<uint32_t, Posting> postings;
+    size_t entries;
+    
+    static uint32_t packGram(string_view text, size_t pos);
+    static void distinctGrams(string_view text, vector<uint32_t>& grams);
+
+public:
+    NGramIndex();
+    
+    // Core operations (text must already be normalized by the caller)
+    void add(int id, string_view text);
+    void remove(int id, string_view text);
+    void clear();
+    
+    // Fills ids with the sorted candidate IDs for pattern. Returns false if
+    // the pattern is shorter than a trigram and the caller must scan instead.
+    bool candidates(string_view pattern, vector<int>& ids) const;
+    
+    // Statistics
+    size_t gramCount() const { return postings.size(); }
+    size_t postingCount() const { return entries; }
+    static size_t minPatternLength() { return GRAM; }
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Node allocators for BinarySearchTree / RedBlackTree.
+//
+// A tree allocator hands out raw storage for one node at a time:
+//   T* allocate();            uninitialized storage for one T
+//   void deallocate(T* p);    p's T has already been destroyed
+//   void release();           drops all storage at once (only when
+//                             releasesAll is true; every T handed out
+//                             must have been destroyed)
+// The tree constructs and destroys the nodes itself.
+
+// Slab/arena pool: nodes are carved out of large slabs in allocation order,
+// so nodes created together (e.g. by buildFromSorted) sit next to each other
+// in memory. Freed nodes go onto an intrusive free list and are reused
+// first. release() frees whole slabs, O(slabs) instead of O(nodes).
+// Slabs grow geometrically (32 nodes up to MAX_SLAB_NODES) so small trees
+// stay small.
+template<typename T>
+class NodePool {
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+    
+    static const size_t MIN_SLAB_NODES = 32;
+    static const size_t MAX_SLAB_NODES = 4096;
+    static const size_t SLOT_SIZE = sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot);
+    
+    std::vector<void*> slabs;
+    FreeSlot* freeList;
+    char* cursor;       // next unused slot in the newest slab
+    char* limit;        // end of the newest slab
+    size_t nextSlabNodes;
+    
+    void grow() {
+        void* slab = ::operator new(SLOT_SIZE * nextSlabNodes);
+        slabs.push_back(slab);
+        cursor = static_cast<char*>(slab);
+        limit = cursor + SLOT_SIZE * nextSlabNodes;
+        if (nextSlabNodes < MAX_SLAB_NODES) {
+            nextSlabNodes *= 2;
+        }
+    }
+
+public:
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "slabs only guarantee operator new alignment");
+    static const bool releasesAll = true;
+    
+    NodePool() : freeList(nullptr), cursor(nullptr), limit(nullptr), nextSlabNodes(MIN_SLAB_NODES) {}
+    ~NodePool() { release(); }
+    
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    
+    T* allocate() {
+        if (freeList != nullptr) {
+            FreeSlot* slot = freeList;
+            freeList = slot->next;
+            return reinterpret_cast<T*>(slot);
+        }
+        if (cursor == limit) {
+            grow();
+        }
+        T* slot = reinterpret_cast<T*>(cursor);
+        cursor += SLOT_SIZE;
+        return slot;
+    }
+    
+    void deallocate(T* p) {
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(p);
+        slot->next = freeList;
+        freeList = slot;
+    }
+    
+    void release() {
+        for (void* slab : slabs) {
+            ::operator delete(slab);
+        }
+        slabs.clear();
+        freeList = nullptr;
+        cursor = nullptr;
+        limit = nullptr;
+        nextSlabNodes = MIN_SLAB_NODES;
+    }
+    
+    size_t slabCount() const { return slabs.size(); }
+};
+
+// One heap allocation per node (the trees' original behaviour); kept for
+// comparison in the benchmarks.
+template<typename T>
+class HeapNodeAllocator {
+public:
+    static const bool releasesAll = false;
+    
+    T* allocate() { return static_cast<T*>(::operator new(sizeof(T))); }
+    void deallocate(T* p) { ::operator delete(p); }
+    void release() {}
+};
+
+#endif // NODE_POOL_H
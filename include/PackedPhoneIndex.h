@@ -0,0 +1,200 @@
+#ifndef PACKED_PHONE_INDEX_H
+#define PACKED_PHONE_INDEX_H
+
+#include "BTree.h"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Phone number index on packed 64-bit keys.
+// A number of up to MAX_DIGITS ASCII digits is packed four bits per digit,
+// from the most significant nibble down, each nibble holding digit + 1 so
+// that 0 marks the end: "0903" -> 0x1A14000000000000. Integer order on
+// packed keys is the lexicographic order of the digit strings, so the
+// numbers starting with a prefix form one contiguous key range, and each
+// number is one 8-byte key in a BTree leaf instead of a std::string in a
+// tree node of its own.
+//
+// Only digit strings can be packed: insert, find and remove report false
+// (or nullptr) for anything else, and a prefix or pattern containing a
+// non-digit matches nothing. Callers normalize formatting first.
+template<typename V>
+class PackedPhoneIndex {
+public:
+    typedef uint64_t Key;
+    typedef BTree<Key, V> Tree;
+    typedef typename Tree::const_iterator const_iterator;
+    
+    static const size_t MAX_DIGITS = 16;  // 16 nibbles in 64 bits
+    
+    // false for an empty string, more than MAX_DIGITS or a non-digit
+    static bool pack(std::string_view digits, Key& key);
+    static std::string unpack(Key key);
+
+private:
+    Tree tree;
+    
+    static bool packPattern(std::string_view digits, Key& pattern, Key& mask);
+
+public:
+    // Core operations (insert replaces the value of an existing number)
+    void insert(Key key, const V& value) { tree.insert(key, value); }
+    bool insert(std::string_view digits, const V& value);
+    V* find(Key key) { return tree.find(key); }
+    const V* find(Key key) const { return tree.find(key); }
+    V* find(std::string_view digits);
+    const V* find(std::string_view digits) const;
+    bool remove(Key key) { return tree.remove(key); }
+    bool remove(std::string_view digits);
+    bool contains(std::string_view digits) const { return find(digits) != nullptr; }
+    
+    // Utility methods
+    size_t size() const { return tree.size(); }
+    bool empty() const { return tree.empty(); }
+    void clear() { tree.clear(); }
+    
+    // Bulk load from (packed key, value) pairs in strictly increasing key
+    // order, as for BTree::buildFromSorted
+    template<typename InputIt>
+    void buildFromSorted(InputIt first, InputIt last) { tree.buildFromSorted(first, last); }
+    
+    // Iteration in number order; entry.first is the packed key
+    const_iterator begin() const { return tree.begin(); }
+    const_iterator end() const { return tree.end(); }
+    
+    // Numbers starting with the digit prefix, in order (all for "")
+    TreeRange<const_iterator> prefixRange(std::string_view digits) const;
+    
+    // Calls fn(value) for every number containing the digits anywhere, in
+    // number order. One pass over the leaves comparing each packed key
+    // against the pattern at every nibble offset; no string is touched.
+    template<typename Fn>
+    void forEachContaining(std::string_view digits, Fn fn) const;
+    
+    // Debug
+    void print() const;
+};
+
+// Implementation
+template<typename V>
+bool PackedPhoneIndex<V>::pack(std::string_view digits, Key& key) {
+    if (digits.empty() || digits.size() > MAX_DIGITS) {
+        return false;
+    }
+    
+    key = 0;
+    unsigned shift = 60;
+    for (char c : digits) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        key |= static_cast<Key>(c - '0' + 1) << shift;
+        shift -= 4;
+    }
+    return true;
+}
+
+template<typename V>
+std::string PackedPhoneIndex<V>::unpack(Key key) {
+    std::string digits;
+    for (; key != 0; key <<= 4) {
+        digits.push_back(static_cast<char>('0' + (key >> 60) - 1));
+    }
+    return digits;
+}
+
+// Pattern nibbles right-aligned, with the mask covering them
+template<typename V>
+bool PackedPhoneIndex<V>::packPattern(std::string_view digits, Key& pattern, Key& mask) {
+    if (!pack(digits, pattern)) {
+        return false;
+    }
+    unsigned unused = 64 - 4 * static_cast<unsigned>(digits.size());
+    pattern >>= unused;
+    mask = ~Key(0) >> unused;
+    return true;
+}
+
+template<typename V>
+bool PackedPhoneIndex<V>::insert(std::string_view digits, const V& value) {
+    Key key;
+    if (!pack(digits, key)) {
+        return false;
+    }
+    tree.insert(key, value);
+    return true;
+}
+
+template<typename V>
+V* PackedPhoneIndex<V>::find(std::string_view digits) {
+    Key key;
+    return pack(digits, key) ? tree.find(key) : nullptr;
+}
+
+template<typename V>
+const V* PackedPhoneIndex<V>::find(std::string_view digits) const {
+    Key key;
+    return pack(digits, key) ? tree.find(key) : nullptr;
+}
+
+template<typename V>
+bool PackedPhoneIndex<V>::remove(std::string_view digits) {
+    Key key;
+    return pack(digits, key) && tree.remove(key);
+}
+
+// A prefix of n digits fixes the top n nibbles: [prefix, prefix + one unit
+// of nibble n). Nibbles hold at most 10, so the addition never carries out.
+template<typename V>
+TreeRange<typename PackedPhoneIndex<V>::const_iterator> PackedPhoneIndex<V>::prefixRange(std::string_view digits) const {
+    if (digits.empty()) {
+        return TreeRange<const_iterator>(begin(), end());
+    }
+    
+    Key lo;
+    if (!pack(digits, lo)) {
+        return TreeRange<const_iterator>(end(), end());
+    }
+    unsigned unused = 64 - 4 * static_cast<unsigned>(digits.size());
+    if (unused == 0) {
+        return TreeRange<const_iterator>(tree.lower_bound(lo), tree.upper_bound(lo));
+    }
+    return tree.range(lo, lo + (Key(1) << unused));
+}
+
+template<typename V>
+template<typename Fn>
+void PackedPhoneIndex<V>::forEachContaining(std::string_view digits, Fn fn) const {
+    Key pattern, mask;
+    if (!packPattern(digits, pattern, mask)) {
+        return;
+    }
+    
+    // The pattern has no zero nibble, so it can never match inside the
+    // zero padding after a number's last digit
+    unsigned lastShift = 64 - 4 * static_cast<unsigned>(digits.size());
+    for (const auto& entry : tree) {
+        Key key = entry.first;
+        for (unsigned shift = lastShift;; shift -= 4) {
+            if (((key >> shift) & mask) == pattern) {
+                fn(entry.second);
+                break;
+            }
+            if (shift == 0) {
+                break;
+            }
+        }
+    }
+}
+
+template<typename V>
+void PackedPhoneIndex<V>::print() const {
+    std::cout << "Packed Phone Index (size: " << tree.size() << ", height: " << tree.height() << "):" << std::endl;
+    for (const auto& entry : tree) {
+        std::cout << "  " << unpack(entry.first) << " -> " << entry.second << std::endl;
+    }
+}
+
+#endif // PACKED_PHONE_INDEX_H
@@ -0,0 +1,100 @@
+#ifndef PARALLEL_TREE_SCAN_H
+#define PARALLEL_TREE_SCAN_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "WorkStealingPool.h"
+
+// In-order scan of a binary search tree spread over a WorkStealingPool,
+// shared by BinarySearchTree and RedBlackTree (their parallelFilter).
+//
+// The tree is cut into segments of consecutive keys as it is scanned, not
+// up front: a segment is walked with an explicit stack whose bottom entry
+// is the largest pending node (the node, then its right subtree). Every
+// SPLIT_CHECK nodes a segment looks at the pool, and if a worker is idle it
+// hands its bottom entry to a new segment and keeps the rest. That entry is
+// the highest pending subtree, near half of what is left in a balanced
+// tree, and every key in it is larger than anything the segment keeps and
+// smaller than what it gave away before, so the new segment is linked
+// right after it. Segments are split further by whoever runs them; the
+// list stays in key order and the outputs are joined along it at the end.
+//
+// No sizes are needed, so both trees work unchanged; the price is that a
+// degenerate BST (a chain) can only be split node by node, and then scales
+// poorly. With no idle worker nothing is split and the caller scans alone.
+//
+// visit(node, out) is called once per node, concurrently from several
+// threads, and appends whatever it wants to keep for that node to out
+// (its segment's vector). The tree must not change during the scan.
+template<typename Out, typename Node, typename Visit>
+std::vector<Out> parallelInOrder(const Node* root, const Node* end, WorkStealingPool& pool, Visit visit) {
+    const size_t SPLIT_CHECK = 256;
+    
+    struct Segment {
+        std::vector<const Node*> pending;  // back() is the next node to visit
+        std::vector<Out> out;
+        Segment* next;
+    };
+    
+    // Owns the segment list, freed without recursion
+    struct Chain {
+        Segment* head;
+        ~Chain() {
+            while (head != nullptr) {
+                Segment* next = head->next;
+                delete head;
+                head = next;
+            }
+        }
+    };
+    
+    Chain chain{new Segment{std::vector<const Node*>(), std::vector<Out>(), nullptr}};
+    for (const Node* node = root; node != end; node = node->left) {
+        chain.head->pending.push_back(node);
+    }
+    
+    // Declared before the group: if visit throws, the group's destructor
+    // waits for the running segments while scan is still alive
+    std::function<void(Segment*)> scan;
+    WorkStealingPool::TaskGroup group(pool);
+    scan = [&](Segment* segment) {
+        std::vector<const Node*>& pending = segment->pending;
+        for (size_t visited = 0; !pending.empty(); visited++) {
+            if (visited % SPLIT_CHECK == 0 && pending.size() >= 2 && pool.wantsWork()) {
+                Segment* part = new Segment{std::vector<const Node*>(1, pending.front()), std::vector<Out>(),
+                                            segment->next};
+                pending.erase(pending.begin());
+                segment->next = part;
+                group.run([&scan, part] { scan(part); });
+            }
+    
+            const Node* node = pending.back();
+            pending.pop_back();
+            visit(node, segment->out);
+            for (const Node* child = node->right; child != end; child = child->left) {
+                pending.push_back(child);
+            }
+        }
+    };
+    scan(chain.head);
+    group.wait();
+    
+    if (chain.head->next == nullptr) {
+        return std::move(chain.head->out);
+    }
+    size_t total = 0;
+    for (const Segment* segment = chain.head; segment != nullptr; segment = segment->next) {
+        total += segment->out.size();
+    }
+    std::vector<Out> result;
+    result.reserve(total);
+    for (Segment* segment = chain.head; segment != nullptr; segment = segment->next) {
+        for (Out& item : segment->out) {
+            result.push_back(std::move(item));
+        }
+    }
+    return result;
+}
+
+#endif
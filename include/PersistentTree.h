@@ -0,0 +1,698 @@
+#ifndef PERSISTENT_TREE_H
+#define PERSISTENT_TREE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "EpochReclaimer.h"
+#include "KeyCompare.h"
+#include "TreeIterator.h"
+
+// Persistent (path-copying) search tree for readers that take no lock.
+//
+// A write never changes a node a reader can reach: it copies the nodes on
+// the path it modifies, links the copies to the untouched subtrees and
+// publishes the new root with one atomic store. A reader takes a Snapshot
+// (pins an epoch, loads the root) and walks that immutable version; a scan
+// sees exactly one version however long it runs, and writers never wait
+// for it. Nodes replaced by a write are handed to the EpochReclaimer after
+// the root store and freed once no snapshot can still reach them.
+//
+// Writers are serialized by an internal mutex. A write allocates O(depth)
+// new nodes (keys copied), so single-threaded writes cost more than
+// RedBlackTree's in-place updates: the trade is for read-mostly indexes.
+//
+// Balanced = true keeps a left-leaning red-black tree (Sedgewick's LLRB,
+// height <= 2 log2 n, recursive updates); false is a plain BST, iterative
+// like BinarySearchTree. PersistentRedBlackTree / PersistentBinarySearchTree
+// below name the two. Keys are ordered by Compare through compareKeys (see
+// KeyCompare.h); lookups accept any Q that Compare orders against K.
+template<typename K, typename V, bool Balanced, typename Compare = std::less<K>>
+class PersistentTree {
+private:
+    struct Node {
+        K key;
+        V value;
+        Node* left;
+        Node* right;
+        uint64_t version;  // Write that created the node; only the current write's nodes are mutable
+        bool red;
+    
+        template<typename Key>
+        Node(Key&& k, const V& v, uint64_t ver)
+            : key(std::forward<Key>(k)), value(v), left(nullptr), right(nullptr), version(ver), red(true) {}
+    };
+    
+    std::atomic<Node*> root_;
+    std::atomic<size_t> size_;
+    std::mutex writeLock;
+    Compare comp_;
+    
+    // State of the write in progress (writeLock held)
+    uint64_t version_;
+    std::vector<Node*> created_;   // new nodes, deleted if the write throws
+    std::vector<Node*> replaced_;  // published nodes the new version no longer uses
+    std::vector<Node*> dropped_;   // new nodes the write itself discarded
+    std::vector<Node*> path_;      // BST descents
+    std::vector<bool> wentLeft_;
+    
+    template<typename Fn>
+    void write(Fn update);
+    template<typename Key>
+    Node* createNode(Key&& key, const V& value);
+    Node* own(Node* node);
+    void discard(Node* node);
+    template<typename Q>
+    const Node* findIn(const Node* node, const Q& key) const;
+    
+    // LLRB
+    static bool isRed(const Node* node) { return node != nullptr && node->red; }
+    Node* rotateLeft(Node* h);
+    Node* rotateRight(Node* h);
+    void flipColors(Node* h);
+    Node* balance(Node* h);
+    Node* moveRedLeft(Node* h);
+    Node* moveRedRight(Node* h);
+    template<typename Key>
+    Node* insertBalanced(Node* h, Key&& key, const V& value, bool& added);
+    template<typename Q>
+    Node* removeBalanced(Node* h, const Q& key);
+    Node* removeMinBalanced(Node* h);
+    
+    // BST
+    template<typename Key>
+    Node* insertPlain(Node* root, Key&& key, const V& value, bool& added);
+    template<typename Q>
+    Node* removePlain(Node* root, const Q& key);
+    Node* relinkPath(Node* child);
+    
+    template<typename Key>
+    void insertKey(Key&& key, const V& value);
+    static void collectNodes(Node* root, std::vector<Node*>& nodes);
+    static void reserveOneMore(std::vector<Node*>& nodes);
+
+public:
+    // Forward in-order iterator over one snapshot (explicit stack, no parent pointers)
+    class const_iterator {
+    private:
+        friend class PersistentTree;
+        std::vector<const Node*> stack;  // top = current node
+    
+        void pushLeftSpine(const Node* node) {
+            for (; node != nullptr; node = node->left) {
+                stack.push_back(node);
+            }
+        }
+    
+    public:
+        struct reference {
+            const K& first;
+            const V& second;
+        };
+    
+        struct pointer {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+    
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const K, V>;
+        using difference_type = std::ptrdiff_t;
+    
+        reference operator*() const { return reference{stack.back()->key, stack.back()->value}; }
+        pointer operator->() const { return pointer{**this}; }
+    
+        const_iterator& operator++() {
+            const Node* node = stack.back();
+            stack.pop_back();
+            pushLeftSpine(node->right);
+            return *this;
+        }
+    
+        bool operator==(const const_iterator& other) const {
+            return stack.empty() ? other.stack.empty() : !other.stack.empty() && stack.back() == other.stack.back();
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    };
+    
+    // One immutable version, readable while the snapshot lives (it keeps
+    // the calling thread pinned: do not hold one across blocking waits)
+    class Snapshot {
+    private:
+        EpochReclaimer::Guard guard;  // Pinned before the root is loaded
+        const PersistentTree* tree;
+        const Node* root;
+    
+    public:
+        explicit Snapshot(const PersistentTree* t) : tree(t), root(t->root_.load()) {}
+    
+        bool empty() const { return root == nullptr; }
+    
+        template<typename Q>
+        const V* find(const Q& key) const {
+            const Node* node = tree->findIn(root, key);
+            return node != nullptr ? &node->value : nullptr;
+        }
+        template<typename Q>
+        bool contains(const Q& key) const { return find(key) != nullptr; }
+    
+        const_iterator begin() const {
+            const_iterator it;
+            it.pushLeftSpine(root);
+            return it;
+        }
+        const_iterator end() const { return const_iterator(); }
+    
+        // First key not ordered before key
+        template<typename Q>
+        const_iterator lower_bound(const Q& key) const {
+            const_iterator it;
+            for (const Node* node = root; node != nullptr;) {
+                if (compareKeys(tree->comp_, node->key, key) < 0) {
+                    node = node->right;
+                } else {
+                    it.stack.push_back(node);
+                    node = node->left;
+                }
+            }
+            return it;
+        }
+    
+        TreeRange<const_iterator> prefixRange(const K& prefix) const {  // string keys starting with prefix
+            K upper;
+            if (!prefixUpperBound(prefix, upper)) {
+                return TreeRange<const_iterator>(lower_bound(prefix), end());
+            }
+            return TreeRange<const_iterator>(lower_bound(prefix), lower_bound(upper));
+        }
+    };
+    
+    PersistentTree() : root_(nullptr), size_(0), version_(0) {}
+    ~PersistentTree();  // No snapshot may outlive the tree
+    
+    PersistentTree(const PersistentTree&) = delete;
+    PersistentTree& operator=(const PersistentTree&) = delete;
+    
+    // Readers: lock-free, never blocked by writers
+    Snapshot snapshot() const { return Snapshot(this); }
+    template<typename Q>
+    bool contains(const Q& key) const { return snapshot().contains(key); }
+    template<typename Q>
+    bool get(const Q& key, V& value) const;  // Copies the value out
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+    
+    // Writers: serialized among themselves, never wait for readers
+    void insert(const K& key, const V& value) { insertKey(key, value); }
+    void insert(K&& key, const V& value) { insertKey(std::move(key), value); }  // Moves key into the new node
+    template<typename Q>
+    bool remove(const Q& key);
+    void clear();
+    
+    // Bulk load in one write: replaces the contents. [first, last) must
+    // yield pairs (first = key, second = value) in strictly increasing key
+    // order. O(n) for the BST (perfectly balanced), O(n log n) for the LLRB
+    // (inserted in order; no node is copied since all are new).
+    template<typename InputIt>
+    void buildFromSorted(InputIt first, InputIt last);
+};
+
+template<typename K, typename V, typename Compare = std::less<K>>
+using PersistentRedBlackTree = PersistentTree<K, V, true, Compare>;
+
+template<typename K, typename V, typename Compare = std::less<K>>
+using PersistentBinarySearchTree = PersistentTree<K, V, false, Compare>;
+
+// Implementation
+template<typename K, typename V, bool Balanced, typename Compare>
+PersistentTree<K, V, Balanced, Compare>::~PersistentTree() {
+    // Nodes already retired belong to the reclaimer; the live ones are ours
+    std::vector<Node*> nodes;
+    collectNodes(root_.load(), nodes);
+    for (Node* node : nodes) {
+        delete node;
+    }
+}
+
+// Runs update(root) -> new root as one write and publishes the result
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Fn>
+void PersistentTree<K, V, Balanced, Compare>::write(Fn update) {
+    std::lock_guard<std::mutex> guard(writeLock);
+    version_++;
+    Node* root;
+    try {
+        root = update(root_.load(std::memory_order_relaxed));
+    } catch (...) {
+        // Nothing was published: the old version is intact, the new nodes go
+        for (Node* node : created_) {
+            delete node;
+        }
+        created_.clear();
+        replaced_.clear();
+        dropped_.clear();
+        throw;
+    }
+    
+    root_.store(root);
+    for (Node* node : dropped_) {
+        delete node;
+    }
+    EpochReclaimer& reclaimer = EpochReclaimer::getInstance();
+    reclaimer.retireAll(replaced_);
+    reclaimer.collect();
+    created_.clear();
+    replaced_.clear();
+    dropped_.clear();
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Key>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::createNode(Key&& key, const V& value) {
+    reserveOneMore(created_);  // Never leak the node on push_back
+    Node* node = new Node(std::forward<Key>(key), value, version_);
+    created_.push_back(node);
+    return node;
+}
+
+// Mutable version of node for the current write: itself when the write
+// created it, otherwise a copy (the original is retired at publish)
+template<typename K, typename V, bool Balanced, typename Compare>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::own(Node* node) {
+    if (node->version == version_) {
+        return node;
+    }
+    reserveOneMore(replaced_);
+    Node* copy = createNode(node->key, node->value);
+    copy->left = node->left;
+    copy->right = node->right;
+    copy->red = node->red;
+    replaced_.push_back(node);
+    return copy;
+}
+
+// Room for one more push_back that cannot throw. Grows geometrically:
+// reserve(size() + 1) would reallocate on every node (libstdc++ reserves
+// exactly), making buildFromSorted quadratic
+template<typename K, typename V, bool Balanced, typename Compare>
+void PersistentTree<K, V, Balanced, Compare>::reserveOneMore(std::vector<Node*>& nodes) {
+    if (nodes.size() == nodes.capacity()) {
+        nodes.reserve(2 * nodes.size() + 16);
+    }
+}
+
+// node leaves the tree
+template<typename K, typename V, bool Balanced, typename Compare>
+void PersistentTree<K, V, Balanced, Compare>::discard(Node* node) {
+    if (node->version == version_) {
+        dropped_.push_back(node);
+    } else {
+        replaced_.push_back(node);
+    }
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Q>
+const typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::findIn(const Node* node, const Q& key) const {
+    while (node != nullptr) {
+        int order = compareKeys(comp_, key, node->key);
+        if (order == 0) {
+            return node;
+        }
+        node = order < 0 ? node->left : node->right;
+    }
+    return nullptr;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Q>
+bool PersistentTree<K, V, Balanced, Compare>::get(const Q& key, V& value) const {
+    Snapshot view = snapshot();
+    const V* found = view.find(key);
+    if (found == nullptr) {
+        return false;
+    }
+    value = *found;
+    return true;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Key>
+void PersistentTree<K, V, Balanced, Compare>::insertKey(Key&& key, const V& value) {
+    bool added = false;
+    write([&](Node* root) {
+        if (Balanced) {
+            root = insertBalanced(root, std::forward<Key>(key), value, added);
+            root->red = false;
+            return root;
+        }
+        return insertPlain(root, std::forward<Key>(key), value, added);
+    });
+    if (added) {
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Q>
+bool PersistentTree<K, V, Balanced, Compare>::remove(const Q& key) {
+    bool removed = false;
+    write([&](Node* root) {
+        if (findIn(root, key) == nullptr) {
+            return root;
+        }
+        removed = true;
+        if (!Balanced) {
+            return removePlain(root, key);
+        }
+    
+        root = own(root);
+        if (!isRed(root->left) && !isRed(root->right)) {
+            root->red = true;
+        }
+        root = removeBalanced(root, key);
+        if (root != nullptr) {
+            root->red = false;
+        }
+        return root;
+    });
+    if (removed) {
+        size_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return removed;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+void PersistentTree<K, V, Balanced, Compare>::clear() {
+    write([&](Node* root) -> Node* {
+        collectNodes(root, replaced_);
+        return nullptr;
+    });
+    size_.store(0, std::memory_order_relaxed);
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename InputIt>
+void PersistentTree<K, V, Balanced, Compare>::buildFromSorted(InputIt first, InputIt last) {
+    size_t count = 0;
+    write([&](Node* root) -> Node* {
+        collectNodes(root, replaced_);
+        if (Balanced) {
+            // In order: every descent ends at the rightmost leaf, no node is copied
+            Node* built = nullptr;
+            for (; first != last; ++first, ++count) {
+                bool added = false;
+                built = insertBalanced(built, (*first).first, (*first).second, added);
+                built->red = false;
+            }
+            return built;
+        }
+    
+        // Allocate in key order (adjacent keys adjacent in memory), then
+        // link by repeatedly taking the middle element
+        std::vector<Node*> nodes;
+        for (; first != last; ++first) {
+            nodes.push_back(createNode((*first).first, (*first).second));
+        }
+        count = nodes.size();
+        struct Span {
+            size_t lo;
+            size_t hi;
+            Node** link;
+        };
+        Node* built = nullptr;
+        std::vector<Span> stack;
+        stack.push_back(Span{0, nodes.size(), &built});
+        while (!stack.empty()) {
+            Span span = stack.back();
+            stack.pop_back();
+            if (span.lo == span.hi) {
+                continue;
+            }
+            size_t mid = span.lo + (span.hi - span.lo) / 2;
+            *span.link = nodes[mid];
+            stack.push_back(Span{span.lo, mid, &nodes[mid]->left});
+            stack.push_back(Span{mid + 1, span.hi, &nodes[mid]->right});
+        }
+        return built;
+    });
+    size_.store(count, std::memory_order_relaxed);
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+void PersistentTree<K, V, Balanced, Compare>::collectNodes(Node* root, std::vector<Node*>& nodes) {
+    std::vector<Node*> stack;
+    if (root != nullptr) {
+        stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        nodes.push_back(node);
+        if (node->left != nullptr) {
+            stack.push_back(node->left);
+        }
+        if (node->right != nullptr) {
+            stack.push_back(node->right);
+        }
+    }
+}
+
+// LLRB, after Sedgewick's RedBlackBST. Every function receives or returns
+// nodes owned by the current write; children are owned before they change.
+template<typename K, typename V, bool Balanced, typename Compare>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::rotateLeft(Node* h) {
+    Node* x = own(h->right);
+    h->right = x->left;
+    x->left = h;
+    x->red = h->red;
+    h->red = true;
+    return x;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::rotateRight(Node* h) {
+    Node* x = own(h->left);
+    h->left = x->right;
+    x->right = h;
+    x->red = h->red;
+    h->red = true;
+    return x;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+void PersistentTree<K, V, Balanced, Compare>::flipColors(Node* h) {
+    h->red = !h->red;
+    h->left = own(h->left);
+    h->left->red = !h->left->red;
+    h->right = own(h->right);
+    h->right->red = !h->right->red;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::balance(Node* h) {
+    if (isRed(h->right) && !isRed(h->left)) {
+        h = rotateLeft(h);
+    }
+    if (isRed(h->left) && isRed(h->left->left)) {
+        h = rotateRight(h);
+    }
+    if (isRed(h->left) && isRed(h->right)) {
+        flipColors(h);
+    }
+    return h;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::moveRedLeft(Node* h) {
+    flipColors(h);
+    if (isRed(h->right->left)) {
+        h->right = rotateRight(h->right);
+        h = rotateLeft(h);
+        flipColors(h);
+    }
+    return h;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::moveRedRight(Node* h) {
+    flipColors(h);
+    if (isRed(h->left->left)) {
+        h = rotateRight(h);
+        flipColors(h);
+    }
+    return h;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Key>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::insertBalanced(Node* h, Key&& key, const V& value, bool& added) {
+    if (h == nullptr) {
+        added = true;
+        return createNode(std::forward<Key>(key), value);
+    }
+    
+    h = own(h);
+    int order = compareKeys(comp_, key, h->key);
+    if (order < 0) {
+        h->left = insertBalanced(h->left, std::forward<Key>(key), value, added);
+    } else if (order > 0) {
+        h->right = insertBalanced(h->right, std::forward<Key>(key), value, added);
+    } else {
+        h->value = value;
+    }
+    return balance(h);
+}
+
+// key is in the subtree rooted at h
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Q>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::removeBalanced(Node* h, const Q& key) {
+    h = own(h);
+    if (compareKeys(comp_, key, h->key) < 0) {
+        if (!isRed(h->left) && !isRed(h->left->left)) {
+            h = moveRedLeft(h);
+        }
+        h->left = removeBalanced(h->left, key);
+    } else {
+        if (isRed(h->left)) {
+            h = rotateRight(h);
+        }
+        if (compareKeys(comp_, key, h->key) == 0 && h->right == nullptr) {
+            discard(h);
+            return nullptr;
+        }
+        if (!isRed(h->right) && !isRed(h->right->left)) {
+            h = moveRedRight(h);
+        }
+        if (compareKeys(comp_, key, h->key) == 0) {
+            // Take over the successor's entry, then remove the successor
+            Node* successor = h->right;
+            while (successor->left != nullptr) {
+                successor = successor->left;
+            }
+            h->key = successor->key;
+            h->value = successor->value;
+            h->right = removeMinBalanced(h->right);
+        } else {
+            h->right = removeBalanced(h->right, key);
+        }
+    }
+    return balance(h);
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::removeMinBalanced(Node* h) {
+    if (h->left == nullptr) {
+        discard(h);  // No right child either: it would be a red right link
+        return nullptr;
+    }
+    
+    h = own(h);
+    if (!isRed(h->left) && !isRed(h->left->left)) {
+        h = moveRedLeft(h);
+    }
+    h->left = removeMinBalanced(h->left);
+    return balance(h);
+}
+
+// BST: descend recording the path (path_, wentLeft_), then copy it bottom-up
+template<typename K, typename V, bool Balanced, typename Compare>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::relinkPath(Node* child) {
+    for (size_t i = path_.size(); i-- > 0;) {
+        Node* parent = own(path_[i]);
+        if (wentLeft_[i]) {
+            parent->left = child;
+        } else {
+            parent->right = child;
+        }
+        child = parent;
+    }
+    path_.clear();
+    wentLeft_.clear();
+    return child;
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Key>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::insertPlain(Node* root, Key&& key, const V& value, bool& added) {
+    path_.clear();
+    wentLeft_.clear();
+    Node* node = root;
+    while (node != nullptr) {
+        int order = compareKeys(comp_, key, node->key);
+        if (order == 0) {
+            break;
+        }
+        path_.push_back(node);
+        wentLeft_.push_back(order < 0);
+        node = order < 0 ? node->left : node->right;
+    }
+    
+    if (node != nullptr) {
+        node = own(node);
+        node->value = value;
+    } else {
+        node = createNode(std::forward<Key>(key), value);
+        added = true;
+    }
+    return relinkPath(node);
+}
+
+template<typename K, typename V, bool Balanced, typename Compare>
+template<typename Q>
+typename PersistentTree<K, V, Balanced, Compare>::Node*
+PersistentTree<K, V, Balanced, Compare>::removePlain(Node* root, const Q& key) {
+    path_.clear();
+    wentLeft_.clear();
+    Node* z = root;
+    for (int order; (order = compareKeys(comp_, key, z->key)) != 0;) {
+        path_.push_back(z);
+        wentLeft_.push_back(order < 0);
+        z = order < 0 ? z->left : z->right;
+    }
+    
+    Node* replacement;
+    if (z->left == nullptr || z->right == nullptr) {
+        replacement = z->left != nullptr ? z->left : z->right;
+    } else {
+        // Successor: leftmost of the right subtree. The left spine down to
+        // it is copied with the successor's right subtree in its place.
+        std::vector<Node*> spine;
+        Node* successor = z->right;
+        while (successor->left != nullptr) {
+            spine.push_back(successor);
+            successor = successor->left;
+        }
+        Node* right = successor->right;
+        for (size_t i = spine.size(); i-- > 0;) {
+            Node* copy = own(spine[i]);
+            copy->left = right;
+            right = copy;
+        }
+        replacement = own(successor);
+        replacement->left = z->left;
+        replacement->right = right;
+    }
+    discard(z);
+    return relinkPath(replacement);
+}
+
+#endif // PERSISTENT_TREE_H
@@ -1,11 +1,23 @@
 #ifndef RED_BLACK_TREE_H
 #define RED_BLACK_TREE_H
 
+#include <functional>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <utility>
+#include <new>
+#include <type_traits>
+#include "TreeIterator.h"
+#include "KeyCompare.h"
+#include "NodePool.h"
+#include "ParallelTreeScan.h"
 
-template<typename K, typename V>
+// Nodes come from Allocator<Node> (see NodePool.h); the nil sentinel is a
+// separate heap object so releasing the pool never touches it. Keys are
+// ordered by Compare, which must be a strict weak ordering; descents make
+// one three-way comparison per node (see KeyCompare.h).
+template<typename K, typename V, template<typename> class Allocator = NodePool, typename Compare = std::less<K>>
 class RedBlackTree {
 private:
     enum Color { RED, BLACK };
@@ -18,27 +30,46 @@ private:
         Node* right;
         Node* parent;
         
-        Node(const K& k, const V& v) : key(k), value(v), color(RED), 
-                                      left(nullptr), right(nullptr), parent(nullptr) {}
+        template<typename Key>
+        Node(Key&& k, const V& v) : key(std::forward<Key>(k)), value(v), color(RED), 
+                                    left(nullptr), right(nullptr), parent(nullptr) {}
     };
     
     Node* root;
     Node* nil;  // Sentinel node
     size_t size_;
+    Allocator<Node> pool;
+    Compare comp_;
     
     // Helper methods
+    template<typename Key>
+    Node* createNode(Key&& key, const V& value);
+    template<typename Key>
+    void insertKey(Key&& key, const V& value);
+    void destroyNode(Node* node);
     void leftRotate(Node* x);
     void rightRotate(Node* x);
     void insertFixup(Node* z);
     void deleteFixup(Node* x);
     void transplant(Node* u, Node* v);
-    Node* findRecursive(Node* node, const K& key) const;
-    void inorderTraversal(Node* node, std::vector<V>& result) const;
-    void clearRecursive(Node* node);
-    void printRecursive(Node* node, int depth) const;
-    void getAllPairsRecursive(Node* node, std::vector<std::pair<K, V>>& result) const;
+    template<typename Q>
+    Node* findNode(const Q& key) const;
+    Node* minimum(Node* node) const;
+    Node* maximum(Node* node) const;
+    Node* successor(Node* node) const;
+    Node* predecessor(Node* node) const;
+    template<typename Q>
+    Node* lowerBoundNode(const Q& key) const;
+    template<typename Q>
+    Node* upperBoundNode(const Q& key) const;
+    void eraseNode(Node* z);
+    
+    template<typename, typename, bool> friend class TreeIterator;
     
 public:
+    using iterator = TreeIterator<RedBlackTree, Node, false>;
+    using const_iterator = TreeIterator<RedBlackTree, Node, true>;
+    
     RedBlackTree() : size_(0) {
         nil = new Node(K(), V());
         nil->color = BLACK;
@@ -50,8 +81,12 @@ public:
         delete nil;
     }
     
+    RedBlackTree(const RedBlackTree&) = delete;
+    RedBlackTree& operator=(const RedBlackTree&) = delete;
+    
     // Core operations
     void insert(const K& key, const V& value);
+    void insert(K&& key, const V& value);  // Moves key into the new node
     V* find(const K& key);
     const V* find(const K& key) const;
     bool remove(const K& key);
@@ -61,18 +96,88 @@ public:
     size_t size() const { return size_; }
     bool empty() const { return size_ == 0; }
     void clear();
+    
+    // Bulk load: replaces the contents with a perfectly balanced tree in O(n).
+    // [first, last) must yield pairs (first = key, second = value) in
+    // strictly increasing key order. Keys are copied, or moved when given
+    // move iterators (std::make_move_iterator).
+    template<typename InputIt>
+    void buildFromSorted(InputIt first, InputIt last);
+    
     std::vector<V> getAllValues() const;
     
     // Debug
     void print() const;
     
-    // Iterator-like functionality
+    // In-order iteration (no allocation, no copies of keys)
+    iterator begin() { return iterator(this, minimum(root)); }
+    iterator end() { return iterator(this, nil); }
+    const_iterator begin() const { return const_iterator(this, minimum(root)); }
+    const_iterator end() const { return const_iterator(this, nil); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    
+    // Ordered queries
+    iterator lower_bound(const K& key) { return iterator(this, lowerBoundNode(key)); }
+    iterator upper_bound(const K& key) { return iterator(this, upperBoundNode(key)); }
+    const_iterator lower_bound(const K& key) const { return const_iterator(this, lowerBoundNode(key)); }
+    const_iterator upper_bound(const K& key) const { return const_iterator(this, upperBoundNode(key)); }
+    TreeRange<const_iterator> range(const K& lo, const K& hi) const;  // keys in [lo, hi)
+    TreeRange<const_iterator> prefixRange(const K& prefix) const;    // string keys starting with prefix
+    
+    // Heterogeneous lookup, only when Compare is transparent (e.g.
+    // std::less<>): key may be any type Compare orders against K, such as a
+    // string_view or const char* against string keys, and no K is built.
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    V* find(const Q& key) {
+        Node* node = findNode(key);
+        return node != nil ? &(node->value) : nullptr;
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const V* find(const Q& key) const {
+        Node* node = findNode(key);
+        return node != nil ? &(node->value) : nullptr;
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    bool contains(const Q& key) const { return findNode(key) != nil; }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    bool remove(const Q& key) {
+        Node* z = findNode(key);
+        if (z == nil) {
+            return false;
+        }
+        eraseNode(z);
+        return true;
+    }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    iterator lower_bound(const Q& key) { return iterator(this, lowerBoundNode(key)); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    iterator upper_bound(const Q& key) { return iterator(this, upperBoundNode(key)); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator lower_bound(const Q& key) const { return const_iterator(this, lowerBoundNode(key)); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator upper_bound(const Q& key) const { return const_iterator(this, upperBoundNode(key)); }
+    template<typename Q, typename C = Compare, typename = typename C::is_transparent>
+    TreeRange<const_iterator> range(const Q& lo, const Q& hi) const {
+        if (!comp_(lo, hi)) {
+            return TreeRange<const_iterator>(end(), end());
+        }
+        return TreeRange<const_iterator>(lower_bound(lo), lower_bound(hi));
+    }
+    
+    // Snapshot copy of all pairs (prefer iterators for scans)
     std::vector<std::pair<K, V>> getAllPairs() const;
+    
+    // Values of the entries where pred(key, value) holds, in key order, with
+    // the walk spread over pool's threads (see ParallelTreeScan.h). pred is
+    // called from several threads at once; the tree must not change meanwhile.
+    template<typename Pred>
+    std::vector<V> parallelFilter(Pred pred, WorkStealingPool& pool = WorkStealingPool::shared()) const;
 };
 
 // Implementation
-template<typename K, typename V>
-void RedBlackTree<K, V>::leftRotate(Node* x) {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::leftRotate(Node* x) {
     Node* y = x->right;
     x->right = y->left;
     
@@ -94,8 +199,8 @@ void RedBlackTree<K, V>::leftRotate(Node* x) {
     x->parent = y;
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::rightRotate(Node* x) {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::rightRotate(Node* x) {
     Node* y = x->left;
     x->left = y->right;
     
@@ -117,8 +222,8 @@ void RedBlackTree<K, V>::rightRotate(Node* x) {
     x->parent = y;
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::insertFixup(Node* z) {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::insertFixup(Node* z) {
     while (z->parent && z->parent->color == RED) {
         if (z->parent == z->parent->parent->left) {
             Node* y = z->parent->parent->right;
@@ -162,22 +267,35 @@ void RedBlackTree<K, V>::insertFixup(Node* z) {
     root->color = BLACK;
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::insert(const K& key, const V& value) {
-    Node* z = new Node(key, value);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::insert(const K& key, const V& value) {
+    insertKey(key, value);
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::insert(K&& key, const V& value) {
+    insertKey(std::move(key), value);
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Key>
+void RedBlackTree<K, V, Allocator, Compare>::insertKey(Key&& key, const V& value) {
+    Node* z = createNode(std::forward<Key>(key), value);
     Node* y = nullptr;
     Node* x = root;
+    int order = 0;  // z->key vs y->key, reused to link z
     
     while (x != nil) {
         y = x;
-        if (z->key < x->key) {
+        order = compareKeys(comp_, z->key, x->key);
+        if (order < 0) {
             x = x->left;
-        } else if (z->key > x->key) {
+        } else if (order > 0) {
             x = x->right;
         } else {
             // Key already exists, update value
             x->value = value;
-            delete z;
+            destroyNode(z);
             return;
         }
     }
@@ -185,7 +303,7 @@ void RedBlackTree<K, V>::insert(const K& key, const V& value) {
     z->parent = y;
     if (y == nullptr) {
         root = z;
-    } else if (z->key < y->key) {
+    } else if (order < 0) {
         y->left = z;
     } else {
         y->right = z;
@@ -199,38 +317,151 @@ void RedBlackTree<K, V>::insert(const K& key, const V& value) {
     size_++;
 }
 
-template<typename K, typename V>
-typename RedBlackTree<K, V>::Node* RedBlackTree<K, V>::findRecursive(Node* node, const K& key) const {
-    if (node == nil || node->key == key) {
-        return node;
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Q>
+typename RedBlackTree<K, V, Allocator, Compare>::Node* RedBlackTree<K, V, Allocator, Compare>::findNode(const Q& key) const {
+    Node* node = root;
+    while (node != nil) {
+        int order = compareKeys(comp_, key, node->key);
+        if (order < 0) {
+            node = node->left;
+        } else if (order > 0) {
+            node = node->right;
+        } else {
+            break;
+        }
+    }
+    return node;
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+typename RedBlackTree<K, V, Allocator, Compare>::Node* RedBlackTree<K, V, Allocator, Compare>::minimum(Node* node) const {
+    if (node == nil) {
+        return nil;
+    }
+    while (node->left != nil) {
+        node = node->left;
+    }
+    return node;
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+typename RedBlackTree<K, V, Allocator, Compare>::Node* RedBlackTree<K, V, Allocator, Compare>::maximum(Node* node) const {
+    if (node == nil) {
+        return nil;
+    }
+    while (node->right != nil) {
+        node = node->right;
+    }
+    return node;
+}
+
+// In-order successor via parent pointers; returns nil past the last node
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+typename RedBlackTree<K, V, Allocator, Compare>::Node* RedBlackTree<K, V, Allocator, Compare>::successor(Node* node) const {
+    if (node->right != nil) {
+        return minimum(node->right);
     }
     
-    if (key < node->key) {
-        return findRecursive(node->left, key);
+    Node* parent = node->parent;
+    while (parent != nullptr && node == parent->right) {
+        node = parent;
+        parent = parent->parent;
+    }
+    return parent ? parent : nil;
+}
+
+// In-order predecessor; predecessor(nil) (i.e. of end()) is the maximum
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+typename RedBlackTree<K, V, Allocator, Compare>::Node* RedBlackTree<K, V, Allocator, Compare>::predecessor(Node* node) const {
+    if (node == nil) {
+        return maximum(root);
+    }
+    
+    if (node->left != nil) {
+        return maximum(node->left);
     }
     
-    return findRecursive(node->right, key);
+    Node* parent = node->parent;
+    while (parent != nullptr && node == parent->left) {
+        node = parent;
+        parent = parent->parent;
+    }
+    return parent ? parent : nil;
 }
 
-template<typename K, typename V>
-V* RedBlackTree<K, V>::find(const K& key) {
-    Node* node = findRecursive(root, key);
+// First node whose key is not less than key (nil if none)
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Q>
+typename RedBlackTree<K, V, Allocator, Compare>::Node* RedBlackTree<K, V, Allocator, Compare>::lowerBoundNode(const Q& key) const {
+    Node* result = nil;
+    Node* node = root;
+    while (node != nil) {
+        if (comp_(node->key, key)) {
+            node = node->right;
+        } else {
+            result = node;
+            node = node->left;
+        }
+    }
+    return result;
+}
+
+// First node whose key is greater than key (nil if none)
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Q>
+typename RedBlackTree<K, V, Allocator, Compare>::Node* RedBlackTree<K, V, Allocator, Compare>::upperBoundNode(const Q& key) const {
+    Node* result = nil;
+    Node* node = root;
+    while (node != nil) {
+        if (comp_(key, node->key)) {
+            result = node;
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    return result;
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+TreeRange<typename RedBlackTree<K, V, Allocator, Compare>::const_iterator> RedBlackTree<K, V, Allocator, Compare>::range(const K& lo, const K& hi) const {
+    if (!comp_(lo, hi)) {
+        return TreeRange<const_iterator>(end(), end());
+    }
+    return TreeRange<const_iterator>(lower_bound(lo), lower_bound(hi));
+}
+
+// Keys sharing a prefix are contiguous in order: seek to lower_bound(prefix)
+// and stop at the first key past the prefix, O(log n + k)
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+TreeRange<typename RedBlackTree<K, V, Allocator, Compare>::const_iterator> RedBlackTree<K, V, Allocator, Compare>::prefixRange(const K& prefix) const {
+    K upper;
+    if (!prefixUpperBound(prefix, upper)) {
+        return TreeRange<const_iterator>(lower_bound(prefix), end());
+    }
+    return TreeRange<const_iterator>(lower_bound(prefix), lower_bound(upper));
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+V* RedBlackTree<K, V, Allocator, Compare>::find(const K& key) {
+    Node* node = findNode(key);
     return (node != nil) ? &(node->value) : nullptr;
 }
 
-template<typename K, typename V>
-const V* RedBlackTree<K, V>::find(const K& key) const {
-    Node* node = findRecursive(root, key);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+const V* RedBlackTree<K, V, Allocator, Compare>::find(const K& key) const {
+    Node* node = findNode(key);
     return (node != nil) ? &(node->value) : nullptr;
 }
 
-template<typename K, typename V>
-bool RedBlackTree<K, V>::contains(const K& key) const {
-    return findRecursive(root, key) != nil;
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+bool RedBlackTree<K, V, Allocator, Compare>::contains(const K& key) const {
+    return findNode(key) != nil;
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::transplant(Node* u, Node* v) {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::transplant(Node* u, Node* v) {
     if (u->parent == nullptr) {
         root = v;
     } else if (u == u->parent->left) {
@@ -242,8 +473,8 @@ void RedBlackTree<K, V>::transplant(Node* u, Node* v) {
     v->parent = u->parent;
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::deleteFixup(Node* x) {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::deleteFixup(Node* x) {
     while (x != root && x->color == BLACK) {
         if (x == x->parent->left) {
             Node* w = x->parent->right;
@@ -305,13 +536,18 @@ void RedBlackTree<K, V>::deleteFixup(Node* x) {
     x->color = BLACK;
 }
 
-template<typename K, typename V>
-bool RedBlackTree<K, V>::remove(const K& key) {
-    Node* z = findRecursive(root, key);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+bool RedBlackTree<K, V, Allocator, Compare>::remove(const K& key) {
+    Node* z = findNode(key);
     if (z == nil) {
         return false;
     }
-    
+    eraseNode(z);
+    return true;
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::eraseNode(Node* z) {
     Node* y = z;
     Node* x;
     Color yOriginalColor = y->color;
@@ -345,81 +581,189 @@ bool RedBlackTree<K, V>::remove(const K& key) {
         y->color = z->color;
     }
     
-    delete z;
+    destroyNode(z);
     
     if (yOriginalColor == BLACK) {
         deleteFixup(x);
     }
     
     size_--;
-    return true;
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::inorderTraversal(Node* node, std::vector<V>& result) const {
-    if (node != nil) {
-        inorderTraversal(node->left, result);
-        result.push_back(node->value);
-        inorderTraversal(node->right, result);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename InputIt>
+void RedBlackTree<K, V, Allocator, Compare>::buildFromSorted(InputIt first, InputIt last) {
+    clear();
+    
+    // Allocate the nodes in key order first (adjacent keys end up adjacent
+    // in memory), then link them by repeatedly taking the middle element
+    std::vector<Node*> nodes;
+    try {
+        for (; first != last; ++first) {
+            Node* node = createNode((*first).first, (*first).second);
+            node->left = nil;
+            node->right = nil;
+            nodes.push_back(node);
+        }
+    } catch (...) {
+        for (Node* node : nodes) {
+            destroyNode(node);
+        }
+        throw;
+    }
+    
+    // Middle-split trees have every nil at depth deepest or deepest + 1,
+    // where deepest = floor(log2 n). Colouring the deepest level red and
+    // everything else black gives every root-to-nil path the same number
+    // of black nodes, and no red node has a red child.
+    int deepest = 0;
+    while ((size_t(2) << deepest) <= nodes.size()) {
+        deepest++;
+    }
+    
+    struct Span {
+        size_t lo;
+        size_t hi;
+        Node* parent;
+        bool isLeft;
+        int depth;
+    };
+    
+    std::vector<Span> stack;
+    stack.push_back(Span{0, nodes.size(), nullptr, false, 0});
+    while (!stack.empty()) {
+        Span span = stack.back();
+        stack.pop_back();
+        if (span.lo >= span.hi) {
+            continue;
+        }
+        
+        size_t mid = span.lo + (span.hi - span.lo) / 2;
+        Node* node = nodes[mid];
+        node->parent = span.parent;
+        node->color = (span.depth == deepest && deepest > 0) ? RED : BLACK;
+        if (span.parent == nullptr) {
+            root = node;
+        } else if (span.isLeft) {
+            span.parent->left = node;
+        } else {
+            span.parent->right = node;
+        }
+        
+        stack.push_back(Span{span.lo, mid, node, true, span.depth + 1});
+        stack.push_back(Span{mid + 1, span.hi, node, false, span.depth + 1});
     }
+    size_ = nodes.size();
 }
 
-template<typename K, typename V>
-std::vector<V> RedBlackTree<K, V>::getAllValues() const {
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+std::vector<V> RedBlackTree<K, V, Allocator, Compare>::getAllValues() const {
     std::vector<V> result;
-    inorderTraversal(root, result);
+    result.reserve(size_);
+    for (Node* node = minimum(root); node != nil; node = successor(node)) {
+        result.push_back(node->value);
+    }
     return result;
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::getAllPairsRecursive(Node* node, std::vector<std::pair<K, V>>& result) const {
-    if (node != nil) {
-        getAllPairsRecursive(node->left, result);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+std::vector<std::pair<K, V>> RedBlackTree<K, V, Allocator, Compare>::getAllPairs() const {
+    std::vector<std::pair<K, V>> result;
+    result.reserve(size_);
+    for (Node* node = minimum(root); node != nil; node = successor(node)) {
         result.push_back(std::make_pair(node->key, node->value));
-        getAllPairsRecursive(node->right, result);
     }
+    return result;
 }
 
-template<typename K, typename V>
-std::vector<std::pair<K, V>> RedBlackTree<K, V>::getAllPairs() const {
-    std::vector<std::pair<K, V>> result;
-    getAllPairsRecursive(root, result);
-    return result;
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Pred>
+std::vector<V> RedBlackTree<K, V, Allocator, Compare>::parallelFilter(Pred pred, WorkStealingPool& pool) const {
+    auto keep = [&pred](const Node* node, std::vector<V>& out) {
+        if (pred(node->key, node->value)) {
+            out.push_back(node->value);
+        }
+    };
+    return parallelInOrder<V>(static_cast<const Node*>(root), static_cast<const Node*>(nil), pool, keep);
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::clearRecursive(Node* node) {
-    if (node != nil) {
-        clearRecursive(node->left);
-        clearRecursive(node->right);
-        delete node;
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+template<typename Key>
+typename RedBlackTree<K, V, Allocator, Compare>::Node* RedBlackTree<K, V, Allocator, Compare>::createNode(Key&& key, const V& value) {
+    Node* node = pool.allocate();
+    try {
+        return new (node) Node(std::forward<Key>(key), value);
+    } catch (...) {
+        pool.deallocate(node);
+        throw;
     }
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::clear() {
-    clearRecursive(root);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::destroyNode(Node* node) {
+    node->~Node();
+    pool.deallocate(node);
+}
+
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::clear() {
+    // Trivially destructible nodes in a pool are not visited at all: the
+    // slabs are dropped wholesale, O(slabs).
+    if (!Allocator<Node>::releasesAll || !std::is_trivially_destructible<Node>::value) {
+        // Rotate left children up until the current node has none, then
+        // destroy it and continue right: O(n) time, O(1) extra space
+        Node* node = root;
+        while (node != nil) {
+            if (node->left != nil) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                if (Allocator<Node>::releasesAll) {
+                    node->~Node();  // storage goes with the slabs below
+                } else {
+                    destroyNode(node);
+                }
+                node = right;
+            }
+        }
+    }
+    pool.release();
     root = nil;
+    nil->parent = nullptr;
     size_ = 0;
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::printRecursive(Node* node, int depth) const {
-    if (node != nil) {
-        printRecursive(node->right, depth + 1);
+template<typename K, typename V, template<typename> class Allocator, typename Compare>
+void RedBlackTree<K, V, Allocator, Compare>::print() const {
+    std::cout << "Red-Black Tree (size: " << size_ << "):" << std::endl;
+    
+    // Reverse in-order (right, node, left) with an explicit stack
+    std::vector<std::pair<Node*, int>> stack;
+    Node* node = root;
+    int depth = 0;
+    while (node != nil || !stack.empty()) {
+        while (node != nil) {
+            stack.push_back(std::make_pair(node, depth));
+            node = node->right;
+            depth++;
+        }
+        
+        node = stack.back().first;
+        depth = stack.back().second;
+        stack.pop_back();
+        
         for (int i = 0; i < depth; i++) {
             std::cout << "  ";
         }
         std::cout << node->key << " -> " << node->value 
                   << " (" << (node->color == RED ? "RED" : "BLACK") << ")" << std::endl;
-        printRecursive(node->left, depth + 1);
+        
+        node = node->left;
+        depth++;
     }
 }
 
-template<typename K, typename V>
-void RedBlackTree<K, V>::print() const {
-    std::cout << "Red-Black Tree (size: " << size_ << "):" << std::endl;
-    printRecursive(root, 0);
-}
-
 #endif // RED_BLACK_TREE_H
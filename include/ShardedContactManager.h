@@ -0,0 +1,86 @@
+#ifndef SHARDED_CONTACT_MANAGER_H
+#define SHARDED_CONTACT_MANAGER_H
+
+#include "ContactManager.h"
+#include "UniqueKeyTable.h"
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// 🧩 Danh bạ chia shard cho nhiều luồng ghi cùng lúc.
+// Liên hệ được chia theo ID (ID % số shard) vào N bộ index độc lập; mỗi shard là một
+// ConcurrentContactManager riêng với khóa đọc-ghi, ContactStore và node pool của riêng nó,
+// nên các thao tác ghi vào các shard khác nhau không chờ nhau. Bảng ID của shard có bước N
+// (IdSlotTable::setStride), nên N shard cộng lại tốn bộ nhớ ID như một manager.
+// Tên, số điện thoại và email phải duy nhất trên toàn danh bạ: mỗi loại có một UniqueKeyTable
+// (chia stripe) giữ chủ của từng khóa; khóa mới được giành trước khi ghi vào shard, khóa cũ
+// được trả sau khi shard ghi xong. Tìm kiếm chạy trên mọi shard (song song trên
+// WorkStealingPool::shared()) rồi gộp kết quả.
+// Khóa được giành trước khi liên hệ vào shard: trong khoảnh khắc đó một addContact trùng tên đã
+// báo lỗi nhưng findContact(name) có thể chưa thấy liên hệ thắng.
+// ⚠️ Như ConcurrentContactManager: khi có luồng ghi, đọc trường bằng copyContact; Contact* còn
+// hợp lệ tới khi liên hệ bị xóa. clearAll không chạy song song với thao tác ghi khác.
+// Chưa có snapshot/WAL (openStorage), nhập hàng loạt và tìm tiền tố ở chế độ này.
+class ShardedContactManager {
+public:
+    explicit ShardedContactManager(size_t shardCount);
+    ~ShardedContactManager();
+    
+    ShardedContactManager(const ShardedContactManager&) = delete;
+    ShardedContactManager& operator=(const ShardedContactManager&) = delete;
+    
+    size_t getShardCount() const { return shards.size(); }
+    
+    // Core operations
+    bool addContact(const string& name);
+    bool removeContact(int id);
+    bool removeContact(const string& name);
+    Contact* findContact(int id);
+    Contact* findContact(const string& name);
+    bool copyContact(int id, ContactRecord& out) const;
+    
+    // ❗ Lý do của thao tác gần nhất trả về false trên luồng đang gọi (như ContactManager)
+    static const string& getLastError();
+    
+    // 🔑 Cập nhật thông tin: giành khóa mới trong UniqueKeyTable, ghi vào shard, trả khóa cũ
+    bool renameContact(Contact* contact, const string& newName);
+    bool setContactPhone(Contact* contact, const string& phone);  // "" = xóa số điện thoại
+    bool setContactEmail(Contact* contact, const string& email);  // "" = xóa email
+    bool setContactAddress(Contact* contact, const string& address);
+    bool setContactNotes(Contact* contact, const string& notes);
+    
+    // Search operations: hỏi mọi shard, gộp kết quả
+    set<Contact*> searchByName(const string& name);
+    set<Contact*> searchByPhone(const string& phone);
+    set<Contact*> searchByEmail(const string& email);
+    
+    // 🔑 Kiểm tra trùng trên toàn danh bạ (một stripe, không khóa shard nào)
+    bool isPhoneNumberDuplicate(string_view phone, Contact* excludeContact = nullptr) const;
+    bool isEmailDuplicate(string_view email, Contact* excludeContact = nullptr) const;
+    
+    // Statistics
+    int getTotalContacts() const;
+    bool isEmpty() const;
+    
+    // Cleanup
+    void clearAll();
+
+private:
+    typedef ConcurrentContactManager Shard;
+    
+    vector<unique_ptr<Shard>> shards;
+    UniqueKeyTable names;
+    UniqueKeyTable phones;
+    UniqueKeyTable emails;
+    
+    Shard& shardOf(int id) const;
+    
+    template<typename Search>
+    set<Contact*> gather(Search search) const;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef TEXT_SEARCH_H
+#define TEXT_SEARCH_H
+
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// 🔍 Folded search keys for case- and accent-insensitive search.
+//
+// Names and e-mails carry a precomputed key (foldKey) written with the
+// value; searches fold the query the same way and run a plain find over the
+// keys, so no value is lowercased or normalized while searching.
+class TextSearch {
+public:
+    // Search key of a name or e-mail, computed once per write: ASCII letters
+    // lowercased, Vietnamese letters (precomposed, or base letter followed by
+    // combining marks) folded to their base letter, đ/Đ to d; any other byte
+    // is kept. "Nguyễn Văn Đức" -> "nguyen van duc". Queries are folded the
+    // same way, so a key is searched with a plain byte comparison.
+    static string foldKey(string_view text);
+    static void appendFoldedKey(string& out, string_view text);
+};
+
+#endif
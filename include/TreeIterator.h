@@ -0,0 +1,119 @@
+#ifndef TREE_ITERATOR_H
+#define TREE_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Bidirectional in-order iterator shared by BinarySearchTree and RedBlackTree.
+// The tree provides successor(node) / predecessor(node), where the end
+// position is the tree's own end marker (nullptr for the BST, the nil
+// sentinel for the RBT) and predecessor(end) is the largest node.
+//
+// Dereferencing yields a lightweight {first, second} pair of references to
+// the node's key and value, so walking the tree never copies keys.
+template<typename Tree, typename Node, bool IsConst>
+class TreeIterator {
+private:
+    template<typename, typename, bool> friend class TreeIterator;
+    friend Tree;
+    
+    const Tree* tree;
+    Node* node;
+    
+    TreeIterator(const Tree* t, Node* n) : tree(t), node(n) {}
+    
+public:
+    using key_type = typename std::remove_reference<decltype(std::declval<Node&>().key)>::type;
+    using mapped_type = typename std::remove_reference<decltype(std::declval<Node&>().value)>::type;
+    using mapped_reference = typename std::conditional<IsConst, const mapped_type&, mapped_type&>::type;
+    
+    struct reference {
+        const key_type& first;
+        mapped_reference second;
+    };
+    
+    struct pointer {
+        reference ref;
+        const reference* operator->() const { return &ref; }
+    };
+    
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::pair<const key_type, mapped_type>;
+    using difference_type = std::ptrdiff_t;
+    
+    TreeIterator() : tree(nullptr), node(nullptr) {}
+    
+    // iterator -> const_iterator
+    template<bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+    TreeIterator(const TreeIterator<Tree, Node, WasConst>& other) : tree(other.tree), node(other.node) {}
+    
+    reference operator*() const { return reference{node->key, node->value}; }
+    pointer operator->() const { return pointer{**this}; }
+    
+    const key_type& key() const { return node->key; }
+    mapped_reference value() const { return node->value; }
+    
+    TreeIterator& operator++() {
+        node = tree->successor(node);
+        return *this;
+    }
+    
+    TreeIterator operator++(int) {
+        TreeIterator old = *this;
+        ++*this;
+        return old;
+    }
+    
+    TreeIterator& operator--() {
+        node = tree->predecessor(node);
+        return *this;
+    }
+    
+    TreeIterator operator--(int) {
+        TreeIterator old = *this;
+        --*this;
+        return old;
+    }
+    
+    template<bool OtherConst>
+    bool operator==(const TreeIterator<Tree, Node, OtherConst>& other) const { return node == other.node; }
+    
+    template<bool OtherConst>
+    bool operator!=(const TreeIterator<Tree, Node, OtherConst>& other) const { return node != other.node; }
+};
+
+// [first, last) pair of iterators usable in a range-based for loop.
+template<typename Iterator>
+class TreeRange {
+private:
+    Iterator first;
+    Iterator last;
+    
+public:
+    TreeRange(Iterator f, Iterator l) : first(f), last(l) {}
+    
+    Iterator begin() const { return first; }
+    Iterator end() const { return last; }
+    bool empty() const { return first == last; }
+};
+
+// Smallest string greater than every string that starts with prefix:
+// trailing 0xFF bytes are dropped and the last remaining byte is bumped.
+// Returns false when no such bound exists (prefix is empty or all 0xFF),
+// in which case a prefix scan runs to the end of the tree.
+template<typename S>
+bool prefixUpperBound(const S& prefix, S& upper) {
+    upper = prefix;
+    while (!upper.empty() && static_cast<unsigned char>(upper.back()) == 0xFF) {
+        upper.pop_back();
+    }
+    if (upper.empty()) {
+        return false;
+    }
+    upper.back() = static_cast<typename S::value_type>(static_cast<unsigned char>(upper.back()) + 1);
+    return true;
+}
+
+#endif // TREE_ITERATOR_H
@@ -0,0 +1,41 @@
+#ifndef UNIQUE_KEY_TABLE_H
+#define UNIQUE_KEY_TABLE_H
+
+#include "HashIndex.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// 🔑 Khóa duy nhất trên toàn danh bạ chia shard: khóa (tên, số điện thoại, email) -> ID liên hệ giữ nó.
+// Bảng chia thành nhiều stripe theo hash của khóa, mỗi stripe một mutex và một HashIndex riêng:
+// hai luồng chỉ chờ nhau khi hai khóa rơi vào cùng một stripe, không có khóa chung cho cả bảng.
+// Liên hệ "giành" khóa trước khi ghi vào shard của mình và trả lại khi bỏ giá trị đó.
+class UniqueKeyTable {
+public:
+    explicit UniqueKeyTable(size_t stripeCount);  // Làm tròn lên lũy thừa của 2
+    ~UniqueKeyTable();
+    
+    UniqueKeyTable(const UniqueKeyTable&) = delete;
+    UniqueKeyTable& operator=(const UniqueKeyTable&) = delete;
+    
+    bool claim(string_view key, int owner);    // false nếu khóa đang thuộc liên hệ khác
+    void release(string_view key, int owner);  // Chỉ bỏ khi khóa vẫn thuộc owner
+    int ownerOf(string_view key) const;        // 0 nếu chưa ai giữ (ID bắt đầu từ 1)
+    
+    size_t size() const;
+    void clear();
+
+private:
+    struct Stripe;
+    
+    vector<unique_ptr<Stripe>> stripes;
+    StringHash hasher;
+    
+    Stripe& stripeOf(string_view key) const;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker runs
+// its own newest task first (the one whose data is still in cache) and,
+// when its deque is empty, steals the oldest task of another deque: the
+// oldest tasks are the largest pieces of a recursively split job, so one
+// steal moves a lot of work. Idle workers sleep on a condition variable.
+//
+// Tasks submitted directly must not throw; TaskGroup carries the first
+// exception of its tasks to wait(). A thread waiting on a TaskGroup runs
+// queued tasks meanwhile, so the caller counts as one more worker and a
+// pool with zero workers still completes every job (on the caller).
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+    
+    explicit WorkStealingPool(size_t workers);
+    ~WorkStealingPool();  // Runs what is still queued, then joins
+    
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    
+    // One worker per core but one: the thread that waits is the last
+    static WorkStealingPool& shared();
+    
+    size_t workerCount() const { return threads.size(); }
+    
+    // From a worker of this pool: onto its own deque; otherwise spread
+    // round-robin over the deques
+    void submit(Task task);
+    
+    // Runs one queued task on the calling thread; false if none was queued
+    bool runOne();
+    
+    // True while a worker sleeps with nothing queued: the moment for a
+    // running task to split off part of its work. A hint only, no lock.
+    bool wantsWork() const {
+        return idle.load(std::memory_order_relaxed) > 0 && queued.load(std::memory_order_relaxed) == 0;
+    }
+    
+    // Tasks that are waited for together
+    class TaskGroup {
+    public:
+        explicit TaskGroup(WorkStealingPool& pool) : pool(pool), pending(0) {}
+        ~TaskGroup() { drain(); }
+    
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+    
+        void run(Task task);
+    
+        // Helps until every task has finished; rethrows the first exception
+        void wait();
+    
+    private:
+        WorkStealingPool& pool;
+        std::atomic<size_t> pending;
+        std::mutex errorLock;
+        std::exception_ptr error;
+    
+        void drain();
+    };
+
+private:
+    struct Queue;
+    
+    std::vector<std::unique_ptr<Queue>> queues;  // one per worker, plus one with no worker of its own
+    std::vector<std::thread> threads;
+    std::atomic<size_t> queued{0};  // tasks in all deques
+    std::atomic<size_t> idle{0};    // workers asleep
+    std::atomic<size_t> nextQueue{0};
+    std::mutex sleepLock;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+    
+    void workerLoop(size_t index);
+    bool take(size_t home, Task& task);  // own deque from the back, then others from the front
+    int workerIndex() const;             // of the calling thread, -1 if it is not one of ours
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// 📝 Tuning for the write-ahead log
+struct WalOptions {
+    int syncIntervalMs = 10;              // group commit window; 0 = fsync on every append
+    size_t maxPendingBytes = 1 << 20;     // flush early once this much is buffered
+    uint64_t checkpointBytes = 64 << 20;  // ContactManager checkpoints past this log size; 0 = never
+};
+
+// 📝 Append-only log of contact mutations.
+//
+// File layout: magic "SCWAL001", then records
+//   uint32 bodyLength | uint32 crc32(body) | body
+//   body = uint64 sequence | uint8 op | int32 id | value bytes
+//
+// append() only copies the record into an in-memory batch. A background
+// flusher writes the batch and fdatasyncs it once per syncIntervalMs (or
+// sooner when maxPendingBytes is reached), so many mutations share one
+// fsync (group commit). A crash loses at most the last interval; a torn
+// final record is detected by its length/CRC and dropped on the next open.
+class WriteAheadLog {
+public:
+    enum Op : uint8_t {
+        OP_ADD = 1,    // id, name
+        OP_REMOVE,     // id
+        OP_RENAME,     // id, new name
+        OP_SET_PHONE,  // id, phone ("" = removed)
+        OP_SET_EMAIL,  // id, email ("" = removed)
+        OP_SET_ADDRESS,
+        OP_SET_NOTES
+    };
+    
+    struct Record {
+        uint64_t sequence;
+        Op op;
+        int id;
+        string value;
+    };
+    
+    struct Stats {
+        uint64_t appends;
+        uint64_t syncs;
+        uint64_t bytes;  // current file size including pending bytes
+    };
+    
+    // Reads the intact records of path in order; stops at the first torn or
+    // corrupt record. Returns the byte length of the intact prefix (0 when
+    // the file does not exist). Throws StorageError if path is not a log.
+    static uint64_t read(const string& path, vector<Record>& records);
+    
+    // Opens path for appending, first truncating it to validBytes (as
+    // returned by read) so a torn tail is overwritten. Sequences continue
+    // from nextSequence.
+    WriteAheadLog(const string& path, uint64_t validBytes, uint64_t nextSequence, const WalOptions& options);
+    ~WriteAheadLog();  // Flushes everything still pending
+    
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+    
+    // Queues one record and returns its sequence number
+    uint64_t append(Op op, int id, const string& value = "");
+    
+    // Blocks until every record appended so far is on disk
+    void sync();
+    
+    // Drops the whole log after a checkpoint captured everything up to
+    // lastSequence(); sequence numbers keep increasing
+    void reset();
+    
+    uint64_t lastSequence() const;
+    Stats stats() const;
+
+private:
+    string path;
+    FILE* file;
+    WalOptions options;
+    
+    mutable mutex lock_;
+    condition_variable wakeFlusher;
+    condition_variable flushed;
+    thread flusher;
+    
+    string pending;             // encoded records not yet written
+    uint64_t nextSequence;
+    uint64_t appendedSequence;  // last sequence handed out
+    uint64_t durableSequence;   // last sequence known to be on disk
+    uint64_t fileBytes;         // bytes written to the file
+    uint64_t appends;
+    uint64_t syncs;
+    bool flushing;
+    bool syncRequested;
+    bool stopping;
+    string error;               // first I/O error; the log refuses writes after it
+    
+    void flusherLoop();
+    void flushLocked(unique_lock<mutex>& lock);
+    void throwIfFailed() const;
+};
+
+#endif
@@ -0,0 +1,234 @@
+#include "BatchCommandRunner.h"
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+string_view trim(string_view text) {
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Tách từ đầu tiên; text còn lại phần sau nó (đã bỏ khoảng trắng)
+string_view takeWord(string_view& text) {
+    size_t end = 0;
+    while (end < text.size() && !isSpace(text[end])) {
+        end++;
+    }
+    string_view word = text.substr(0, end);
+    text = trim(text.substr(end));
+    return word;
+}
+
+// Tách từ cuối cùng (số điện thoại, email không chứa khoảng trắng); text còn lại phần trước nó
+string_view takeLastWord(string_view& text) {
+    size_t start = text.size();
+    while (start > 0 && !isSpace(text[start - 1])) {
+        start--;
+    }
+    string_view word = text.substr(start);
+    text = trim(text.substr(0, start));
+    return word;
+}
+
+bool isAllDigits(string_view text) {
+    return !text.empty() && all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+} // namespace
+
+// 📝 Không ghi ra đâu: endl của manager chỉ còn là một lần gọi hàm, không flush stdout
+int BatchCommandRunner::DiscardBuffer::overflow(int c) {
+    return traits_type::not_eof(c);
+}
+
+streamsize BatchCommandRunner::DiscardBuffer::xsputn(const char*, streamsize n) {
+    return n;
+}
+
+BatchCommandRunner::BatchCommandRunner(ContactManager* manager) : manager(manager) {}
+
+BatchCommandRunner::Summary BatchCommandRunner::run(istream& in, ostream& out) {
+    // Kết quả ghi thẳng vào bộ đệm của out; cout (thông báo của manager) trỏ vào messages.
+    // Nếu out chính là cout, kết quả vẫn đi ra stdout vì results giữ bộ đệm gốc.
+    ostream results(out.rdbuf());
+    streambuf* saved = cout.rdbuf(&messages);
+    
+    Summary summary = {0, 0};
+    try {
+        string line;
+        size_t lineNumber = 0;
+        while (getline(in, line)) {
+            lineNumber++;
+            string_view command = trim(line);
+            if (command.empty() || command.front() == '#') {
+                continue;
+            }
+    
+            summary.commands++;
+            if (!execute(command, results)) {
+                summary.failures++;
+                results << "error " << lineNumber << ": " << error << '\n';
+            }
+        }
+    } catch (...) {
+        cout.rdbuf(saved);
+        throw;
+    }
+    
+    cout.rdbuf(saved);
+    results.flush();
+    return summary;
+}
+
+bool BatchCommandRunner::execute(string_view line, ostream& out) {
+    string_view command = takeWord(line);
+    
+    if (command == "add") {
+        return addContact(line, out);
+    } else if (command == "set-phone" || command == "set-email") {
+        return setField(command, line, out);
+    } else if (command == "remove") {
+        return removeContact(line, out);
+    } else if (command == "get") {
+        return getContact(line, out);
+    } else if (command == "search") {
+        return search(line, out);
+    }
+    return fail("lệnh không hợp lệ: " + string(command));
+}
+
+bool BatchCommandRunner::addContact(string_view args, ostream& out) {
+    if (args.empty()) {
+        return fail("thiếu tên liên hệ");
+    }
+    
+    string name(args);
+    if (!manager->addContact(name)) {
+        return failFromManager();
+    }
+    out << "ok " << manager->findContact(name)->getId() << '\n';
+    return true;
+}
+
+bool BatchCommandRunner::setField(string_view command, string_view args, ostream& out) {
+    bool phone = command == "set-phone";
+    string_view value = takeLastWord(args);
+    if (args.empty()) {
+        return fail(phone ? "cú pháp: set-phone <id|tên> <số|->" : "cú pháp: set-email <id|tên> <email|->");
+    }
+    
+    Contact* contact = resolve(args);
+    if (contact == nullptr) {
+        return false;
+    }
+    
+    string newValue = value == "-" ? string() : string(value);
+    bool updated = phone ? manager->setContactPhone(contact, newValue) : manager->setContactEmail(contact, newValue);
+    if (!updated) {
+        return failFromManager();
+    }
+    out << "ok " << contact->getId() << '\n';
+    return true;
+}
+
+bool BatchCommandRunner::removeContact(string_view args, ostream& out) {
+    Contact* contact = resolve(args);
+    if (contact == nullptr) {
+        return false;
+    }
+    
+    int id = contact->getId();
+    if (!manager->removeContact(id)) {
+        return failFromManager();
+    }
+    out << "ok " << id << '\n';
+    return true;
+}
+
+bool BatchCommandRunner::getContact(string_view args, ostream& out) {
+    Contact* contact = resolve(args);
+    if (contact == nullptr) {
+        return false;
+    }
+    
+    out << "ok " << contact->getId() << '\t' << contact->getName() << '\t' << contact->getPhoneNumber() << '\t'
+        << contact->getEmail() << '\t' << contact->getAddress() << '\t' << contact->getNotes() << '\n';
+    return true;
+}
+
+bool BatchCommandRunner::search(string_view args, ostream& out) {
+    string_view field = takeWord(args);
+    if (args.empty()) {
+        return fail("cú pháp: search name|phone|email <chuỗi>");
+    }
+    
+    string query(args);
+    set<Contact*> found;
+    if (field == "name") {
+        found = manager->searchByName(query);
+    } else if (field == "phone") {
+        found = manager->searchByPhone(query);
+    } else if (field == "email") {
+        found = manager->searchByEmail(query);
+    } else {
+        return fail("trường tìm kiếm không hợp lệ: " + string(field));
+    }
+    
+    // set<Contact*> xếp theo địa chỉ; in theo ID để kết quả ổn định giữa các lần chạy
+    vector<Contact*> results(found.begin(), found.end());
+    sort(results.begin(), results.end(), [](Contact* a, Contact* b) { return a->getId() < b->getId(); });
+    
+    out << "ok " << results.size() << '\n';
+    for (Contact* contact : results) {
+        out << contact->getId() << '\t' << contact->getName() << '\t' << contact->getPhoneNumber() << '\t'
+            << contact->getEmail() << '\n';
+    }
+    return true;
+}
+
+// 🔎 Toàn chữ số: tra theo ID; còn lại: tra theo tên
+Contact* BatchCommandRunner::resolve(string_view ref) {
+    if (ref.empty()) {
+        fail("thiếu ID hoặc tên liên hệ");
+        return nullptr;
+    }
+    
+    Contact* contact = nullptr;
+    if (isAllDigits(ref)) {
+        int id = 0;
+        if (from_chars(ref.data(), ref.data() + ref.size(), id).ec == errc()) {
+            contact = manager->findContact(id);
+        }
+    } else {
+        contact = manager->findContact(string(ref));
+    }
+    
+    if (contact == nullptr) {
+        fail("không tìm thấy liên hệ: " + string(ref));
+    }
+    return contact;
+}
+
+bool BatchCommandRunner::fail(string reason) {
+    error = move(reason);
+    return false;
+}
+
+bool BatchCommandRunner::failFromManager() {
+    const string& reason = ContactManager::getLastError();
+    return fail(reason.empty() ? "thao tác không thành công" : reason);
+}
@@ -1,80 +1,147 @@
 #include "Contact.h"
+#include "TextSearch.h"
 #include <iostream>
 #include <sstream>
 
 using namespace std;
 
-int Contact::nextId = 1;
+atomic<int> Contact::nextId(1);
 
-Contact::Contact() : id(nextId++) {
-    name = "";
-    phoneNumber = "";
-    email = "";
-    address = "";
-    notes = "";
+// Trường của liên hệ nằm trong store ghi ở handle
+static ContactStore* store(ContactStore::Handle handle) {
+    return ContactStore::of(handle);
 }
 
-Contact::Contact(const string& name) : id(nextId++) {
-    this->name = name;
-    phoneNumber = "";
-    email = "";
-    address = "";
-    notes = "";
+Contact::Contact(string_view name, ContactStore* store) : id(nextId++), handle(store->allocate(this)) {
+    setName(name);
+}
+
+Contact::Contact(int id, string_view name, ContactStore* store) : id(id), handle(store->allocate(this)) {
+    setName(name);
+    reserveIdsUpTo(id);
+}
+
+Contact::~Contact() {
+    store(handle)->release(handle);
+}
+
+// 🗄️ Bản ghi Contact cắt từ slab của chính store: các shard tạo/xóa liên hệ song song,
+// mỗi shard dưới khóa riêng, không qua khóa hay bộ cấp phát chung nào
+Contact* Contact::create(string_view name, ContactStore* store) {
+    void* record = store->allocateRecord();
+    try {
+        return ::new (record) Contact(name, store);
+    } catch (...) {
+        store->releaseRecord(record);
+        throw;
+    }
+}
+
+Contact* Contact::create(int id, string_view name, ContactStore* store) {
+    void* record = store->allocateRecord();
+    try {
+        return ::new (record) Contact(id, name, store);
+    } catch (...) {
+        store->releaseRecord(record);
+        throw;
+    }
+}
+
+// Store lấy từ handle trước khi hủy: sau ~Contact handle không còn đọc được
+void Contact::destroy(Contact* contact) {
+    if (contact == nullptr) {
+        return;
+    }
+    ContactStore* owner = store(contact->handle);
+    contact->~Contact();
+    owner->releaseRecord(contact);
+}
+
+int Contact::getNextId() {
+    return nextId;
+}
+
+int Contact::allocateId() {
+    return nextId++;
+}
+
+void Contact::reserveIdsUpTo(int id) {
+    int next = nextId.load();
+    while (id >= next && !nextId.compare_exchange_weak(next, id + 1)) {
+        // next đã được nạp lại: thử lại nếu vẫn còn nhỏ hơn
+    }
 }
 
 int Contact::getId() const {
     return id;
 }
 
-string Contact::getName() const {
-    return name;
+string_view Contact::getName() const {
+    return store(handle)->get(handle, ContactStore::FIELD_NAME);
+}
+
+string_view Contact::getPhoneNumber() const {
+    return store(handle)->get(handle, ContactStore::FIELD_PHONE);
 }
 
-string Contact::getPhoneNumber() const {
-    return phoneNumber;
+string_view Contact::getEmail() const {
+    return store(handle)->get(handle, ContactStore::FIELD_EMAIL);
 }
 
-string Contact::getEmail() const {
-    return email;
+string_view Contact::getNameKey() const {
+    return store(handle)->get(handle, ContactStore::FIELD_NAME_KEY);
 }
 
-string Contact::getAddress() const {
-    return address;
+string_view Contact::getEmailKey() const {
+    return store(handle)->get(handle, ContactStore::FIELD_EMAIL_KEY);
 }
 
-string Contact::getNotes() const {
-    return notes;
+string_view Contact::getAddress() const {
+    return store(handle)->get(handle, ContactStore::FIELD_ADDRESS);
 }
 
-void Contact::setName(const string& name) {
-    this->name = name;
+string_view Contact::getNotes() const {
+    return store(handle)->get(handle, ContactStore::FIELD_NOTES);
 }
 
-void Contact::setAddress(const string& address) {
-    this->address = address;
+// 🔎 Khóa tìm kiếm được tính lại cùng lúc với giá trị (một lần mỗi lần ghi)
+void Contact::setName(string_view name) {
+    store(handle)->set(handle, ContactStore::FIELD_NAME_KEY, TextSearch::foldKey(name));
+    store(handle)->set(handle, ContactStore::FIELD_NAME, name);
 }
 
-void Contact::setNotes(const string& notes) {
-    this->notes = notes;
+void Contact::setAddress(string_view address) {
+    store(handle)->set(handle, ContactStore::FIELD_ADDRESS, address);
 }
 
-void Contact::setPhoneNumber(const string& phone) {
-    phoneNumber = phone;  // 🔑 Thay thế số điện thoại cũ
+void Contact::setNotes(string_view notes) {
+    store(handle)->set(handle, ContactStore::FIELD_NOTES, notes);
 }
 
-void Contact::setEmail(const string& email) {
-    this->email = email;  // 🔑 Thay thế email cũ
+void Contact::setPhoneNumber(string_view phone) {
+    store(handle)->set(handle, ContactStore::FIELD_PHONE, phone);  // 🔑 Thay thế số điện thoại cũ
+}
+
+void Contact::setEmail(string_view email) {
+    store(handle)->set(handle, ContactStore::FIELD_EMAIL_KEY, TextSearch::foldKey(email));
+    store(handle)->set(handle, ContactStore::FIELD_EMAIL, email);  // 🔑 Thay thế email cũ
 }
 
 bool Contact::hasPhoneNumber() const {
-    return !phoneNumber.empty();  // 🔑 Kiểm tra có số điện thoại không
+    return !getPhoneNumber().empty();  // 🔑 Kiểm tra có số điện thoại không
 }
 
 bool Contact::hasEmail() const {
-    return !email.empty();  // 🔑 Kiểm tra có email không
+    return !getEmail().empty();  // 🔑 Kiểm tra có email không
 }
 
 void Contact::display() const {
+    string_view name = getName();
+    string_view phoneNumber = getPhoneNumber();
+    string_view email = getEmail();
+    string_view address = getAddress();
+    string_view notes = getNotes();
+    
     cout << "\n=== Liên hệ ID: " << id << " ===" << endl;
     cout << "Tên: " << name << endl;
     
@@ -98,6 +165,6 @@ void Contact::display() const {
 
 string Contact::toString() const {
     stringstream ss;
-    ss << "ID: " << id << ", Tên: " << name;
+    ss << "ID: " << id << ", Tên: " << getName();
     return ss.str();
 }
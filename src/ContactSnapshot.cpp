@@ -0,0 +1,276 @@
+#include "ContactSnapshot.h"
+#include "ContactException.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char SNAPSHOT_MAGIC[8] = {'S', 'C', 'S', 'N', 'A', 'P', '0', '1'};
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+// After rename() the new directory entry is only durable once the directory
+// itself is synced; until then a crash can bring back the old snapshot
+static void syncParentDirectory(const string& path) {
+#ifndef _WIN32
+    size_t slash = path.rfind('/');
+    string directory = slash == string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        throw StorageError("không mở được thư mục " + directory);
+    }
+    int result = fsync(fd);
+    close(fd);
+    if (result != 0) {
+        throw StorageError("không đồng bộ được thư mục " + directory);
+    }
+#else
+    (void)path;
+#endif
+}
+
+// Buffered writer that tracks the current file offset
+class SnapshotWriter {
+private:
+    FILE* file;
+    uint64_t position;
+    
+public:
+    SnapshotWriter(FILE* f) : file(f), position(0) {}
+    
+    void write(const void* bytes, size_t count) {
+        if (count != 0 && fwrite(bytes, 1, count, file) != count) {
+            throw StorageError("không ghi được snapshot");
+        }
+        position += count;
+    }
+    
+    void padTo(uint64_t offset) {
+        static const char zeros[8] = {0};
+        while (position < offset) {
+            write(zeros, min<uint64_t>(sizeof(zeros), offset - position));
+        }
+    }
+    
+    uint64_t tell() const { return position; }
+};
+
+void ContactSnapshot::write(const string& path, const vector<Contact*>& contacts,
+                            const vector<uint32_t> runs[RUN_COUNT], int nextId, uint64_t walSequence) {
+    // Lay out sections
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.nextId = nextId;
+    header.walSequence = walSequence;
+    header.recordCount = contacts.size();
+    header.recordsOffset = alignUp(sizeof(Header));
+    header.runsOffset = alignUp(header.recordsOffset + contacts.size() * sizeof(Record));
+    
+    uint64_t runBytes = 0;
+    for (int r = 0; r < RUN_COUNT; r++) {
+        header.runLengths[r] = runs[r].size();
+        runBytes += runs[r].size() * sizeof(uint32_t);
+    }
+    header.stringsOffset = alignUp(header.runsOffset + runBytes);
+    
+    // Records point into the string area in write order
+    vector<Record> records(contacts.size());
+    uint64_t stringOffset = 0;
+    for (size_t i = 0; i < contacts.size(); i++) {
+        const Contact* contact = contacts[i];
+        const string_view fields[FIELD_COUNT] = {contact->getName(), contact->getPhoneNumber(), contact->getEmail(),
+                                                 contact->getAddress(), contact->getNotes()};
+        records[i].id = contact->getId();
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            records[i].offset[f] = stringOffset;
+            records[i].length[f] = static_cast<uint32_t>(fields[f].size());
+            stringOffset += fields[f].size();
+        }
+    }
+    header.stringsSize = stringOffset;
+    
+    string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        throw StorageError("không tạo được file " + tempPath);
+    }
+    
+    vector<char> buffer(1 << 20);  // must outlive fclose
+    setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    
+    try {
+        SnapshotWriter out(file);
+        out.write(&header, sizeof(header));
+        out.padTo(header.recordsOffset);
+        out.write(records.data(), records.size() * sizeof(Record));
+        out.padTo(header.runsOffset);
+        for (int r = 0; r < RUN_COUNT; r++) {
+            out.write(runs[r].data(), runs[r].size() * sizeof(uint32_t));
+        }
+        out.padTo(header.stringsOffset);
+        for (const Contact* contact : contacts) {
+            const string_view fields[FIELD_COUNT] = {contact->getName(), contact->getPhoneNumber(), contact->getEmail(),
+                                                     contact->getAddress(), contact->getNotes()};
+            for (string_view value : fields) {
+                out.write(value.data(), value.size());
+            }
+        }
+        
+        if (fflush(file) != 0) {
+            throw StorageError("không ghi được snapshot");
+        }
+#ifndef _WIN32
+        if (fsync(fileno(file)) != 0) {
+            throw StorageError("không đồng bộ được snapshot " + tempPath);
+        }
+#endif
+    } catch (...) {
+        fclose(file);
+        remove(tempPath.c_str());
+        throw;
+    }
+    
+    if (fclose(file) != 0) {
+        remove(tempPath.c_str());
+        throw StorageError("không ghi được snapshot");
+    }
+    if (rename(tempPath.c_str(), path.c_str()) != 0) {
+        remove(tempPath.c_str());
+        throw StorageError("không đổi tên được " + tempPath + " thành " + path);
+    }
+    
+    // The caller may truncate the WAL next (checkpoint): the rename must be durable first
+    syncParentDirectory(path);
+}
+
+ContactSnapshot::ContactSnapshot(const string& path)
+    : data(nullptr), size(0), mapped(false), header(nullptr), records(nullptr), strings(nullptr) {
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw StorageError("không mở được file " + path);
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        close(fd);
+        throw StorageError("file snapshot không hợp lệ: " + path);
+    }
+    
+    size = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        throw StorageError("không ánh xạ được file " + path);
+    }
+    madvise(address, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(address);
+    mapped = true;
+#else
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in) {
+        throw StorageError("không mở được file " + path);
+    }
+    size = static_cast<size_t>(in.tellg());
+    char* buffer = new char[size];
+    in.seekg(0);
+    in.read(buffer, size);
+    data = buffer;
+#endif
+    
+    try {
+        validate(path);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+ContactSnapshot::~ContactSnapshot() {
+    release();
+}
+
+void ContactSnapshot::release() {
+    if (data == nullptr) {
+        return;
+    }
+#ifndef _WIN32
+    if (mapped) {
+        munmap(const_cast<char*>(data), size);
+    }
+#else
+    delete[] data;
+#endif
+    data = nullptr;
+}
+
+// Every offset and length is checked so a truncated or corrupt file is
+// rejected up front instead of being read out of bounds later
+void ContactSnapshot::validate(const string& path) {
+    if (size < sizeof(Header)) {
+        throw StorageError("file snapshot quá ngắn: " + path);
+    }
+    
+    header = reinterpret_cast<const Header*>(data);
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw StorageError("không phải file snapshot: " + path);
+    }
+    if (header->version < MIN_VERSION || header->version > VERSION) {
+        throw StorageError("phiên bản snapshot không hỗ trợ (" + to_string(header->version) + "): " + path);
+    }
+    
+    uint64_t count = header->recordCount;
+    if (header->recordsOffset % 8 != 0 || header->runsOffset % 8 != 0 ||
+        header->recordsOffset > size || count > (size - header->recordsOffset) / sizeof(Record) ||
+        header->runsOffset < header->recordsOffset + count * sizeof(Record) || header->runsOffset > size) {
+        throw StorageError("bảng bản ghi bị hỏng: " + path);
+    }
+    records = reinterpret_cast<const Record*>(data + header->recordsOffset);
+    
+    uint64_t runOffset = header->runsOffset;
+    for (int r = 0; r < RUN_COUNT; r++) {
+        uint64_t length = header->runLengths[r];
+        if (length > count || length * sizeof(uint32_t) > size - runOffset) {
+            throw StorageError("chỉ mục trong snapshot bị hỏng: " + path);
+        }
+        runs[r] = reinterpret_cast<const uint32_t*>(data + runOffset);
+        for (uint64_t i = 0; i < length; i++) {
+            if (runs[r][i] >= count) {
+                throw StorageError("chỉ mục trong snapshot bị hỏng: " + path);
+            }
+        }
+        runOffset += length * sizeof(uint32_t);
+    }
+    
+    if (header->stringsOffset < runOffset || header->stringsOffset > size ||
+        header->stringsSize > size - header->stringsOffset) {
+        throw StorageError("vùng dữ liệu chuỗi bị hỏng: " + path);
+    }
+    strings = data + header->stringsOffset;
+    
+    for (uint64_t i = 0; i < count; i++) {
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            if (records[i].offset[f] > header->stringsSize ||
+                records[i].length[f] > header->stringsSize - records[i].offset[f]) {
+                throw StorageError("bản ghi " + to_string(i) + " bị hỏng: " + path);
+            }
+        }
+    }
+}
+
+string_view ContactSnapshot::field(size_t index, Field field) const {
+    const Record& record = records[index];
+    return string_view(strings + record.offset[field], record.length[field]);
+}
@@ -0,0 +1,175 @@
+#include "ContactStore.h"
+#include "Contact.h"
+#include "ContactException.h"
+#include <cstring>
+#include <mutex>
+
+using namespace std;
+
+// Columns with less garbage than this are never compacted
+static const size_t MIN_COMPACT_BYTES = 64 * 1024;
+
+// Entries address the arena with 32-bit offsets
+static const size_t MAX_COLUMN_BYTES = UINT32_MAX;
+
+ContactStore* ContactStore::stores[ContactStore::MAX_STORES];
+
+// Guards the slots of stores[] that create() and destroy() hand out
+static mutex& registryLock() {
+    static mutex* lock = new mutex();
+    return *lock;
+}
+
+ContactStore::ContactStore(size_t index)
+    : firstHandle(static_cast<Handle>(index) << SLOT_BITS), records(new NodePool<Contact>()) {
+    stores[index] = this;
+}
+
+ContactStore::~ContactStore() {
+    delete records;
+}
+
+// Thread-safe lazy initialization (function-local static); never deleted,
+// so contacts still alive at exit stay valid. Always index 0.
+ContactStore* ContactStore::getInstance() {
+    static ContactStore* instance = new ContactStore(0);
+    return instance;
+}
+
+ContactStore* ContactStore::create() {
+    lock_guard<mutex> guard(registryLock());
+    for (size_t index = 1; index < MAX_STORES; index++) {
+        if (stores[index] == nullptr) {
+            return new ContactStore(index);
+        }
+    }
+    throw StorageError("quá nhiều ContactStore");
+}
+
+void ContactStore::destroy(ContactStore* store) {
+    if (store == nullptr || store == getInstance()) {
+        return;
+    }
+    lock_guard<mutex> guard(registryLock());
+    stores[store->firstHandle >> SLOT_BITS] = nullptr;
+    delete store;
+}
+
+ContactStore::Handle ContactStore::allocate(Contact* owner) {
+    if (!freeHandles.empty()) {
+        Handle handle = freeHandles.back();
+        freeHandles.pop_back();
+        owners[slotOf(handle)] = owner;
+        return handle;
+    }
+    
+    if (owners.size() > SLOT_MASK) {
+        throw StorageError("quá nhiều liên hệ trong bộ nhớ");
+    }
+    Handle handle = firstHandle | static_cast<Handle>(owners.size());
+    owners.push_back(owner);
+    for (Column& column : columns) {
+        column.entries.push_back(Entry{0, 0});
+    }
+    return handle;
+}
+
+void ContactStore::release(Handle handle) {
+    size_t slot = slotOf(handle);
+    for (Column& column : columns) {
+        Entry& entry = column.entries[slot];
+        column.garbage += entry.length;
+        entry = Entry{0, 0};
+    }
+    owners[slot] = nullptr;
+    freeHandles.push_back(handle);
+}
+
+void* ContactStore::allocateRecord() {
+    return records->allocate();
+}
+
+void ContactStore::releaseRecord(void* record) {
+    records->deallocate(static_cast<Contact*>(record));
+}
+
+void ContactStore::set(Handle handle, Field field, string_view value) {
+    Column& column = columns[field];
+    
+    // The value may live in this very arena (copied from another contact);
+    // growing or compacting would move it
+    string copy;
+    if (!column.bytes.empty() && value.data() >= column.bytes.data() &&
+        value.data() < column.bytes.data() + column.bytes.size()) {
+        copy.assign(value.data(), value.size());
+        value = copy;
+    }
+    
+    size_t slot = slotOf(handle);
+    Entry& entry = column.entries[slot];
+    if (value.size() <= entry.length) {
+        // Fits where the old value was: overwrite in place
+        if (!value.empty()) {
+            memcpy(column.bytes.data() + entry.offset, value.data(), value.size());
+        }
+        column.garbage += entry.length - value.size();
+        entry.length = static_cast<uint32_t>(value.size());
+        if (value.empty()) {
+            entry.offset = 0;
+        }
+    } else {
+        column.garbage += entry.length;
+        entry = Entry{0, 0};
+        if (column.bytes.size() + value.size() > MAX_COLUMN_BYTES) {
+            compact(column);
+            if (column.bytes.size() + value.size() > MAX_COLUMN_BYTES) {
+                throw StorageError("cột dữ liệu vượt quá 4 GiB");
+            }
+        }
+        Entry& placed = column.entries[slot];
+        placed.offset = static_cast<uint32_t>(column.bytes.size());
+        placed.length = static_cast<uint32_t>(value.size());
+        column.bytes.insert(column.bytes.end(), value.begin(), value.end());
+    }
+    
+    if (column.garbage >= MIN_COMPACT_BYTES && column.garbage > column.bytes.size() - column.garbage) {
+        compact(column);
+    }
+}
+
+void ContactStore::compact(Column& column) {
+    vector<char> packed;
+    packed.reserve(column.bytes.size() - column.garbage);
+    for (Entry& entry : column.entries) {
+        if (entry.length == 0) {
+            continue;
+        }
+        uint32_t offset = static_cast<uint32_t>(packed.size());
+        packed.insert(packed.end(), column.bytes.begin() + entry.offset,
+                      column.bytes.begin() + entry.offset + entry.length);
+        entry.offset = offset;
+    }
+    column.bytes.swap(packed);
+    column.garbage = 0;
+}
+
+void ContactStore::shrinkToFit() {
+    for (Column& column : columns) {
+        compact(column);
+        column.bytes.shrink_to_fit();
+        column.entries.shrink_to_fit();
+    }
+    owners.shrink_to_fit();
+}
+
+ContactStore::Stats ContactStore::stats() const {
+    Stats stats = Stats();
+    stats.handles = owners.size();
+    stats.records = owners.size() - freeHandles.size();
+    for (const Column& column : columns) {
+        stats.entryBytes += column.entries.capacity() * sizeof(Entry);
+        stats.liveBytes += column.bytes.size() - column.garbage;
+        stats.arenaBytes += column.bytes.capacity();
+    }
+    return stats;
+}
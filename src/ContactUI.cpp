@@ -1,11 +1,12 @@
 #include "ContactUI.h"
+#include "BatchCommandRunner.h"
 #include <iostream>
 #include <limits>
 #include <algorithm>
 
 using namespace std;
 
-ContactUI::ContactUI() {
+ContactUI::ContactUI(const string& dataFile) : dataFile(dataFile) {
     manager = ContactManager::getInstance();
 }
 
@@ -13,6 +14,10 @@ ContactUI::~ContactUI() {}
 
 void ContactUI::run() {
     showWelcome();
+    if (!loadData() && !confirmInMemoryMode()) {
+        showGoodbye();
+        return;
+    }
     
     int choice;
     do {
@@ -39,6 +44,7 @@ void ContactUI::run() {
             manager->printTreeStructures();
             break;
         case 7:
+            saveData();
             showGoodbye();
             break;
         default:
@@ -53,6 +59,69 @@ void ContactUI::run() {
     } while (choice != 7);
 }
 
+// 📜 Không menu, không xóa màn hình: kết quả ra stdout, thông báo nạp/lưu dữ liệu ra stderr.
+// Không mở được dữ liệu thì không chạy lệnh nào (không có ai để hỏi như ở chế độ menu)
+bool ContactUI::runBatch(istream& in) {
+    streambuf* saved = cout.rdbuf(cerr.rdbuf());
+    bool loaded = loadData();
+    cout.rdbuf(saved);
+    if (!loaded) {
+        cerr << " Lỗi: không mở được dữ liệu từ " << dataFile << ", không chạy lệnh nào"
+             << " (--memory để chạy không lưu)" << endl;
+        return false;
+    }
+    
+    BatchCommandRunner runner(manager);
+    BatchCommandRunner::Summary summary = runner.run(in, cout);
+    cout.flush();
+    
+    saved = cout.rdbuf(cerr.rdbuf());
+    bool stored = dataFile.empty() || saveData();
+    cout.rdbuf(saved);
+    if (!stored) {
+        cerr << " Lỗi: các thay đổi chưa được lưu vào " << dataFile << endl;
+    }
+    return summary.failures == 0 && stored;
+}
+
+// 💾 Nạp snapshot + phát lại WAL khi khởi động; mọi thay đổi sau đó được ghi log ngay
+bool ContactUI::loadData() const {
+    if (dataFile.empty()) {
+        return true;
+    }
+    
+    if (!manager->openStorage(dataFile, dataFile + ".wal")) {
+        return false;  // manager đã in lý do
+    }
+    if (!manager->isEmpty()) {
+        cout << " Đã nạp " << manager->getTotalContacts() << " liên hệ từ " << dataFile << endl;
+    }
+    return true;
+}
+
+// Checkpoint khi thoát: snapshot mới, WAL được cắt về rỗng
+bool ContactUI::saveData() const {
+    if (dataFile.empty() || !manager->closeStorage()) {
+        return false;
+    }
+    
+    cout << " Đã lưu " << manager->getTotalContacts() << " liên hệ vào " << dataFile << endl;
+    return true;
+}
+
+// ⚠️ Không mở được dữ liệu: chỉ chạy tiếp khi người dùng đồng ý làm việc không lưu
+bool ContactUI::confirmInMemoryMode() {
+    cout << " Không mở được dữ liệu từ " << dataFile << "; file không bị thay đổi." << endl;
+    string answer = getStringInput("Tiếp tục mà không lưu (mọi thay đổi mất khi thoát)? (c/K): ");
+    if (answer != "c" && answer != "C") {
+        return false;
+    }
+    
+    dataFile.clear();
+    manager->clearAll();  // Bỏ phần đã nạp dở (nếu có)
+    return true;
+}
+
 void ContactUI::showWelcome() const {
     clearScreen();
     cout << "=========================================" << endl;
@@ -120,7 +189,9 @@ void ContactUI::showSearchMenu() const {
     cout << "1. Tìm kiếm theo tên" << endl;
     cout << "2. Tìm kiếm theo số điện thoại" << endl;
     cout << "3. Tìm kiếm theo email" << endl;
-    cout << "4. Quay lại menu chính" << endl;
+    cout << "4. Tìm theo tiền tố tên (gợi ý nhanh)" << endl;
+    cout << "5. Tìm theo tiền tố số điện thoại (gợi ý nhanh)" << endl;
+    cout << "6. Quay lại menu chính" << endl;
     cout << "=====================" << endl;
 }
 
@@ -325,25 +396,25 @@ void ContactUI::addPhoneToContact(Contact* contact) const {
         cout << "Chưa có số điện thoại nào." << endl;
     }
     
+    // 🔑 Mỗi lần nhập chỉ kiểm tra format và trùng lặp một lần
     string phone;
-    do {
+    while (true) {
         phone = getStringInput("Nhập số điện thoại mới (tối đa 11 số): ");
         if (phone.empty()) {
             cout << " Số điện thoại không được để trống!" << endl;
-        } else if (!manager->canAddPhoneNumber(phone, contact)) {
-            // 🔑 Sử dụng validation mới từ ContactManager
-            if (!manager->isPhoneNumberValid(phone)) {
-                cout << "  Số điện thoại không hợp lệ! Chỉ được chứa số và tối đa 11 ký tự." << endl;
-            } else if (manager->isPhoneNumberDuplicate(phone, contact)) {
-                cout << "  Số điện thoại này đã tồn tại trong liên hệ khác!" << endl;
-            }
+        } else if (!manager->isPhoneNumberValid(phone)) {
+            cout << "  Số điện thoại không hợp lệ! Chỉ được chứa số và tối đa 11 ký tự." << endl;
+        } else if (manager->isPhoneNumberDuplicate(phone, contact)) {
+            cout << "  Số điện thoại này đã tồn tại trong liên hệ khác!" << endl;
+        } else {
+            break;
         }
-    } while (phone.empty() || !manager->canAddPhoneNumber(phone, contact));
-    
-    contact->setPhoneNumber(phone);  // 🔑 Thay thế số điện thoại cũ
+    }
     
-    // ⚠️ QUAN TRỌNG: Đồng bộ tất cả index để đảm bảo tìm kiếm chính xác
-    manager->syncAllIndexes(contact);
+    // 🔑 Thay thế số điện thoại cũ và đồng bộ index trong ContactManager
+    if (!manager->setContactPhone(contact, phone)) {
+        return;
+    }
     
     cout << "✓ Số điện thoại '" << phone << "' đã được cập nhật thành công!" << endl;
 }
@@ -373,25 +444,25 @@ void ContactUI::addEmailToContact(Contact* contact) const {
         cout << "Chưa có email nào." << endl;
     }
     
+    // 🔑 Mỗi lần nhập chỉ kiểm tra format và trùng lặp một lần
     string email;
-    do {
+    while (true) {
         email = getStringInput("Nhập địa chỉ email mới: ");
         if (email.empty()) {
             cout << " Email không được để trống!" << endl;
-        } else if (!manager->canAddEmail(email, contact)) {
-            // 🔑 Sử dụng validation mới từ ContactManager
-            if (!manager->isValidEmail(email)) {
-                cout << "  Email không hợp lệ! Vui lòng nhập lại." << endl;
-            } else if (manager->isEmailDuplicate(email, contact)) {
-                cout << "  Email này đã tồn tại trong liên hệ khác!" << endl;
-            }
+        } else if (!manager->isValidEmail(email)) {
+            cout << "  Email không hợp lệ! Vui lòng nhập lại." << endl;
+        } else if (manager->isEmailDuplicate(email, contact)) {
+            cout << "  Email này đã tồn tại trong liên hệ khác!" << endl;
+        } else {
+            break;
         }
-    } while (email.empty() || !manager->canAddEmail(email, contact));
-    
-    contact->setEmail(email);  // 🔑 Thay thế email cũ
+    }
     
-    // ⚠️ QUAN TRỌNG: Đồng bộ tất cả index để đảm bảo tìm kiếm chính xác
-    manager->syncAllIndexes(contact);
+    // 🔑 Thay thế email cũ và đồng bộ index trong ContactManager
+    if (!manager->setContactEmail(contact, email)) {
+        return;
+    }
     
     cout << "✓ Email '" << email << "' đã được cập nhật thành công!" << endl;
 }
@@ -401,7 +472,7 @@ void ContactUI::addAddressToContact(Contact* contact) const {
     cout << "Liên hệ: " << contact->getName() << endl;
     
     // Hiển thị địa chỉ hiện tại
-    string currentAddress = contact->getAddress();
+    string_view currentAddress = contact->getAddress();
     if (!currentAddress.empty()) {
         cout << "Địa chỉ hiện tại: " << currentAddress << endl;
     }
@@ -416,8 +487,9 @@ void ContactUI::addAddressToContact(Contact* contact) const {
         }
     } while (address.empty() || address.length() < 5);
     
-    contact->setAddress(address);
-    cout << "✓ Địa chỉ đã được cập nhật thành công!" << endl;
+    if (manager->setContactAddress(contact, address)) {
+        cout << "✓ Địa chỉ đã được cập nhật thành công!" << endl;
+    }
 }
 
 void ContactUI::addNotesToContact(Contact* contact) const {
@@ -425,15 +497,16 @@ void ContactUI::addNotesToContact(Contact* contact) const {
     cout << "Liên hệ: " << contact->getName() << endl;
     
     // Hiển thị ghi chú hiện tại
-    string currentNotes = contact->getNotes();
+    string_view currentNotes = contact->getNotes();
     if (!currentNotes.empty()) {
         cout << "Ghi chú hiện tại: " << currentNotes << endl;
     }
     
     string notes = getStringInput("Nhập ghi chú mới: ");
     if (!notes.empty()) {
-        contact->setNotes(notes);
-        cout << "✓ Ghi chú đã được cập nhật thành công!" << endl;
+        if (manager->setContactNotes(contact, notes)) {
+            cout << "✓ Ghi chú đã được cập nhật thành công!" << endl;
+        }
     } else {
         cout << "ℹ Không có thay đổi gì." << endl;
     }
@@ -456,8 +529,11 @@ void ContactUI::editContactName(Contact* contact) const {
         }
     } while (newName.empty() || newName.length() < 2);
     
-    contact->setName(newName);
-    cout << "✓ Tên đã được thay đổi từ '" << contact->getName() << "' thành '" << newName << "'!" << endl;
+    string oldName(contact->getName());  // Giữ lại để in sau khi đổi tên
+    if (!manager->renameContact(contact, newName)) {
+        return;
+    }
+    cout << "✓ Tên đã được thay đổi từ '" << oldName << "' thành '" << newName << "'!" << endl;
 }
 
 void ContactUI::managePhoneNumbers(Contact* contact) const {
@@ -547,10 +623,10 @@ void ContactUI::deletePhoneNumber(Contact* contact) const {
         return;
     }
     
-    contact->setPhoneNumber("");  // 🔑 Xóa số điện thoại bằng cách set rỗng
-    
-    // ⚠️ QUAN TRỌNG: Đồng bộ tất cả index để đảm bảo tìm kiếm chính xác
-    manager->syncAllIndexes(contact);
+    // 🔑 Xóa số điện thoại bằng cách set rỗng (ContactManager gỡ khỏi index)
+    if (!manager->setContactPhone(contact, "")) {
+        return;
+    }
     
     cout << "✓ Số điện thoại đã được xóa!" << endl;
 }
@@ -572,10 +648,10 @@ void ContactUI::deleteEmail(Contact* contact) const {
         return;
     }
     
-    contact->setEmail("");  // 🔑 Xóa email bằng cách set rỗng
-    
-    // ⚠️ QUAN TRỌNG: Đồng bộ tất cả index để đảm bảo tìm kiếm chính xác
-    manager->syncAllIndexes(contact);
+    // 🔑 Xóa email bằng cách set rỗng (ContactManager gỡ khỏi index)
+    if (!manager->setContactEmail(contact, "")) {
+        return;
+    }
     
     cout << "✓ Email đã được xóa!" << endl;
 }
@@ -595,6 +671,12 @@ void ContactUI::searchContacts() const {
             searchByEmail();
             break;
         case 4:
+            searchByNamePrefix();
+            break;
+        case 5:
+            searchByPhonePrefix();
+            break;
+        case 6:
             return;
         default:
             cout << " Lựa chọn không hợp lệ!" << endl;
@@ -629,6 +711,24 @@ void ContactUI::searchByEmail() const {
     pause();
 }
 
+void ContactUI::searchByNamePrefix() const {
+    cout << "\n=== TÌM THEO TIỀN TỐ TÊN ===" << endl;
+    string prefix = getStringInput("Nhập phần đầu của tên: ");
+    
+    vector<Contact*> results = manager->searchByNamePrefix(prefix);
+    displaySearchResults(results);
+    pause();
+}
+
+void ContactUI::searchByPhonePrefix() const {
+    cout << "\n=== TÌM THEO TIỀN TỐ SỐ ĐIỆN THOẠI ===" << endl;
+    string prefix = getStringInput("Nhập các số đầu (vd: 0903): ");
+    
+    vector<Contact*> results = manager->searchByPhonePrefix(prefix);
+    displaySearchResults(results);
+    pause();
+}
+
 void ContactUI::displayAllContacts() const {
     manager->displayAllContacts();
 }
@@ -645,6 +745,19 @@ void ContactUI::displaySearchResults(const set<Contact*>& results) const {
     }
 }
 
+void ContactUI::displaySearchResults(const vector<Contact*>& results) const {
+    if (results.empty()) {
+        cout << "🔍 Không tìm thấy liên hệ nào!" << endl;
+        return;
+    }
+    
+    // Giữ nguyên thứ tự khóa (thứ tự gợi ý)
+    cout << "\n=== KẾT QUẢ TÌM KIẾM (" << results.size() << " kết quả) ===" << endl;
+    for (Contact* contact : results) {
+        contact->display();
+    }
+}
+
 string ContactUI::getStringInput(const string& prompt) const {
     string input;
     cout << prompt;
@@ -0,0 +1,79 @@
+#include "FieldValidator.h"
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+
+// Byte classes (bit set = allowed there)
+enum : uint8_t {
+    LOCAL = 1,   // [a-zA-Z0-9._%+-]  before the '@'
+    DOMAIN = 2,  // [a-zA-Z0-9.-]     after the '@'
+    ALPHA = 4,   // [a-zA-Z]          top-level domain
+    DIGIT = 8    // [0-9]
+};
+
+struct ByteClasses {
+    uint8_t of[256];
+    
+    constexpr ByteClasses() : of() {
+        for (int c = 'a'; c <= 'z'; c++) {
+            of[c] = of[c - 'a' + 'A'] = LOCAL | DOMAIN | ALPHA;
+        }
+        for (int c = '0'; c <= '9'; c++) {
+            of[c] = LOCAL | DOMAIN | DIGIT;
+        }
+        of['.'] = of['-'] = LOCAL | DOMAIN;
+        of['_'] = of['%'] = of['+'] = LOCAL;
+    }
+};
+
+constexpr ByteClasses classes;
+
+inline uint8_t classOf(char c) {
+    return classes.of[static_cast<unsigned char>(c)];
+}
+
+} // namespace
+
+bool FieldValidator::isValidPhone(string_view phone) {
+    if (phone.empty() || phone.size() > MAX_PHONE_DIGITS) {
+        return false;
+    }
+    
+    for (char c : phone) {
+        if (!(classOf(c) & DIGIT)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The domain is matched in the same pass: "[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}"
+// holds iff every byte is a domain byte and the last non-letter is a '.'
+// that has at least one byte before it and at least two letters after it.
+bool FieldValidator::isValidEmail(string_view email) {
+    size_t size = email.size();
+    size_t i = 0;
+    while (i < size && (classOf(email[i]) & LOCAL)) {
+        i++;
+    }
+    if (i == 0 || i == size || email[i] != '@') {
+        return false;
+    }
+    
+    size_t domain = ++i;
+    size_t lastNonAlpha = size;
+    for (; i < size; i++) {
+        uint8_t c = classOf(email[i]);
+        if (!(c & DOMAIN)) {
+            return false;
+        }
+        if (!(c & ALPHA)) {
+            lastNonAlpha = i;
+        }
+    }
+    
+    return lastNonAlpha != size && email[lastNonAlpha] == '.' && lastNonAlpha > domain &&
+           size - lastNonAlpha > 2;
+}
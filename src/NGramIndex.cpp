@@ -0,0 +1,208 @@
+#include "NGramIndex.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+NGramIndex::NGramIndex() : entries(0) {}
+
+uint32_t NGramIndex::packGram(string_view text, size_t pos) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(text[pos])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 2]));
+}
+
+void NGramIndex::distinctGrams(string_view text, vector<uint32_t>& grams) {
+    grams.clear();
+    if (text.size() < GRAM) {
+        return;
+    }
+    
+    for (size_t pos = 0; pos + GRAM <= text.size(); pos++) {
+        grams.push_back(packGram(text, pos));
+    }
+    sort(grams.begin(), grams.end());
+    grams.erase(unique(grams.begin(), grams.end()), grams.end());
+}
+
+namespace {
+
+bool sortedContains(const vector<int>& list, int id) {
+    return binary_search(list.begin(), list.end(), id);
+}
+
+// Inserts id into a sorted list; false if it was already there
+bool sortedInsert(vector<int>& list, int id) {
+    auto it = lower_bound(list.begin(), list.end(), id);
+    if (it != list.end() && *it == id) {
+        return false;
+    }
+    list.insert(it, id);
+    return true;
+}
+
+bool sortedErase(vector<int>& list, int id) {
+    auto it = lower_bound(list.begin(), list.end(), id);
+    if (it == list.end() || *it != id) {
+        return false;
+    }
+    list.erase(it);
+    return true;
+}
+
+} // namespace
+
+bool NGramIndex::Posting::contains(int id) const {
+    if (sortedContains(ids, id)) {
+        return dead.empty() || !sortedContains(dead, id);
+    }
+    return !extra.empty() && sortedContains(extra, id);
+}
+
+bool NGramIndex::Posting::add(int id) {
+    // Common case: a newer (larger) ID than everything in the list
+    if (ids.empty() || ids.back() < id) {
+        ids.push_back(id);
+        return true;
+    }
+    
+    bool added;
+    if (sortedContains(ids, id)) {
+        added = !dead.empty() && sortedErase(dead, id);  // Re-added (rename keeping the trigram)
+    } else {
+        added = sortedInsert(extra, id);
+    }
+    if (dead.size() + extra.size() > sideLimit) {
+        compact();
+    }
+    return added;
+}
+
+bool NGramIndex::Posting::remove(int id) {
+    bool removed;
+    if (!extra.empty() && sortedErase(extra, id)) {
+        removed = true;
+    } else {
+        removed = sortedContains(ids, id) && sortedInsert(dead, id);
+    }
+    if (dead.size() + extra.size() > sideLimit) {
+        compact();
+    }
+    return removed;
+}
+
+void NGramIndex::Posting::liveIds(vector<int>& out) const {
+    out.clear();
+    out.reserve(live());
+    auto deadIt = dead.begin();
+    auto extraIt = extra.begin();
+    for (int id : ids) {
+        while (extraIt != extra.end() && *extraIt < id) {
+            out.push_back(*extraIt++);
+        }
+        if (deadIt != dead.end() && *deadIt == id) {
+            ++deadIt;
+            continue;
+        }
+        out.push_back(id);
+    }
+    out.insert(out.end(), extraIt, extra.end());
+}
+
+// One linear pass; the next merge is another ~sqrt(size) edits away
+void NGramIndex::Posting::compact() {
+    if (!clean()) {
+        vector<int> merged;
+        liveIds(merged);
+        ids.swap(merged);
+        dead.clear();
+        extra.clear();
+    }
+    sideLimit = 32 + static_cast<size_t>(sqrt(static_cast<double>(ids.size())));
+}
+
+void NGramIndex::add(int id, string_view text) {
+    vector<uint32_t> grams;
+    distinctGrams(text, grams);
+    
+    for (uint32_t gram : grams) {
+        if (postings[gram].add(id)) {
+            entries++;
+        }
+    }
+}
+
+void NGramIndex::remove(int id, string_view text) {
+    vector<uint32_t> grams;
+    distinctGrams(text, grams);
+    
+    for (uint32_t gram : grams) {
+        auto found = postings.find(gram);
+        if (found == postings.end()) {
+            continue;
+        }
+        
+        if (found->second.remove(id)) {
+            entries--;
+        }
+        if (found->second.live() == 0) {
+            postings.erase(found);
+        }
+    }
+}
+
+void NGramIndex::clear() {
+    postings.clear();
+    entries = 0;
+}
+
+bool NGramIndex::candidates(string_view pattern, vector<int>& ids) const {
+    ids.clear();
+    if (pattern.size() < GRAM) {
+        return false;
+    }
+    
+    vector<uint32_t> grams;
+    distinctGrams(pattern, grams);
+    
+    // Gather posting lists; a missing trigram means no text can match
+    vector<const Posting*> lists;
+    lists.reserve(grams.size());
+    for (uint32_t gram : grams) {
+        auto found = postings.find(gram);
+        if (found == postings.end()) {
+            return true;
+        }
+        lists.push_back(&found->second);
+    }
+    
+    // Intersect smallest-first so the working set only shrinks
+    sort(lists.begin(), lists.end(),
+         [](const Posting* a, const Posting* b) { return a->live() < b->live(); });
+    lists[0]->liveIds(ids);
+    
+    vector<int> next;
+    vector<int> merged;
+    for (size_t i = 1; i < lists.size() && !ids.empty(); i++) {
+        const Posting& posting = *lists[i];
+        next.clear();
+        
+        if (posting.live() > ids.size() * 8) {
+            // Much longer list: look up each surviving candidate
+            for (int id : ids) {
+                if (posting.contains(id)) {
+                    next.push_back(id);
+                }
+            }
+        } else {
+            const vector<int>* list = &posting.ids;
+            if (!posting.clean()) {
+                posting.liveIds(merged);
+                list = &merged;
+            }
+            set_intersection(ids.begin(), ids.end(), list->begin(), list->end(), back_inserter(next));
+        }
+        ids.swap(next);
+    }
+    return true;
+}
@@ -0,0 +1,293 @@
+#include "ShardedContactManager.h"
+#include "FieldValidator.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+
+// Sau khi shard ghi xong: trả lại khóa không còn dùng, khóa cũ nếu shard đã đổi giá trị,
+// khóa mới (đã giành trước) nếu shard từ chối
+void releaseUnused(UniqueKeyTable& table, int id, const string& oldKey, const string& newKey, bool changed) {
+    const string& unused = changed ? oldKey : newKey;
+    if (!unused.empty() && oldKey != newKey) {
+        table.release(unused, id);
+    }
+}
+
+} // namespace
+
+// Stripe gấp 4 lần số shard: hai luồng ghi hiếm khi cần cùng một stripe
+ShardedContactManager::ShardedContactManager(size_t shardCount)
+    : names(shardCount * 4), phones(shardCount * 4), emails(shardCount * 4) {
+    size_t count = max<size_t>(shardCount, 1);
+    for (size_t i = 0; i < count; i++) {
+        shards.push_back(unique_ptr<Shard>(new Shard(ContactStore::create())));
+        // Shard i chỉ giữ ID ≡ i (mod count): bảng ID một slot cho mỗi count ID
+        shards.back()->contactsById.setStride(static_cast<int>(count));
+    }
+}
+
+ShardedContactManager::~ShardedContactManager() {
+    for (unique_ptr<Shard>& shard : shards) {
+        ContactStore* store = shard->store;
+        shard.reset();  // Xóa các liên hệ trước, rồi mới bỏ store chứa trường của chúng
+        ContactStore::destroy(store);
+    }
+}
+
+ShardedContactManager::Shard& ShardedContactManager::shardOf(int id) const {
+    return *shards[static_cast<unsigned>(id) % shards.size()];
+}
+
+bool ShardedContactManager::addContact(const string& name) {
+    try {
+        if (name.empty()) {
+            throw EmptyInput("tên");
+        }
+    
+        // ID lấy trước để biết shard; tên trùng thì ID này bị bỏ qua
+        int id = Contact::allocateId();
+        if (!names.claim(name, id)) {
+            throw ContactAlreadyExists(name);
+        }
+    
+        Shard& shard = shardOf(id);
+        try {
+            Shard::WriteGuard guard(shard.indexLock);
+            Contact* contact = Contact::create(id, name, shard.store);
+            try {
+                shard.addToIndexes(contact);
+            } catch (...) {
+                // Gỡ phần index đã thêm (tên đã giành nên không đụng liên hệ khác) rồi trả bản ghi
+                shard.removeFromIndexes(contact);
+                Contact::destroy(contact);
+                throw;
+            }
+        } catch (...) {
+            names.release(name, id);
+            throw;
+        }
+    
+        cout << " Liên hệ '" << name << "' đã được thêm thành công với ID: " << id << endl;
+        return true;
+    } catch (const ContactException& e) {
+        Shard::reportError(e);
+        return false;
+    }
+}
+
+bool ShardedContactManager::removeContact(int id) {
+    Shard& shard = shardOf(id);
+    try {
+        string name;
+        string phone;
+        string email;
+        {
+            Shard::WriteGuard guard(shard.indexLock);
+            Contact* contact = shard.findContactLocked(id);
+            if (contact == nullptr) {
+                throw ContactNotFound("ID " + to_string(id));
+            }
+    
+            name.assign(contact->getName());
+            phone.assign(contact->getPhoneNumber());
+            email.assign(contact->getEmail());
+            shard.removeFromIndexes(contact);
+            Contact::destroy(contact);
+        }
+    
+        // Khóa được trả sau khi liên hệ đã rời shard
+        names.release(name, id);
+        if (!phone.empty()) {
+            phones.release(phone, id);
+        }
+        if (!email.empty()) {
+            emails.release(email, id);
+        }
+    
+        cout << " Liên hệ '" << name << "' (ID: " << id << ") đã được xóa thành công!" << endl;
+        return true;
+    } catch (const ContactException& e) {
+        Shard::reportError(e);
+        return false;
+    }
+}
+
+bool ShardedContactManager::removeContact(const string& name) {
+    int id = names.ownerOf(name);
+    if (id == 0) {
+        Shard::reportError(ContactNotFound(name));
+        return false;
+    }
+    return removeContact(id);
+}
+
+// Cùng lastError (thread_local) mà các shard ghi khi chúng báo lỗi
+const string& ShardedContactManager::getLastError() {
+    return Shard::getLastError();
+}
+
+Contact* ShardedContactManager::findContact(int id) {
+    return shardOf(id).findContact(id);
+}
+
+Contact* ShardedContactManager::findContact(const string& name) {
+    int id = names.ownerOf(name);
+    return id != 0 ? shardOf(id).findContact(id) : nullptr;
+}
+
+bool ShardedContactManager::copyContact(int id, ContactRecord& out) const {
+    return shardOf(id).copyContact(id, out);
+}
+
+bool ShardedContactManager::renameContact(Contact* contact, const string& newName) {
+    int id = contact->getId();
+    try {
+        if (newName.empty()) {
+            throw EmptyInput("tên");
+        }
+        if (!names.claim(newName, id)) {
+            throw ContactAlreadyExists(newName);
+        }
+    } catch (const ContactException& e) {
+        Shard::reportError(e);
+        return false;
+    }
+    
+    Shard& shard = shardOf(id);
+    string oldName;
+    bool renamed;
+    {
+        Shard::WriteGuard guard(shard.indexLock);
+        oldName.assign(contact->getName());
+        renamed = shard.renameContactLocked(contact, newName);
+    }
+    releaseUnused(names, id, oldName, newName, renamed);
+    return renamed;
+}
+
+bool ShardedContactManager::setContactPhone(Contact* contact, const string& phone) {
+    int id = contact->getId();
+    try {
+        if (!phone.empty() && !FieldValidator::isValidPhone(phone)) {
+            throw InvalidInput("số điện thoại");
+        }
+        if (!phone.empty() && !phones.claim(phone, id)) {
+            throw ContactException("Số điện thoại đã tồn tại trong liên hệ khác: " + phone);
+        }
+    } catch (const ContactException& e) {
+        Shard::reportError(e);
+        return false;
+    }
+    
+    Shard& shard = shardOf(id);
+    string oldPhone;
+    bool updated;
+    {
+        Shard::WriteGuard guard(shard.indexLock);
+        oldPhone.assign(contact->getPhoneNumber());
+        updated = shard.setContactPhoneLocked(contact, phone);
+    }
+    releaseUnused(phones, id, oldPhone, phone, updated);
+    return updated;
+}
+
+bool ShardedContactManager::setContactEmail(Contact* contact, const string& email) {
+    int id = contact->getId();
+    try {
+        if (!email.empty() && !FieldValidator::isValidEmail(email)) {
+            throw InvalidInput("email");
+        }
+        if (!email.empty() && !emails.claim(email, id)) {
+            throw ContactException("Email đã tồn tại trong liên hệ khác: " + email);
+        }
+    } catch (const ContactException& e) {
+        Shard::reportError(e);
+        return false;
+    }
+    
+    Shard& shard = shardOf(id);
+    string oldEmail;
+    bool updated;
+    {
+        Shard::WriteGuard guard(shard.indexLock);
+        oldEmail.assign(contact->getEmail());
+        updated = shard.setContactEmailLocked(contact, email);
+    }
+    releaseUnused(emails, id, oldEmail, email, updated);
+    return updated;
+}
+
+bool ShardedContactManager::setContactAddress(Contact* contact, const string& address) {
+    return shardOf(contact->getId()).setContactAddress(contact, address);
+}
+
+bool ShardedContactManager::setContactNotes(Contact* contact, const string& notes) {
+    return shardOf(contact->getId()).setContactNotes(contact, notes);
+}
+
+// 🔍 Mỗi shard tìm dưới khóa đọc của nó, các shard chạy song song; luồng gọi làm shard đầu tiên
+template<typename Search>
+set<Contact*> ShardedContactManager::gather(Search search) const {
+    vector<set<Contact*>> parts(shards.size());
+    {
+        WorkStealingPool::TaskGroup group(WorkStealingPool::shared());
+        for (size_t i = 1; i < shards.size(); i++) {
+            group.run([&, i] { parts[i] = search(*shards[i]); });
+        }
+        parts[0] = search(*shards[0]);
+        group.wait();
+    }
+    
+    set<Contact*> results;
+    for (const set<Contact*>& part : parts) {
+        results.insert(part.begin(), part.end());
+    }
+    return results;
+}
+
+set<Contact*> ShardedContactManager::searchByName(const string& name) {
+    return gather([&](Shard& shard) { return shard.searchByName(name); });
+}
+
+set<Contact*> ShardedContactManager::searchByPhone(const string& phone) {
+    return gather([&](Shard& shard) { return shard.searchByPhone(phone); });
+}
+
+set<Contact*> ShardedContactManager::searchByEmail(const string& email) {
+    return gather([&](Shard& shard) { return shard.searchByEmail(email); });
+}
+
+bool ShardedContactManager::isPhoneNumberDuplicate(string_view phone, Contact* excludeContact) const {
+    int owner = phones.ownerOf(phone);
+    return owner != 0 && (excludeContact == nullptr || owner != excludeContact->getId());
+}
+
+bool ShardedContactManager::isEmailDuplicate(string_view email, Contact* excludeContact) const {
+    int owner = emails.ownerOf(email);
+    return owner != 0 && (excludeContact == nullptr || owner != excludeContact->getId());
+}
+
+int ShardedContactManager::getTotalContacts() const {
+    int total = 0;
+    for (const unique_ptr<Shard>& shard : shards) {
+        total += shard->getTotalContacts();
+    }
+    return total;
+}
+
+bool ShardedContactManager::isEmpty() const {
+    return getTotalContacts() == 0;
+}
+
+void ShardedContactManager::clearAll() {
+    for (unique_ptr<Shard>& shard : shards) {
+        shard->clearAll();
+    }
+    names.clear();
+    phones.clear();
+    emails.clear();
+}
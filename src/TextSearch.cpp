@@ -0,0 +1,110 @@
+#include "TextSearch.h"
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+
+inline unsigned char foldByte(char c) {
+    unsigned char byte = static_cast<unsigned char>(c);
+    return static_cast<unsigned>(byte - 'A') < 26u ? byte | 0x20 : byte;
+}
+
+// Base letter of a precomposed Latin letter used in Vietnamese, 0 otherwise
+char baseLetter(uint32_t codePoint) {
+    // U+00C0-U+00FF, '.' = no base letter (Æ, ×, Þ, ß, æ, ÷, þ)
+    static const char LATIN1[] = "aaaaaa.ceeeeiiiidnooooo.ouuuuy.."
+                                 "aaaaaa.ceeeeiiiidnooooo.ouuuuy.y";
+    if (codePoint >= 0xC0 && codePoint <= 0xFF) {
+        char base = LATIN1[codePoint - 0xC0];
+        return base == '.' ? 0 : base;
+    }
+    
+    switch (codePoint) {
+    case 0x102: case 0x103:  // Ă ă
+        return 'a';
+    case 0x110: case 0x111:  // Đ đ
+        return 'd';
+    case 0x128: case 0x129:  // Ĩ ĩ
+        return 'i';
+    case 0x168: case 0x169:  // Ũ ũ
+    case 0x1AF: case 0x1B0:  // Ư ư
+        return 'u';
+    case 0x1A0: case 0x1A1:  // Ơ ơ
+        return 'o';
+    default:
+        break;
+    }
+    
+    // Latin Extended Additional, Vietnamese block: Ạ..ặ, Ẹ..ệ, Ỉ..ị, Ọ..ợ, Ụ..ự, Ỳ..ỹ
+    if (codePoint < 0x1EA0 || codePoint > 0x1EF9) {
+        return 0;
+    }
+    if (codePoint < 0x1EB8) {
+        return 'a';
+    }
+    if (codePoint < 0x1EC8) {
+        return 'e';
+    }
+    if (codePoint < 0x1ECC) {
+        return 'i';
+    }
+    if (codePoint < 0x1EE4) {
+        return 'o';
+    }
+    if (codePoint < 0x1EF2) {
+        return 'u';
+    }
+    return 'y';
+}
+
+inline bool isContinuation(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+} // namespace
+
+string TextSearch::foldKey(string_view text) {
+    string key;
+    key.reserve(text.size());
+    appendFoldedKey(key, text);
+    return key;
+}
+
+void TextSearch::appendFoldedKey(string& out, string_view text) {
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        if (lead < 0x80) {
+            out.push_back(static_cast<char>(foldByte(text[i])));
+            i++;
+            continue;
+        }
+        
+        // Two- and three-byte UTF-8 sequences are decoded; anything else
+        // (four-byte sequences, stray bytes) is copied a byte at a time
+        uint32_t codePoint;
+        size_t length;
+        if ((lead & 0xE0) == 0xC0 && i + 1 < text.size() && isContinuation(text[i + 1])) {
+            codePoint = (uint32_t(lead & 0x1F) << 6) | (text[i + 1] & 0x3F);
+            length = 2;
+        } else if ((lead & 0xF0) == 0xE0 && i + 2 < text.size() && isContinuation(text[i + 1]) &&
+                   isContinuation(text[i + 2])) {
+            codePoint = (uint32_t(lead & 0x0F) << 12) | (uint32_t(text[i + 1] & 0x3F) << 6) | (text[i + 2] & 0x3F);
+            length = 3;
+        } else {
+            out.push_back(text[i]);
+            i++;
+            continue;
+        }
+        
+        if (codePoint >= 0x300 && codePoint <= 0x36F) {
+            // Combining diacritical mark (decomposed input): dropped
+        } else if (char base = baseLetter(codePoint)) {
+            out.push_back(base);
+        } else {
+            out.append(text.data() + i, length);
+        }
+        i += length;
+    }
+}
@@ -0,0 +1,68 @@
+#include "UniqueKeyTable.h"
+
+using namespace std;
+
+// Một cache line mỗi stripe: mutex của các stripe cạnh nhau không tranh nhau cùng dòng
+struct alignas(64) UniqueKeyTable::Stripe {
+    mutex lock;
+    HashIndex<string, int, StringHash, equal_to<>> owners;
+};
+
+UniqueKeyTable::UniqueKeyTable(size_t stripeCount) {
+    size_t count = 1;
+    while (count < stripeCount) {
+        count <<= 1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        stripes.push_back(unique_ptr<Stripe>(new Stripe()));
+    }
+}
+
+UniqueKeyTable::~UniqueKeyTable() {}
+
+UniqueKeyTable::Stripe& UniqueKeyTable::stripeOf(string_view key) const {
+    return *stripes[hasher(key) & (stripes.size() - 1)];
+}
+
+bool UniqueKeyTable::claim(string_view key, int owner) {
+    Stripe& stripe = stripeOf(key);
+    lock_guard<mutex> guard(stripe.lock);
+    const int* current = stripe.owners.find(key);
+    if (current != nullptr) {
+        return *current == owner;
+    }
+    stripe.owners.insert(string(key), owner);
+    return true;
+}
+
+void UniqueKeyTable::release(string_view key, int owner) {
+    Stripe& stripe = stripeOf(key);
+    lock_guard<mutex> guard(stripe.lock);
+    const int* current = stripe.owners.find(key);
+    if (current != nullptr && *current == owner) {
+        stripe.owners.remove(key);
+    }
+}
+
+int UniqueKeyTable::ownerOf(string_view key) const {
+    Stripe& stripe = stripeOf(key);
+    lock_guard<mutex> guard(stripe.lock);
+    const int* current = stripe.owners.find(key);
+    return current != nullptr ? *current : 0;
+}
+
+size_t UniqueKeyTable::size() const {
+    size_t total = 0;
+    for (const unique_ptr<Stripe>& stripe : stripes) {
+        lock_guard<mutex> guard(stripe->lock);
+        total += stripe->owners.size();
+    }
+    return total;
+}
+
+void UniqueKeyTable::clear() {
+    for (const unique_ptr<Stripe>& stripe : stripes) {
+        lock_guard<mutex> guard(stripe->lock);
+        stripe->owners.clear();
+    }
+}
@@ -0,0 +1,168 @@
+#include "WorkStealingPool.h"
+#include <deque>
+
+using namespace std;
+
+namespace {
+
+// Set on each worker thread for its lifetime
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local size_t currentIndex = 0;
+
+size_t defaultWorkers() {
+    unsigned cores = thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+} // namespace
+
+struct alignas(64) WorkStealingPool::Queue {
+    mutex lock;
+    deque<Task> tasks;
+};
+
+WorkStealingPool::WorkStealingPool(size_t workers) {
+    for (size_t i = 0; i <= workers; i++) {
+        queues.push_back(unique_ptr<Queue>(new Queue()));
+    }
+    for (size_t i = 0; i < workers; i++) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (thread& worker : threads) {
+        worker.join();
+    }
+    
+    // Without workers, whatever is left runs here
+    Task task;
+    while (take(queues.size() - 1, task)) {
+        task();
+    }
+}
+
+WorkStealingPool& WorkStealingPool::shared() {
+    static WorkStealingPool pool(defaultWorkers());
+    return pool;
+}
+
+void WorkStealingPool::submit(Task task) {
+    int self = workerIndex();
+    size_t target = self >= 0 ? static_cast<size_t>(self) : nextQueue.fetch_add(1) % queues.size();
+    
+    // Counted before it is visible, so take() never sees more tasks than queued
+    queued.fetch_add(1);
+    {
+        lock_guard<mutex> guard(queues[target]->lock);
+        queues[target]->tasks.push_back(move(task));
+    }
+    
+    // Taking the lock orders this against a worker between its check and its wait
+    {
+        lock_guard<mutex> guard(sleepLock);
+    }
+    wakeUp.notify_one();
+}
+
+bool WorkStealingPool::runOne() {
+    int self = workerIndex();
+    Task task;
+    if (!take(self >= 0 ? static_cast<size_t>(self) : queues.size() - 1, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+bool WorkStealingPool::take(size_t home, Task& task) {
+    if (queued.load() == 0) {
+        return false;
+    }
+    
+    {
+        Queue& own = *queues[home];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    
+    for (size_t i = 1; i < queues.size(); i++) {
+        Queue& victim = *queues[(home + i) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    
+    Task task;
+    while (true) {
+        if (take(index, task)) {
+            task();
+            task = nullptr;  // Drops the captures before sleeping
+            continue;
+        }
+    
+        unique_lock<mutex> guard(sleepLock);
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+        idle.fetch_add(1);
+        wakeUp.wait(guard, [&] { return stopping || queued.load() > 0; });
+        idle.fetch_sub(1);
+    }
+}
+
+int WorkStealingPool::workerIndex() const {
+    return currentPool == this ? static_cast<int>(currentIndex) : -1;
+}
+
+void WorkStealingPool::TaskGroup::run(Task task) {
+    pending.fetch_add(1);
+    pool.submit([this, task] {
+        try {
+            task();
+        } catch (...) {
+            lock_guard<mutex> guard(errorLock);
+            if (!error) {
+                error = current_exception();
+            }
+        }
+        pending.fetch_sub(1);  // Last touch of the group: wait() may return right after
+    });
+}
+
+void WorkStealingPool::TaskGroup::wait() {
+    drain();
+    if (error) {
+        exception_ptr first = error;
+        error = nullptr;
+        rethrow_exception(first);
+    }
+}
+
+void WorkStealingPool::TaskGroup::drain() {
+    while (pending.load() != 0) {
+        if (!pool.runOne()) {
+            this_thread::yield();
+        }
+    }
+}
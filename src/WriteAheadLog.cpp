@@ -0,0 +1,272 @@
+#include "WriteAheadLog.h"
+#include "ContactException.h"
+#include <chrono>
+#include <cstring>
+
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+using namespace std;
+
+static const char WAL_MAGIC[8] = {'S', 'C', 'W', 'A', 'L', '0', '0', '1'};
+static const size_t RECORD_PREFIX = 2 * sizeof(uint32_t);                 // length + crc
+static const size_t BODY_FIXED = sizeof(uint64_t) + 1 + sizeof(int32_t);  // sequence + op + id
+static const uint32_t MAX_BODY = 16 << 20;
+
+// CRC-32 (IEEE)
+struct Crc32Table {
+    uint32_t entries[256];
+    
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+static uint32_t crc32(const char* data, size_t length) {
+    static const Crc32Table table;  // thread-safe one-time init
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc = table.entries[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static bool syncFile(FILE* file) {
+    if (fflush(file) != 0) {
+        return false;
+    }
+#ifndef _WIN32
+    return fdatasync(fileno(file)) == 0;
+#else
+    return _commit(_fileno(file)) == 0;
+#endif
+}
+
+static bool truncateFile(FILE* file, uint64_t length) {
+    fflush(file);
+#ifndef _WIN32
+    return ftruncate(fileno(file), static_cast<off_t>(length)) == 0;
+#else
+    return _chsize_s(_fileno(file), static_cast<__int64>(length)) == 0;
+#endif
+}
+
+uint64_t WriteAheadLog::read(const string& path, vector<Record>& records) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return 0;
+    }
+    
+    char magic[sizeof(WAL_MAGIC)];
+    size_t got = fread(magic, 1, sizeof(magic), file);
+    if (got < sizeof(magic)) {
+        fclose(file);
+        return 0;  // Empty or torn header: start over
+    }
+    if (memcmp(magic, WAL_MAGIC, sizeof(magic)) != 0) {
+        fclose(file);
+        throw StorageError("không phải file WAL: " + path);
+    }
+    
+    uint64_t valid = sizeof(WAL_MAGIC);
+    uint64_t lastSequence = 0;
+    string body;
+    while (true) {
+        uint32_t prefix[2];
+        if (fread(prefix, 1, RECORD_PREFIX, file) != RECORD_PREFIX) {
+            break;
+        }
+        uint32_t length = prefix[0];
+        if (length < BODY_FIXED || length > MAX_BODY) {
+            break;
+        }
+        body.resize(length);
+        if (fread(&body[0], 1, length, file) != length || crc32(body.data(), length) != prefix[1]) {
+            break;
+        }
+    
+        Record record;
+        memcpy(&record.sequence, body.data(), sizeof(uint64_t));
+        record.op = static_cast<Op>(static_cast<unsigned char>(body[sizeof(uint64_t)]));
+        int32_t id;
+        memcpy(&id, body.data() + sizeof(uint64_t) + 1, sizeof(int32_t));
+        record.id = id;
+        record.value.assign(body, BODY_FIXED, string::npos);
+        if (record.sequence <= lastSequence || record.op < OP_ADD || record.op > OP_SET_NOTES) {
+            break;
+        }
+    
+        lastSequence = record.sequence;
+        records.push_back(move(record));
+        valid += RECORD_PREFIX + length;
+    }
+    
+    fclose(file);
+    return valid;
+}
+
+WriteAheadLog::WriteAheadLog(const string& path, uint64_t validBytes, uint64_t nextSequence, const WalOptions& options)
+    : path(path), file(nullptr), options(options), nextSequence(nextSequence),
+      appendedSequence(nextSequence - 1), durableSequence(nextSequence - 1), fileBytes(0),
+      appends(0), syncs(0), flushing(false), syncRequested(false), stopping(false) {
+    file = fopen(path.c_str(), validBytes == 0 ? "wb" : "r+b");
+    if (file == nullptr) {
+        throw StorageError("không mở được file " + path);
+    }
+    
+    bool ok;
+    if (validBytes == 0) {
+        ok = fwrite(WAL_MAGIC, 1, sizeof(WAL_MAGIC), file) == sizeof(WAL_MAGIC);
+        fileBytes = sizeof(WAL_MAGIC);
+    } else {
+        // Cut off a torn tail left by a crash, then append after the intact prefix
+        ok = truncateFile(file, validBytes) && fseek(file, 0, SEEK_END) == 0;
+        fileBytes = validBytes;
+    }
+    if (!ok || !syncFile(file)) {
+        fclose(file);
+        throw StorageError("không ghi được file " + path);
+    }
+    
+    if (options.syncIntervalMs > 0) {
+        flusher = thread(&WriteAheadLog::flusherLoop, this);
+    }
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    {
+        unique_lock<mutex> lock(lock_);
+        stopping = true;
+    }
+    wakeFlusher.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();  // The flusher drains pending before it exits
+    } else {
+        unique_lock<mutex> lock(lock_);
+        flushLocked(lock);
+    }
+    fclose(file);
+}
+
+uint64_t WriteAheadLog::append(Op op, int id, const string& value) {
+    unique_lock<mutex> lock(lock_);
+    throwIfFailed();
+    
+    uint64_t sequence = nextSequence++;
+    uint32_t length = static_cast<uint32_t>(BODY_FIXED + value.size());
+    size_t start = pending.size();
+    pending.resize(start + RECORD_PREFIX + length);
+    char* out = &pending[start];
+    char* body = out + RECORD_PREFIX;
+    int32_t id32 = id;
+    memcpy(body, &sequence, sizeof(sequence));
+    body[sizeof(uint64_t)] = static_cast<char>(op);
+    memcpy(body + sizeof(uint64_t) + 1, &id32, sizeof(id32));
+    memcpy(body + BODY_FIXED, value.data(), value.size());
+    uint32_t prefix[2] = {length, crc32(body, length)};
+    memcpy(out, prefix, RECORD_PREFIX);
+    
+    appendedSequence = sequence;
+    appends++;
+    
+    if (options.syncIntervalMs <= 0) {
+        flushLocked(lock);  // No batching: every append is its own commit
+        throwIfFailed();
+    } else if (pending.size() >= options.maxPendingBytes) {
+        wakeFlusher.notify_one();
+    }
+    return sequence;
+}
+
+void WriteAheadLog::sync() {
+    unique_lock<mutex> lock(lock_);
+    if (!flusher.joinable()) {
+        flushLocked(lock);
+    } else {
+        uint64_t target = appendedSequence;
+        syncRequested = true;
+        wakeFlusher.notify_one();
+        flushed.wait(lock, [&]() { return durableSequence >= target || !error.empty(); });
+    }
+    throwIfFailed();
+}
+
+void WriteAheadLog::reset() {
+    unique_lock<mutex> lock(lock_);
+    flushed.wait(lock, [&]() { return !flushing; });
+    throwIfFailed();
+    
+    pending.clear();
+    durableSequence = appendedSequence;
+    if (!truncateFile(file, sizeof(WAL_MAGIC)) || fseek(file, 0, SEEK_END) != 0 || !syncFile(file)) {
+        error = "không cắt được file " + path;
+        throwIfFailed();
+    }
+    fileBytes = sizeof(WAL_MAGIC);
+}
+
+uint64_t WriteAheadLog::lastSequence() const {
+    lock_guard<mutex> lock(lock_);
+    return appendedSequence;
+}
+
+WriteAheadLog::Stats WriteAheadLog::stats() const {
+    lock_guard<mutex> lock(lock_);
+    return Stats{appends, syncs, fileBytes + pending.size()};
+}
+
+void WriteAheadLog::flusherLoop() {
+    unique_lock<mutex> lock(lock_);
+    while (!stopping) {
+        wakeFlusher.wait_for(lock, chrono::milliseconds(options.syncIntervalMs), [&]() {
+            return stopping || syncRequested || pending.size() >= options.maxPendingBytes;
+        });
+        flushLocked(lock);
+    }
+    flushLocked(lock);
+}
+
+// Writes the current batch outside the lock so appends keep queueing into a
+// fresh batch while the fsync is in flight. Only one flush runs at a time.
+void WriteAheadLog::flushLocked(unique_lock<mutex>& lock) {
+    flushed.wait(lock, [&]() { return !flushing; });
+    syncRequested = false;
+    if (pending.empty() || !error.empty()) {
+        flushed.notify_all();
+        return;
+    }
+    
+    string batch;
+    batch.swap(pending);
+    uint64_t sequence = appendedSequence;
+    flushing = true;
+    lock.unlock();
+    
+    bool ok = fwrite(batch.data(), 1, batch.size(), file) == batch.size() && syncFile(file);
+    
+    lock.lock();
+    flushing = false;
+    if (ok) {
+        durableSequence = sequence;
+        fileBytes += batch.size();
+        syncs++;
+    } else if (error.empty()) {
+        error = "không ghi được file " + path;
+    }
+    flushed.notify_all();
+}
+
+void WriteAheadLog::throwIfFailed() const {
+    if (!error.empty()) {
+        throw StorageError(error);
+    }
+}
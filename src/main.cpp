@@ -1,13 +1,68 @@
 #include "ContactUI.h"
 #include "ContactException.h"
+#include <fstream>
 #include <iostream>
+#include <string>
 
 using namespace std;
 
-int main() {
+// --memory: chỉ làm việc trong bộ nhớ, không nạp và không lưu gì
+static const char* const USAGE = "Cách dùng: SmartContactCLI [file snapshot | --memory] [--batch [file lệnh | -]]";
+
+int main(int argc, char* argv[]) {
     try {
-        ContactUI app;
-        app.run();
+        // Tham số không bắt đầu bằng "--" (nhiều nhất một) là file snapshot của danh bạ
+        string dataFile = "contacts.snapshot";
+        bool dataFileGiven = false;
+        bool memoryOnly = false;
+        bool batch = false;
+        string commandFile = "-";
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--batch") {
+                batch = true;
+                if (i + 1 < argc && string(argv[i + 1]).compare(0, 2, "--") != 0) {
+                    commandFile = argv[++i];
+                }
+            } else if (arg == "--memory") {
+                memoryOnly = true;
+            } else if (arg.compare(0, 2, "--") == 0) {
+                cerr << " Lỗi: tùy chọn không hợp lệ " << arg << "\n" << USAGE << endl;
+                return 2;
+            } else if (dataFileGiven) {
+                cerr << " Lỗi: thừa tham số " << arg << "\n" << USAGE << endl;
+                return 2;
+            } else {
+                dataFile = arg;
+                dataFileGiven = true;
+            }
+        }
+        if (memoryOnly && dataFileGiven) {
+            cerr << " Lỗi: --memory không dùng cùng file snapshot\n" << USAGE << endl;
+            return 2;
+        }
+        if (memoryOnly) {
+            dataFile.clear();
+        }
+    
+        ContactUI app(dataFile);
+        if (!batch) {
+            app.run();
+            return 0;
+        }
+    
+        // 📜 Chế độ batch: cin/cout không đồng bộ với stdio nên được đệm trọn khối
+        ios::sync_with_stdio(false);
+        if (commandFile == "-") {
+            return app.runBatch(cin) ? 0 : 1;
+        }
+    
+        ifstream commands(commandFile);
+        if (!commands) {
+            cerr << " Lỗi: không mở được file lệnh " << commandFile << endl;
+            return 1;
+        }
+        return app.runBatch(commands) ? 0 : 1;
     } catch (const ContactException& e) {
         cout << " Lỗi hệ thống: " << e.what() << endl;
         cout << "Vui lòng thử lại hoặc liên hệ hỗ trợ." << endl;